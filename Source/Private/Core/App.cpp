@@ -24,12 +24,24 @@ namespace aby {
     fs::path App::cache() {
         return bin() / "Cache";
     }
+
+    static Unique<util::Archive> mount_archive(const fs::path& path) {
+        if (!fs::exists(path)) return nullptr;
+        auto archive = create_unique<util::Archive>(path);
+        if (!*archive) {
+            ABY_ERR("{}", archive->error());
+            return nullptr;
+        }
+        ABY_LOG("Mounted archive: {} ({} entries)", path, archive->entries().size());
+        return archive;
+    }
 }
 
 namespace aby {
 
     App::App(const AppInfo& app_info, const WindowInfo& window_info) :
         m_Info(app_info),
+        m_Archive(mount_archive(bin() / util::ARCHIVE_NAME)),
         m_Window(Window::create(WindowInfo{
             .size = window_info.size,
             .flags = window_info.flags,
@@ -67,7 +79,7 @@ namespace aby {
     void App::run() {
         {
             PROFILE_SCOPE("Initialization");
-            m_Ctx->load_thread().sync();
+            m_Ctx->load_pool().sync();
             
             auto object_cache = cache() / "Objects";
             for (auto& obj : m_Objects) {
@@ -107,9 +119,13 @@ namespace aby {
             m_Ctx->imgui_end_frame();
             m_Renderer->on_end();
 
-            for (auto& [handle, tex] : m_Ctx->textures())
-                if (tex->dirty())
-                    tex->sync();
+            m_Ctx->load_pool().poll();
+
+            m_Ctx->streamer().update();
+
+            m_Ctx->sync_textures();
+
+            m_Ctx->residency().update();
 
             Logger::flush();
 
@@ -144,6 +160,10 @@ namespace aby {
         return m_Info.version;
     }
 
+    const util::Archive* App::archive() const {
+        return m_Archive.get();
+    }
+
     Window* App::window() {
         return m_Window.get();
     }
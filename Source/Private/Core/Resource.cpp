@@ -18,6 +18,14 @@ namespace aby {
         return m_Handle;
     }
 
+    Resource::Handle Resource::index() const {
+        return index_of(m_Handle);
+    }
+
+    Resource::Handle Resource::generation() const {
+        return generation_of(m_Handle);
+    }
+
     Resource::operator bool() const {
         return (m_Type != EResource::NONE);
     }
@@ -0,0 +1,89 @@
+#include "Core/ResourceStats.h"
+#include <algorithm>
+#include <format>
+#include <limits>
+
+namespace aby {
+
+    LoadStats::LoadStats() :
+        m_Count(0),
+        m_DecodeMs(0.f),
+        m_UploadMs(0.f),
+        m_MaxMs(0.f),
+        m_Histogram{}
+    {
+
+    }
+
+    void LoadStats::record(float decode_ms, float upload_ms) {
+        float total = decode_ms + upload_ms;
+        m_Count++;
+        m_DecodeMs += decode_ms;
+        m_UploadMs += upload_ms;
+        m_MaxMs     = std::max(m_MaxMs, total);
+
+        std::size_t bucket = 0;
+        while (bucket < BUCKETS - 1 && total >= bucket_limit(bucket)) {
+            bucket++;
+        }
+        m_Histogram[bucket]++;
+    }
+
+    void LoadStats::reset() {
+        *this = LoadStats();
+    }
+
+    u64 LoadStats::count() const {
+        return m_Count;
+    }
+
+    float LoadStats::decode_ms() const {
+        return m_DecodeMs;
+    }
+
+    float LoadStats::upload_ms() const {
+        return m_UploadMs;
+    }
+
+    float LoadStats::total_ms() const {
+        return m_DecodeMs + m_UploadMs;
+    }
+
+    float LoadStats::max_ms() const {
+        return m_MaxMs;
+    }
+
+    const std::array<u64, LoadStats::BUCKETS>& LoadStats::histogram() const {
+        return m_Histogram;
+    }
+
+    float LoadStats::bucket_limit(std::size_t bucket) {
+        if (bucket >= BUCKETS - 1) {
+            return std::numeric_limits<float>::infinity();
+        }
+        return static_cast<float>(1u << bucket);
+    }
+
+    std::string ResourceStats::to_json() const {
+        std::string histogram;
+        for (std::size_t i = 0; i < LoadStats::BUCKETS; i++) {
+            histogram += std::format("{}{}", i ? ", " : "", loads.histogram()[i]);
+        }
+        return std::format(
+            "{{ \"name\": \"{}\", \"count\": {}, \"pending\": {}, \"cpu_bytes\": {}, \"device_bytes\": {}, "
+            "\"loads\": {{ \"count\": {}, \"decode_ms\": {:.3f}, \"upload_ms\": {:.3f}, \"max_ms\": {:.3f}, \"histogram\": [{}] }} }}",
+            name, count, pending, cpu_bytes, device_bytes,
+            loads.count(), loads.decode_ms(), loads.upload_ms(), loads.max_ms(), histogram
+        );
+    }
+
+    std::string to_json(std::span<const ResourceStats> stats) {
+        std::string json = "[\n";
+        for (std::size_t i = 0; i < stats.size(); i++) {
+            json += std::format("    {}{}\n", stats[i].to_json(), i + 1 < stats.size() ? "," : "");
+        }
+        json += "]\n";
+        return json;
+    }
+
+}
@@ -46,7 +46,8 @@ namespace aby::editor {
 
 	EditorUI::EditorUI(App* app) :
 		m_App(app),
-		m_Console("Console", false)
+		m_Console("Console", false),
+		m_Resources("Resources", false)
 	{
 
 	}
@@ -66,6 +67,9 @@ namespace aby::editor {
 		bool open_console = true;
 		m_Console.draw(&open_console);
 
+		bool open_resources = true;
+		m_Resources.draw(&app->ctx(), &open_resources);
+
 		ImGui::End();
 
     }
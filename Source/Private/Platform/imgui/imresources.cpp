@@ -0,0 +1,151 @@
+#include "Platform/imgui/imresources.h"
+#include "Rendering/Context.h"
+#include "Core/App.h"
+#include "Core/Log.h"
+#include <array>
+#include <format>
+
+namespace aby::imgui {
+
+    static std::string format_bytes(u64 bytes) {
+        constexpr const char* units[] = { "B", "KiB", "MiB", "GiB" };
+        double      value = static_cast<double>(bytes);
+        std::size_t unit  = 0;
+        while (value >= 1024.0 && unit + 1 < std::size(units)) {
+            value /= 1024.0;
+            unit++;
+        }
+        return unit == 0 ? std::format("{} {}", bytes, units[unit]) : std::format("{:.2f} {}", value, units[unit]);
+    }
+
+    ResourceMonitor::ResourceMonitor(const std::string& title, bool is_child_window) :
+        m_Title(title),
+        m_Stats{},
+        bChildWindow(is_child_window)
+    {
+
+    }
+
+    void ResourceMonitor::draw(Context* ctx, bool* p_open) {
+        ImGui::SetNextWindowSize(ImVec2(520, 400), ImGuiCond_FirstUseEver);
+        if (bChildWindow) {
+            if (!ImGui::BeginChild(m_Title.c_str())) {
+                ImGui::EndChild();
+                return;
+            }
+        }
+        else {
+            if (!ImGui::Begin(m_Title.c_str(), p_open)) {
+                ImGui::End();
+                return;
+            }
+        }
+
+        m_Stats = ctx->resource_stats();
+        draw_options(ctx);
+        ImGui::Separator();
+        draw_table();
+        draw_loads();
+        draw_residency(ctx);
+
+        if (bChildWindow) {
+            ImGui::EndChild();
+        }
+        else {
+            ImGui::End();
+        }
+    }
+
+    void ResourceMonitor::draw_options(Context* ctx) {
+        if (ImGui::Button("Export JSON")) {
+            fs::path file = ctx->app()->cache() / "Stats" / "Resources.json";
+            if (auto err = ctx->export_resource_stats(file); err.empty()) {
+                ABY_LOG("Exported resource stats: {}", file);
+            }
+            else {
+                ABY_ERR("{}", err);
+            }
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Reset Load Times")) {
+            ctx->textures().load_stats().reset();
+            ctx->fonts().load_stats().reset();
+            ctx->shaders().load_stats().reset();
+        }
+    }
+
+    void ResourceMonitor::draw_table() {
+        constexpr ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp;
+        if (!ImGui::BeginTable("##ResourceStats", 8, flags)) return;
+
+        ImGui::TableSetupColumn("Class");
+        ImGui::TableSetupColumn("Count");
+        ImGui::TableSetupColumn("Pending");
+        ImGui::TableSetupColumn("CPU");
+        ImGui::TableSetupColumn("Device");
+        ImGui::TableSetupColumn("Loads");
+        ImGui::TableSetupColumn("Decode");
+        ImGui::TableSetupColumn("Upload");
+        ImGui::TableHeadersRow();
+
+        for (const auto& stats : m_Stats) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(stats.name.c_str());
+            ImGui::TableNextColumn(); ImGui::Text("%zu", stats.count);
+            ImGui::TableNextColumn(); ImGui::Text("%zu", stats.pending);
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(format_bytes(stats.cpu_bytes).c_str());
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(format_bytes(stats.device_bytes).c_str());
+            ImGui::TableNextColumn(); ImGui::Text("%llu", static_cast<unsigned long long>(stats.loads.count()));
+            ImGui::TableNextColumn(); ImGui::Text("%.2fms", stats.loads.decode_ms());
+            ImGui::TableNextColumn(); ImGui::Text("%.2fms", stats.loads.upload_ms());
+        }
+        ImGui::EndTable();
+    }
+
+    void ResourceMonitor::draw_loads() {
+        for (const auto& stats : m_Stats) {
+            if (stats.loads.count() == 0) continue;
+            if (!ImGui::TreeNode(stats.name.c_str(), "%s load times", stats.name.c_str())) continue;
+
+            const auto& loads = stats.loads;
+            float total = loads.total_ms();
+            float split = total > 0.f ? loads.decode_ms() / total : 0.f;
+            ImGui::Text("Max: %.2fms  Avg: %.2fms", loads.max_ms(), total / loads.count());
+            ImGui::ProgressBar(split, ImVec2(-1, 0), std::format("Decode {:.0f}% / Upload {:.0f}%", split * 100.f, (1.f - split) * 100.f).c_str());
+
+            std::array<float, LoadStats::BUCKETS> histogram;
+            float peak = 0.f;
+            for (std::size_t i = 0; i < LoadStats::BUCKETS; i++) {
+                histogram[i] = static_cast<float>(loads.histogram()[i]);
+                peak         = std::max(peak, histogram[i]);
+            }
+            ImGui::PlotHistogram("##Histogram", histogram.data(), static_cast<int>(histogram.size()), 0, nullptr, 0.f, peak, ImVec2(-1, 60));
+            if (ImGui::BeginItemTooltip()) {
+                for (std::size_t i = 0; i < LoadStats::BUCKETS; i++) {
+                    if (i + 1 < LoadStats::BUCKETS) {
+                        ImGui::Text("< %4.0fms: %llu", LoadStats::bucket_limit(i), static_cast<unsigned long long>(loads.histogram()[i]));
+                    }
+                    else {
+                        ImGui::Text(">= %3.0fms: %llu", LoadStats::bucket_limit(i - 1), static_cast<unsigned long long>(loads.histogram()[i]));
+                    }
+                }
+                ImGui::EndTooltip();
+            }
+            ImGui::TreePop();
+        }
+    }
+
+    void ResourceMonitor::draw_residency(Context* ctx) {
+        auto& residency = ctx->residency();
+        auto  bar = [](const char* label, u64 used, u64 budget) {
+            float fraction = budget ? static_cast<float>(static_cast<double>(used) / budget) : 0.f;
+            ImGui::TextUnformatted(label);
+            ImGui::SameLine();
+            ImGui::ProgressBar(fraction, ImVec2(-1, 0), std::format("{} / {}", format_bytes(used), format_bytes(budget)).c_str());
+        };
+        ImGui::SeparatorText("Texture Residency");
+        bar("CPU", residency.cpu_bytes(), residency.cpu_budget());
+        bar("GPU", residency.gpu_bytes(), residency.gpu_budget());
+    }
+
+}
@@ -85,6 +85,14 @@ namespace aby::vk {
         unmap(mapped);
     }
 
+    void Buffer::write(const void* data, std::size_t bytes, std::size_t offset) {
+        ABY_ASSERT(offset + bytes <= m_Size, "Buffer::write out of range ({} + {} > {})", offset, bytes, m_Size);
+        if (bytes == 0) return;
+        void* mapped = map(bytes, offset);
+        std::memcpy(mapped, data, bytes);
+        unmap(mapped);
+    }
+
     void Buffer::destroy() {
         if (m_Buffer) {
             vkDestroyBuffer(m_Logical, m_Buffer, IAllocator::get());
@@ -429,4 +437,60 @@ namespace aby::vk {
 
 }
 
+namespace aby::vk {
+
+    StagingBuffer::StagingBuffer(std::size_t bytes, DeviceManager& manager) :
+        Buffer(bytes, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, manager),
+        m_Mapped(static_cast<std::byte*>(map(bytes, 0)))
+    {
+
+    }
+
+    StagingBuffer::~StagingBuffer() {
+        // Freeing the memory implicitly unmaps it.
+        destroy();
+    }
+
+    std::span<std::byte> StagingBuffer::span() {
+        return { m_Mapped, m_Size };
+    }
+
+    std::span<const std::byte> StagingBuffer::span() const {
+        return { m_Mapped, m_Size };
+    }
+
+    DynamicVertexBuffer::DynamicVertexBuffer(const VertexClass& vertex_class, u32 slots, DeviceManager& manager) :
+        Buffer(vertex_class.max_vertices() * vertex_class.vertex_size() * slots, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, manager),
+        m_Mapped(static_cast<std::byte*>(map(m_Size, 0))),
+        m_SlotBytes(vertex_class.max_vertices() * vertex_class.vertex_size()),
+        m_Slots(slots),
+        m_Slot(0)
+    {
+        ABY_ASSERT(slots > 0, "A dynamic vertex buffer needs at least one slot");
+    }
+
+    DynamicVertexBuffer::~DynamicVertexBuffer() {
+        // Freeing the memory implicitly unmaps it.
+        destroy();
+    }
+
+    void DynamicVertexBuffer::set_slot(u32 slot) {
+        ABY_ASSERT(slot < m_Slots, "Slot out of range", slot, m_Slots);
+        m_Slot = slot;
+    }
 
+    void DynamicVertexBuffer::bind(VkCommandBuffer cmd) {
+        VkDeviceSize offset = m_SlotBytes * m_Slot;
+        vkCmdBindVertexBuffers(cmd, 0, 1, &m_Buffer, &offset);
+    }
+
+    std::span<std::byte> DynamicVertexBuffer::region(u32 slot) {
+        ABY_ASSERT(slot < m_Slots, "Slot out of range", slot, m_Slots);
+        return { m_Mapped + m_SlotBytes * slot, m_SlotBytes };
+    }
+
+    u32 DynamicVertexBuffer::slots() const {
+        return m_Slots;
+    }
+
+}
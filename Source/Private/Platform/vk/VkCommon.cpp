@@ -170,7 +170,7 @@ namespace aby::vk::helper {
             .subresourceRange = {
                 .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,        // Affects the color aspect of the image
                 .baseMipLevel = 0,                                // Start at mip level 0
-                .levelCount = 1,                                // Number of mip levels affected
+                .levelCount = VK_REMAINING_MIP_LEVELS,          // Every mip level of the image
                 .baseArrayLayer = 0,                                // Start at array layer 0
                 .layerCount = 1                                 // Number of array layers affected
             } };
@@ -211,7 +211,8 @@ namespace aby::vk::helper {
         VkFormat format, VkImageTiling tiling, 
         VkImageUsageFlags usage, VkMemoryPropertyFlags properties, 
         VkImage& image, VkDeviceMemory& imageMemory, 
-        VkDevice device, VkPhysicalDevice physicalDevice) -> void
+        VkDevice device, VkPhysicalDevice physicalDevice,
+        uint32_t mipLevels) -> void
     {
         // Step 1: Create the Vulkan Image
         VkImageCreateInfo imageCreateInfo = {};
@@ -220,7 +221,7 @@ namespace aby::vk::helper {
         imageCreateInfo.extent.width = width;
         imageCreateInfo.extent.height = height;
         imageCreateInfo.extent.depth = 1;
-        imageCreateInfo.mipLevels = 1;
+        imageCreateInfo.mipLevels = mipLevels;
         imageCreateInfo.arrayLayers = 1;
         imageCreateInfo.format = format;
         imageCreateInfo.tiling = tiling;
@@ -249,9 +250,9 @@ namespace aby::vk::helper {
         vkBindImageMemory(device, image, imageMemory, 0);
     }
 
-    auto copy_buffer_to_img(VkCommandBuffer cmd, VkBuffer buffer, VkImage image, uint32_t width, uint32_t height) -> void {
+    auto copy_buffer_to_img(VkCommandBuffer cmd, VkBuffer buffer, VkImage image, uint32_t width, uint32_t height, VkDeviceSize offset) -> void {
         VkBufferImageCopy region{};
-        region.bufferOffset = 0;
+        region.bufferOffset = offset;
         region.bufferRowLength = 0; // Tightly packed
         region.bufferImageHeight = 0;
         region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
@@ -271,7 +272,18 @@ namespace aby::vk::helper {
         );
     }
 
-    auto create_img_view(VkDevice device, VkImage image, VkFormat format, VkImageView& view) -> void {
+    auto copy_buffer_to_img(VkCommandBuffer cmd, VkBuffer buffer, VkImage image, std::span<const VkBufferImageCopy> regions) -> void {
+        vkCmdCopyBufferToImage(
+            cmd,
+            buffer,
+            image,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            static_cast<uint32_t>(regions.size()),
+            regions.data()
+        );
+    }
+
+    auto create_img_view(VkDevice device, VkImage image, VkFormat format, VkImageView& view, uint32_t mipLevels) -> void {
         VkImageViewCreateInfo viewInfo{};
         viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
         viewInfo.image = image;
@@ -279,7 +291,7 @@ namespace aby::vk::helper {
         viewInfo.format = format;
         viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
         viewInfo.subresourceRange.baseMipLevel = 0;
-        viewInfo.subresourceRange.levelCount = 1;
+        viewInfo.subresourceRange.levelCount = mipLevels;
         viewInfo.subresourceRange.baseArrayLayer = 0;
         viewInfo.subresourceRange.layerCount = 1;
         VK_CHECK(vkCreateImageView(device, &viewInfo, IAllocator::get(), &view));
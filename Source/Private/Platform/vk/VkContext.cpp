@@ -59,6 +59,7 @@ namespace aby::vk {
         m_Debugger.create(m_Instance);
         m_Surface.create(m_Instance, window);
         m_Devices.create(m_Instance, m_Surface, device_extensions);
+        m_Uploads.create(m_Devices, app->info().upload_ring_bytes);
     }
 
     Ref<Context> Context::create(App* app, Window* window) {
@@ -70,7 +71,14 @@ namespace aby::vk {
         ImGui_ImplGlfw_Shutdown();
         ImGui::DestroyContext();
         m_Shaders.clear();
+        m_Streamer.clear();
+        m_Residency.clear();
         m_Textures.clear();
+        for (auto& retired : m_Retired) {
+            destroy(retired.image);
+        }
+        m_Retired.clear();
+        m_Uploads.destroy();
         m_Devices.destroy();
         m_Debugger.destroy();
         m_Surface.destroy();
@@ -203,6 +211,32 @@ namespace aby::vk {
         return m_Surface;
     }
 
+    UploadRing& Context::uploads() {
+        return m_Uploads;
+    }
+
+    void Context::retire(const RetiredImage& image) {
+        m_Retired.emplace_back(m_Submitted, image);
+    }
+
+    void Context::collect(u64 submitted, u64 completed) {
+        m_Submitted = submitted;
+        std::erase_if(m_Retired, [this, completed](const Retired& retired) {
+            if (retired.serial > completed) return false;
+            destroy(retired.image);
+            return true;
+        });
+    }
+
+    void Context::destroy(const RetiredImage& image) {
+        auto logical = m_Devices.logical();
+        if (image.set)     vkFreeDescriptorSets(logical, image.pool, 1, &image.set);
+        if (image.sampler) vkDestroySampler(logical, image.sampler, IAllocator::get());
+        if (image.view)    vkDestroyImageView(logical, image.view, IAllocator::get());
+        if (image.image)   vkDestroyImage(logical, image.image, IAllocator::get());
+        if (image.memory)  vkFreeMemory(logical, image.memory, IAllocator::get());
+    }
+
     void Context::set_dbg_obj_name(VkImage image, const char* name) {
         helper::set_debug_name(m_Devices.logical(), image, name);
     }
@@ -10,7 +10,8 @@ namespace aby::vk {
         m_Physical(VK_NULL_HANDLE),
         m_Logical(VK_NULL_HANDLE),
         m_Graphics{},
-        m_MaxTextureSlots(0)
+        m_MaxTextureSlots(0),
+        m_TextureCompressionBC(false)
     {
 
     }
@@ -19,7 +20,8 @@ namespace aby::vk {
         m_Physical(VK_NULL_HANDLE),
         m_Logical(VK_NULL_HANDLE),
         m_Graphics{},
-        m_MaxTextureSlots(0)
+        m_MaxTextureSlots(0),
+        m_TextureCompressionBC(false)
     {
         create(inst, surface, extensions);
     }
@@ -90,8 +92,12 @@ namespace aby::vk {
             .dynamicRendering = VK_TRUE
         }; 
     
+        // Optional, compressed textures fall back to cpu decoding without it.
+        m_TextureCompressionBC = query_device_features2.features.textureCompressionBC == VK_TRUE;
+
         VkPhysicalDeviceFeatures base_features{
-            .samplerAnisotropy = VK_TRUE,
+            .samplerAnisotropy    = VK_TRUE,
+            .textureCompressionBC = m_TextureCompressionBC ? VK_TRUE : VK_FALSE,
         };
 
         VkPhysicalDeviceFeatures2 enable_device_features2{
@@ -157,6 +163,10 @@ namespace aby::vk {
         return m_MaxTextureSlots;
     }
 
+    bool DeviceManager::texture_compression_bc() const {
+        return m_TextureCompressionBC;
+    }
+
 
     Ref<CmdPool> DeviceManager::create_cmd_pool() {
         return create_ref<CmdPool>(m_Logical, m_Graphics.FamilyIdx);
@@ -12,16 +12,16 @@ namespace aby::vk {
 	{
 	}
 
-	Pipeline::Pipeline(Window* window, DeviceManager& manager, Ref<ShaderModule> shaders, Swapchain& swapchain) : 
+	Pipeline::Pipeline(Window* window, DeviceManager& manager, Ref<ShaderModule> shaders, Swapchain& swapchain, VkVertexInputRate input_rate) : 
 		m_Device(VK_NULL_HANDLE),
 		m_Shaders(nullptr),
 		m_Pipeline(VK_NULL_HANDLE),
 		m_ColorAttachment(swapchain.format())
 	{
-		create(window, manager, shaders, swapchain);
+		create(window, manager, shaders, swapchain, input_rate);
 	}
 
-	void Pipeline::create(Window* window, DeviceManager& manager, Ref<ShaderModule> shaders, Swapchain& swapchain) {
+	void Pipeline::create(Window* window, DeviceManager& manager, Ref<ShaderModule> shaders, Swapchain& swapchain, VkVertexInputRate input_rate) {
 		m_Device   = manager.logical();
 		m_Shaders  = shaders;
 		m_Pipeline = VK_NULL_HANDLE;
@@ -39,7 +39,7 @@ namespace aby::vk {
 			VkVertexInputBindingDescription ibd = {
 				.binding   = static_cast<u32>(binding),
 				.stride    = static_cast<u32>(stride),
-				.inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
+				.inputRate = input_rate,
 			};
 			ibds.push_back(ibd);
 		}
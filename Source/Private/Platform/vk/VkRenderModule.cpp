@@ -10,96 +10,178 @@
 
 namespace aby::vk {
 
-    RenderPrimitive::RenderPrimitive(Ref<vk::Context> ctx, const ShaderDescriptor& vertex_descriptor, const PrimitiveDescriptor& primitive_descriptor) :
+    template <typename T>
+    RenderPrimitive<T>::Batch::Batch(const VertexClass& vertex_class, u32 slot, DeviceManager& manager) :
+        buffer(vertex_class, static_cast<u32>(MAX_FRAMES_IN_FLIGHT), manager),
+        vertices(buffer.region(slot)),
+        index_count(0)
+    {
+
+    }
+
+    template <typename T>
+    RenderPrimitive<T>::RenderPrimitive(Ref<vk::Context> ctx, const ShaderDescriptor& vertex_descriptor, const PrimitiveDescriptor& primitive_descriptor) :
+        m_Ctx(ctx.get()),
         m_VertexClass(vertex_descriptor, primitive_descriptor.MaxVertices, 0),
-        m_VertexAccumulator(m_VertexClass),
-        m_VertexBuffer(m_VertexClass, ctx->devices()),
+        m_Batches{},
+        m_Batch(0),
+        m_Slot(0),
         m_IndexBuffer(primitive_descriptor.MaxIndices * sizeof(u32), ctx->devices()),
-        m_Descriptor(primitive_descriptor),
-        m_IndexCount(0)
+        m_Descriptor(primitive_descriptor)
     {
-       
+        // Checked once when the renderer starts, the writes themselves rely on it.
+        if (!TypedVertexAccumulator<T>::matches(vertex_descriptor)) {
+            throw std::invalid_argument(std::format("{} ({} bytes) does not match the shader's vertex layout ({} bytes)", typeid(T).name(), sizeof(T), m_VertexClass.vertex_size()));
+        }
+        m_Batches.push_back(create_unique<Batch>(m_VertexClass, m_Slot, ctx->devices()));
     }
 
-
-
-    void RenderPrimitive::destroy() {
-        m_VertexBuffer.destroy();
-        if (m_Descriptor.IndicesPer != m_Descriptor.VerticesPer) {
-            m_IndexBuffer.destroy();
+    template <typename T>
+    void RenderPrimitive<T>::destroy() {
+        for (auto& batch : m_Batches) {
+            batch->buffer.destroy();
         }
+        m_IndexBuffer.destroy();
     }
 
-    const vk::PrimitiveDescriptor& RenderPrimitive::descriptor() const {
+    template <typename T>
+    const vk::PrimitiveDescriptor& RenderPrimitive<T>::descriptor() const {
         return m_Descriptor;
     }
-    std::size_t RenderPrimitive::index_count() const {
-        return m_IndexCount;
+
+    template <typename T>
+    std::size_t RenderPrimitive<T>::index_count() const {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i <= m_Batch; i++) {
+            count += m_Batches[i]->index_count;
+        }
+        return count;
     }
 
-    std::size_t RenderPrimitive::vertex_count() const {
-        return m_VertexAccumulator.count();
+    template <typename T>
+    std::size_t RenderPrimitive<T>::vertex_count() const {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i <= m_Batch; i++) {
+            count += m_Batches[i]->vertices.count();
+        }
+        return count;
     }
 
-    void RenderPrimitive::set_index_data(const u32* indices, DeviceManager& manager) {
+    template <typename T>
+    std::size_t RenderPrimitive<T>::batches() const {
+        return empty() ? 0 : m_Batch + 1;
+    }
+
+    template <typename T>
+    void RenderPrimitive<T>::set_index_data(const u32* indices, DeviceManager& manager) {
         ABY_ASSERT(m_Descriptor.IndicesPer != m_Descriptor.VerticesPer, "No index buffer will be used to draw this primitive");
         m_IndexBuffer.set_data(indices, sizeof(u32) * m_Descriptor.MaxIndices, manager);
     }
 
-    bool RenderPrimitive::empty() const {
-        return this->vertex_count() == 0;
+    template <typename T>
+    bool RenderPrimitive<T>::empty() const {
+        return m_Batch == 0 && m_Batches[0]->vertices.count() == 0;
     }
 
-    bool RenderPrimitive::should_flush() const {
-        bool flush = m_VertexAccumulator.count() + m_Descriptor.VerticesPer >= m_VertexAccumulator.capacity();
-        return flush;
+    template <typename T>
+    void RenderPrimitive<T>::flush(VkCommandBuffer cmd) {
+        for (u32 i = 0; i <= m_Batch; i++) {
+            u32 count = batch_size(i);
+            if (count == 0) continue;
+            bind(cmd, i);
+            draw(cmd, 0, count);
+        }
     }
 
-    bool RenderPrimitive::should_flush(std::size_t requested_primitives) const {
-        bool flush = m_VertexAccumulator.count() + (m_Descriptor.VerticesPer * requested_primitives) >= m_VertexAccumulator.capacity();
-        return flush;
+    template <typename T>
+    PrimitivePosition RenderPrimitive<T>::position() const {
+        return { static_cast<u32>(m_Batch), static_cast<u32>(m_Batches[m_Batch]->vertices.count()) };
     }
 
+    template <typename T>
+    u32 RenderPrimitive<T>::batch_size(u32 batch) const {
+        return batch <= m_Batch ? static_cast<u32>(m_Batches[batch]->vertices.count()) : 0;
+    }
 
-    void RenderPrimitive::bind(VkCommandBuffer cmd, DeviceManager& manager) {
-        m_VertexBuffer.set_data(m_VertexAccumulator.data(), m_VertexAccumulator.bytes(), manager);
-        m_VertexBuffer.bind(cmd);
-        if (m_Descriptor.IndicesPer != m_Descriptor.VerticesPer) {
+    template <typename T>
+    void RenderPrimitive<T>::bind(VkCommandBuffer cmd, u32 batch) {
+        ABY_ASSERT(batch <= m_Batch, "Batch was not written this frame", batch, m_Batch);
+        // The vertices already live in the slot's region of the buffer (host coherent), nothing to upload.
+        m_Batches[batch]->buffer.bind(cmd);
+        if (m_Descriptor.VerticesPerInstance == 0 && m_Descriptor.IndicesPer != m_Descriptor.VerticesPer) {
             m_IndexBuffer.bind(cmd);
         }
     }
-    
-    void RenderPrimitive::draw(VkCommandBuffer cmd) {
-        if (m_Descriptor.IndicesPer == m_Descriptor.VerticesPer) {
-            draw_nonindexed(cmd);
+
+    template <typename T>
+    void RenderPrimitive<T>::draw(VkCommandBuffer cmd, u32 first, u32 count) const {
+        if (m_Descriptor.VerticesPerInstance != 0) {
+            vkCmdDraw(cmd, m_Descriptor.VerticesPerInstance, count, 0u, first);
+        }
+        else if (m_Descriptor.IndicesPer != m_Descriptor.VerticesPer) {
+            // Every batch starts at vertex 0, so they all share the index pattern of the first one.
+            u32 first_index = first / m_Descriptor.VerticesPer * m_Descriptor.IndicesPer;
+            u32 index_count = count / m_Descriptor.VerticesPer * m_Descriptor.IndicesPer;
+            vkCmdDrawIndexed(cmd, index_count, 1u, first_index, 0, 0u);
         }
         else {
-            draw_indexed(cmd);
+            vkCmdDraw(cmd, count, 1u, first, 0u);
         }
     }
 
+    template <typename T>
+    void RenderPrimitive<T>::reset(u32 slot) {
+        m_Slot  = slot;
+        m_Batch = 0;
+        begin(*m_Batches[0]);
+    }
 
-    void RenderPrimitive::draw_indexed(VkCommandBuffer cmd) {
-        vkCmdDrawIndexed(cmd, static_cast<u32>(m_IndexCount), 1u, 0u, 0u, 0u);
+    template <typename T>
+    void RenderPrimitive<T>::next_batch() {
+        m_Batch++;
+        if (m_Batch == m_Batches.size()) {
+            m_Batches.push_back(create_unique<Batch>(m_VertexClass, m_Slot, m_Ctx->devices()));
+        }
+        begin(*m_Batches[m_Batch]);
     }
 
-    void RenderPrimitive::draw_nonindexed(VkCommandBuffer cmd) {
-        vkCmdDraw(cmd, static_cast<u32>(this->vertex_count()), 1u, 0u, 0u);
+    template <typename T>
+    void RenderPrimitive<T>::begin(Batch& batch) {
+        // Batches reused from an earlier frame still point at the slot they were last written in.
+        batch.buffer.set_slot(m_Slot);
+        batch.vertices.set_memory(batch.buffer.region(m_Slot));
+        batch.index_count = 0;
     }
 
-    void RenderPrimitive::reset() {
-        m_VertexAccumulator.reset();
-        m_IndexCount = 0;
+    template <typename T>
+    std::span<T> RenderPrimitive<T>::primitive() {
+        Batch& batch = *m_Batches[m_Batch];
+        std::span<T> vertices = batch.vertices.emplace_n(m_Descriptor.VerticesPer);
+        batch.index_count += m_Descriptor.IndicesPer;
+        // Primitives never straddle two batches.
+        if (batch.vertices.remaining() < m_Descriptor.VerticesPer) {
+            next_batch();
+        }
+        return vertices;
     }
 
-    RenderPrimitive& RenderPrimitive::operator++() {
-        ++m_VertexAccumulator;
-        if (m_VertexAccumulator.count() % m_Descriptor.VerticesPer == 0) {
-            m_IndexCount += m_Descriptor.IndicesPer;
+    template <typename T>
+    std::span<T> RenderPrimitive<T>::emplace_n(std::size_t count) {
+        ABY_ASSERT(count % m_Descriptor.VerticesPer == 0, "Only whole primitives can be emplaced", count, m_Descriptor.VerticesPer);
+        Batch& batch = *m_Batches[m_Batch];
+        std::size_t room = batch.vertices.remaining() - batch.vertices.remaining() % m_Descriptor.VerticesPer;
+        std::span<T> vertices = batch.vertices.emplace_n(std::min(count, room));
+        batch.index_count += vertices.size() / m_Descriptor.VerticesPer * m_Descriptor.IndicesPer;
+        if (batch.vertices.remaining() < m_Descriptor.VerticesPer) {
+            next_batch();
         }
-        return *this;
+        return vertices;
     }
 
+    template class RenderPrimitive<Vertex>;
+    template class RenderPrimitive<PackedVertex>;
+    template class RenderPrimitive<QuadInstance>;
+
 }
 
 
@@ -147,24 +229,38 @@ namespace aby::vk {
 
 
 
-    RenderModule::RenderModule(Ref<vk::Context> ctx, vk::Swapchain& swapchain, const std::vector<fs::path>& shaders) :
-        m_Ctx(ctx.get()),
-        m_Module(ShaderModule::create(ctx.get(), shaders[0], shaders[1])),
-        m_Pipeline(ctx->window(), ctx->devices(), m_Module, swapchain),
-        m_Primitives{
-            RenderPrimitive(ctx, m_Module->vertex_descriptor(), PrimitiveDescriptor{
+    template <typename V>
+    static RenderPrimitiveArray<V> make_primitives(Ref<vk::Context> ctx, const ShaderDescriptor& descriptor) {
+        return {
+            RenderPrimitive<V>(ctx, descriptor, PrimitiveDescriptor{
                 .MaxVertices = 10000,
                 .MaxIndices = 30000, 
                 .IndicesPer = 3,
                 .VerticesPer = 3
             }), // Triangles
-            RenderPrimitive(ctx, m_Module->vertex_descriptor(), PrimitiveDescriptor{
+            RenderPrimitive<V>(ctx, descriptor, PrimitiveDescriptor{
                 .MaxVertices = 10000 * 2,
                 .MaxIndices = 60000 * 2,
                 .IndicesPer = 6,
                 .VerticesPer = 4
             }) // Quads
+        };
+    }
+
+    static RenderPrimitives create_primitives(Ref<vk::Context> ctx, const ShaderDescriptor& descriptor) {
+        // PackedVertex only when every reflected input matches it exactly, anything else must be a Vertex
+        // layout, which RenderPrimitive validates.
+        if (TypedVertexAccumulator<PackedVertex>::matches(descriptor)) {
+            return RenderPrimitives(std::in_place_type<RenderPrimitiveArray<PackedVertex>>, make_primitives<PackedVertex>(ctx, descriptor));
         }
+        return RenderPrimitives(std::in_place_type<RenderPrimitiveArray<Vertex>>, make_primitives<Vertex>(ctx, descriptor));
+    }
+
+    RenderModule::RenderModule(Ref<vk::Context> ctx, vk::Swapchain& swapchain, const std::vector<fs::path>& shaders) :
+        m_Ctx(ctx.get()),
+        m_Module(ShaderModule::create(ctx.get(), shaders[0], shaders[1])),
+        m_Pipeline(ctx->window(), ctx->devices(), m_Module, swapchain),
+        m_Primitives(create_primitives(ctx, m_Module->vertex_descriptor()))
     {
         init();
     }
@@ -173,115 +269,137 @@ namespace aby::vk {
         m_Ctx(ctx.get()),
         m_Module(module),
         m_Pipeline(ctx->window(), ctx->devices(), m_Module, swapchain),
-        m_Primitives{
-            RenderPrimitive(ctx, m_Module->vertex_descriptor(), PrimitiveDescriptor{
-                .MaxVertices = 10000,
-                .MaxIndices = 30000,
-                .IndicesPer = 3,
-                .VerticesPer = 3
-            }), // Triangles
-            RenderPrimitive(ctx, m_Module->vertex_descriptor(), PrimitiveDescriptor{
-                .MaxVertices = 10000 * 2,
-                .MaxIndices = 60000 * 2,
-                .IndicesPer = 6,
-                .VerticesPer = 4
-            }) // Quads
-        }
+        m_Primitives(create_primitives(ctx, m_Module->vertex_descriptor()))
     {
         init();
     }
 
     void RenderModule::init() {
-        auto& quad_prim = this->quads();
-        auto& prim_desc = quad_prim.descriptor();
+        std::visit([&](auto& primitives) {
+            auto& quad_prim = primitives[static_cast<std::size_t>(ERenderPrimitive::QUAD)];
+            auto& prim_desc = quad_prim.descriptor();
 #ifdef NDEBUG
-        uint32_t* indices = new uint32_t[prim_desc.MaxIndices];
-        for (uint32_t i = 0, offset = 0; i < prim_desc.MaxIndices; i += prim_desc.IndicesPer, offset += prim_desc.VerticesPer) {
-            indices[i + 0] = offset + 0;
-            indices[i + 1] = offset + 1;
-            indices[i + 2] = offset + 2;
-            indices[i + 3] = offset + 2;
-            indices[i + 4] = offset + 3;
-            indices[i + 5] = offset + 0;
-        }
-        quad_prim.set_index_data(indices, m_Ctx->devices());
-        delete[] indices;
+            uint32_t* indices = new uint32_t[prim_desc.MaxIndices];
+            for (uint32_t i = 0, offset = 0; i < prim_desc.MaxIndices; i += prim_desc.IndicesPer, offset += prim_desc.VerticesPer) {
+                indices[i + 0] = offset + 0;
+                indices[i + 1] = offset + 1;
+                indices[i + 2] = offset + 2;
+                indices[i + 3] = offset + 2;
+                indices[i + 4] = offset + 3;
+                indices[i + 5] = offset + 0;
+            }
+            quad_prim.set_index_data(indices, m_Ctx->devices());
+            delete[] indices;
 #else
-        std::vector<uint32_t> indices(prim_desc.MaxIndices);
-        for (uint32_t i = 0, offset = 0; i < prim_desc.MaxIndices; i += prim_desc.IndicesPer, offset += prim_desc.VerticesPer) {
-            indices[i + 0] = offset + 0;
-            indices[i + 1] = offset + 1;
-            indices[i + 2] = offset + 2;
-            indices[i + 3] = offset + 2;
-            indices[i + 4] = offset + 3;
-            indices[i + 5] = offset + 0;
-        }
-        quad_prim.set_index_data(indices.data(), m_Ctx->devices());
+            std::vector<uint32_t> indices(prim_desc.MaxIndices);
+            for (uint32_t i = 0, offset = 0; i < prim_desc.MaxIndices; i += prim_desc.IndicesPer, offset += prim_desc.VerticesPer) {
+                indices[i + 0] = offset + 0;
+                indices[i + 1] = offset + 1;
+                indices[i + 2] = offset + 2;
+                indices[i + 3] = offset + 2;
+                indices[i + 4] = offset + 3;
+                indices[i + 5] = offset + 0;
+            }
+            quad_prim.set_index_data(indices.data(), m_Ctx->devices());
 #endif
+        }, m_Primitives);
     }
 
     void RenderModule::destroy() {
         m_Pipeline.destroy();
-        for (auto& prim : m_Primitives) {
-            prim.destroy();
-        }
+        std::visit([](auto& primitives) {
+            for (auto& prim : primitives) {
+                prim.destroy();
+            }
+        }, m_Primitives);
     }
 
-    void RenderModule::reset() {
-        for (auto& prim : m_Primitives) {
-            prim.reset();
-        }
+    void RenderModule::reset(u32 slot) {
+        std::visit([slot](auto& primitives) {
+            for (auto& prim : primitives) {
+                prim.reset(slot);
+            }
+        }, m_Primitives);
     }
     
-    void RenderModule::flush(VkCommandBuffer cmd, DeviceManager& manager, ERenderPrimitive primitive) {
-        if (primitive == ERenderPrimitive::ALL) {
-            for (auto& prim : m_Primitives) {
-                if (!prim.empty()) {
-                    prim.bind(cmd, manager);
-                    prim.draw(cmd);
+    void RenderModule::flush(VkCommandBuffer cmd, ERenderPrimitive primitive) {
+        std::visit([&](auto& primitives) {
+            if (primitive == ERenderPrimitive::ALL) {
+                for (auto& prim : primitives) {
+                    prim.flush(cmd);
                 }
             }
-        }
-        else {
-            auto& prim = m_Primitives[static_cast<std::size_t>(primitive)];
-            if (!prim.empty()) {
-                prim.bind(cmd, manager);
-                prim.draw(cmd);
+            else {
+                primitives[static_cast<std::size_t>(primitive)].flush(cmd);
             }
-        }
+        }, m_Primitives);
     }
 
     void RenderModule::set_uniforms(const void* data, std::size_t bytes, u32 binding) {
         m_Module->set_uniforms(data, bytes, binding);
     }
 
+    IRenderPrimitive& RenderModule::primitive(ERenderPrimitive primitive) {
+        return std::visit([primitive](auto& primitives) -> IRenderPrimitive& {
+            return primitives[static_cast<std::size_t>(primitive)];
+        }, m_Primitives);
+    }
+
+    template <typename F>
+    void RenderModule::write(ERenderPrimitive primitive, F&& vertex) {
+        std::visit([&](auto& primitives) {
+            auto vertices = primitives[static_cast<std::size_t>(primitive)].primitive();
+            for (std::size_t i = 0; i < vertices.size(); i++) {
+                // Converted to PackedVertex when the shader takes the packed layout.
+                vertices[i] = vertex(i);
+            }
+        }, m_Primitives);
+    }
+
     void RenderModule::draw_triangle(const Triangle& triangle) {
-        auto& acc = this->tris();
-        acc = triangle.v1;
-        ++acc;
-        acc = triangle.v2;
-        ++acc;
-        acc = triangle.v3;
-        ++acc;
+        m_Ctx->residency().touch(static_cast<u32>(triangle.v1.texinfo.z));
+        write(ERenderPrimitive::TRIANGLE, [&](std::size_t i) -> const Vertex& {
+            return i == 0 ? triangle.v1 : (i == 1 ? triangle.v2 : triangle.v3);
+        });
     }
-    
-    void RenderModule::draw_quad(const Quad& quad) {
-        auto& acc = this->quads();
 
+    void RenderModule::draw_triangles(std::span<const Triangle> triangles) {
+        static_assert(sizeof(Triangle) == 3 * sizeof(Vertex), "Triangles are copied as runs of vertices");
+        u32 texture = UINT32_MAX;
+        for (const auto& triangle : triangles) {
+            // Consecutive triangles usually share a texture.
+            if (u32 tex = static_cast<u32>(triangle.v1.texinfo.z); tex != texture) {
+                m_Ctx->residency().touch(tex);
+                texture = tex;
+            }
+        }
+        std::visit([&](auto& primitives) {
+            auto& tris = primitives[static_cast<std::size_t>(ERenderPrimitive::TRIANGLE)];
+            const Vertex* source = &triangles.data()->v1;
+            std::size_t   count  = triangles.size() * 3;
+            while (count > 0) {
+                auto vertices = tris.emplace_n(count);
+                std::copy(source, source + vertices.size(), vertices.begin());
+                source += vertices.size();
+                count  -= vertices.size();
+            }
+        }, m_Primitives);
+    }
+
+    void RenderModule::draw_quad(const Quad& quad) {
+        m_Ctx->residency().touch(static_cast<u32>(quad.texinfo.z));
         glm::mat4 transform = glm::translate(UNIT_MATRIX, quad.pos) * glm::scale(UNIT_MATRIX, quad.size);
 
-        for (std::size_t i = 0; i < std::size(VERTEX_POSITIONS); i++) {
+        write(ERenderPrimitive::QUAD, [&](std::size_t i) {
             glm::vec3 pos(transform * VERTEX_POSITIONS[i]);
-            glm::vec3 texinfo(COORDS[i], quad.texinfo.z);
-            Vertex v(pos, quad.col, texinfo);
-            acc = v;
-            ++acc;
-        }
+            // texinfo.xy and uvs select a sub-rect of the texture, e.g. an atlas region.
+            glm::vec3 texinfo(glm::vec2(quad.texinfo) + COORDS[i] * quad.uvs, quad.texinfo.z);
+            return Vertex(pos, quad.col, texinfo);
+        });
     }
 
     void RenderModule::draw_cube(const Quad& quad) {
-        auto& acc = this->quads();
-
+        m_Ctx->residency().touch(static_cast<u32>(quad.texinfo.z));
         glm::vec3 half_size = quad.size * 0.5f;
 
 
@@ -313,21 +431,21 @@ namespace aby::vk {
                 face_transform *= glm::rotate(UNIT_MATRIX, face.rotation_angle, face.rotation_axis);
             face_transform *= glm::scale(UNIT_MATRIX, { quad.size.x, quad.size.y, 1.0f });
 
-            for (std::size_t i = 0; i < std::size(VERTEX_POSITIONS); i++) {
+            write(ERenderPrimitive::QUAD, [&](std::size_t i) {
                 glm::vec3 pos(face_transform * VERTEX_POSITIONS[i]);
-                glm::vec3 texinfo(COORDS[i], quad.texinfo.z);
-                Vertex v(pos, quad.col, texinfo);
-                acc = v;
-                ++acc;
-            }
+                glm::vec3 texinfo(glm::vec2(quad.texinfo) + COORDS[i] * quad.uvs, quad.texinfo.z);
+                return Vertex(pos, quad.col, texinfo);
+            });
         }
     }
 
     void RenderModule::draw_text(const Text& text) {
         Ref<Font>    font_obj = m_Ctx->fonts().at({ EResource::FONT, text.font });
-        float        texture = static_cast<float>(font_obj->texture().handle());
-        Ref<Texture> tex_obj = m_Ctx->textures().at(font_obj->texture());
-        auto&        acc = this->quads();
+        if (!font_obj) return;
+        m_Ctx->residency().touch(font_obj->texture());
+        // Skip text until its font and glyph atlas have finished loading.
+        if (!m_Ctx->textures().ready(font_obj->texture())) return;
+        float        texture = static_cast<float>(font_obj->texture().index());
         const auto&  glyphs = font_obj->glyphs();
 
         glm::vec2   text_size        = font_obj->measure(text.text) * text.scale;
@@ -375,12 +493,11 @@ namespace aby::vk {
             }
             const auto& glyph = it->second;
             glm::mat4 transform = compute_text_transform(glyph, current_position, text.scale, text_size.y);
-            for (std::size_t i = 0; i < 4; i++) {
+            write(ERenderPrimitive::QUAD, [&](std::size_t i) {
                 glm::vec3 position(transform * VERTEX_POSITIONS[i]);
                 glm::vec3 texinfo(glyph.texcoords[i].x, glyph.texcoords[i].y, texture);
-                acc = Vertex(position, color, texinfo);
-                ++acc;
-            }
+                return Vertex(position, color, texinfo);
+            });
 
             for (auto& decor : text_decors) {
                 if (cursor >= decor.range.start && cursor <= decor.range.end) {
@@ -393,12 +510,11 @@ namespace aby::vk {
                             }
                             const auto& decor_glyph = decor_it->second;
                             glm::mat4 decor_transform = compute_text_transform(decor_glyph, { current_position.x, current_position.y }, text.scale, text_size.y);
-                            for (std::size_t i = 0; i < 4; i++) {
+                            write(ERenderPrimitive::QUAD, [&](std::size_t i) {
                                 glm::vec3 position(decor_transform * VERTEX_POSITIONS[i]);
                                 glm::vec3 texinfo(decor_glyph.texcoords[i].x, decor_glyph.texcoords[i].y, texture);
-                                acc = Vertex(position, color, texinfo);
-                                ++acc;
-                            }
+                                return Vertex(position, color, texinfo);
+                            });
                             break;
                         }
                         default:
@@ -412,15 +528,6 @@ namespace aby::vk {
         }
     }
 
-    RenderPrimitive& RenderModule::quads() {
-        std::size_t idx = static_cast<std::size_t>(ERenderPrimitive::QUAD);
-        return m_Primitives[idx];
-    }
-    RenderPrimitive& RenderModule::tris() {
-        std::size_t idx = static_cast<std::size_t>(ERenderPrimitive::TRIANGLE);
-        return m_Primitives[idx];
-    }
-
     Ref<ShaderModule> RenderModule::module() const {
         return m_Module;
     }
@@ -428,8 +535,73 @@ namespace aby::vk {
     vk::Pipeline& RenderModule::pipeline() {
         return m_Pipeline;
     }
-  
 
+}
 
+namespace aby::vk {
 
-}
\ No newline at end of file
+    InstancedQuadModule::InstancedQuadModule(Ref<vk::Context> ctx, vk::Swapchain& swapchain, const std::vector<fs::path>& shaders) :
+        m_Ctx(ctx.get()),
+        m_Module(ShaderModule::create(ctx.get(), shaders[0], shaders[1])),
+        m_Pipeline(ctx->window(), ctx->devices(), m_Module, swapchain, VK_VERTEX_INPUT_RATE_INSTANCE),
+        m_Instances(ctx, m_Module->vertex_descriptor(), PrimitiveDescriptor{
+            .MaxVertices = 16384,
+            .MaxIndices = 1, // Unused, instances are drawn without an index buffer.
+            .IndicesPer = 1,
+            .VerticesPer = 1,
+            .VerticesPerInstance = 6
+        })
+    {
+    }
+
+    void InstancedQuadModule::destroy() {
+        m_Pipeline.destroy();
+        m_Instances.destroy();
+    }
+
+    void InstancedQuadModule::reset(u32 slot) {
+        m_Instances.reset(slot);
+    }
+
+    void InstancedQuadModule::flush(VkCommandBuffer cmd) {
+        m_Instances.flush(cmd);
+    }
+
+    void InstancedQuadModule::set_uniforms(const void* data, std::size_t bytes, u32 binding) {
+        m_Module->set_uniforms(data, bytes, binding);
+    }
+
+    void InstancedQuadModule::draw_quad(const Quad& quad) {
+        m_Ctx->residency().touch(static_cast<u32>(quad.texinfo.z));
+        m_Instances.primitive()[0] = QuadInstance(quad);
+    }
+
+    void InstancedQuadModule::draw_quads(std::span<const Quad> quads) {
+        u32 texture = UINT32_MAX;
+        for (const auto& quad : quads) {
+            // Consecutive quads usually share a texture.
+            if (u32 tex = static_cast<u32>(quad.texinfo.z); tex != texture) {
+                m_Ctx->residency().touch(tex);
+                texture = tex;
+            }
+        }
+        while (!quads.empty()) {
+            std::span<QuadInstance> instances = m_Instances.emplace_n(quads.size());
+            pack_quads(quads.first(instances.size()), instances.data());
+            quads = quads.subspan(instances.size());
+        }
+    }
+
+    Ref<ShaderModule> InstancedQuadModule::module() const {
+        return m_Module;
+    }
+
+    vk::Pipeline& InstancedQuadModule::pipeline() {
+        return m_Pipeline;
+    }
+
+    RenderPrimitive<QuadInstance>& InstancedQuadModule::instances() {
+        return m_Instances;
+    }
+
+}
@@ -5,6 +5,7 @@
 #include "Core/Log.h"
 
 #include <numeric>
+#include <algorithm>
 
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtc/matrix_transform.hpp>
@@ -17,61 +18,127 @@
 
 namespace aby::vk {
 
+    // Pipeline each Renderer::EStream is drawn with, see Renderer::pipeline().
+    static constexpr u32 STREAM_PIPELINES[] = { 0, 1, 2, 2 };
+
     Renderer::Renderer(Ref<vk::Context> ctx) :
         m_Ctx(ctx),
         m_Frames{},
         m_Swapchain(ctx->surface(), ctx->devices(), ctx->window(), m_Frames),
         m_2D(ctx, m_Swapchain, { 
-            ctx->app()->bin() / "Shaders/Vertex.glsl",
+            ctx->app()->bin() / (ctx->app()->info().packed_vertices ? "Shaders/PackedVertex.glsl" : "Shaders/Vertex.glsl"),
             ctx->app()->bin() / "Shaders/Fragment.glsl" 
         }),
         m_3D(ctx, m_Swapchain, m_2D.module()),
+        m_Quads(ctx, m_Swapchain, {
+            ctx->app()->bin() / "Shaders/Quad.glsl",
+            ctx->app()->bin() / "Shaders/Fragment.glsl"
+        }),
         m_RecycledSemaphores{},
-        m_Img(0)
+        m_Img(0),
+        m_Slots{},
+        m_Slot(0),
+        m_ImgSerials{},
+        m_Submitted(0),
+        m_Retired(0),
+        m_Queue(std::vector<u32>(std::begin(STREAM_PIPELINES), std::end(STREAM_PIPELINES))),
+        m_Order{}
     {
+        static_assert(std::size(STREAM_PIPELINES) == static_cast<std::size_t>(EStream::MAX_ENUM));
         m_Ctx->window()->register_event(this, &Renderer::on_event);
+        // Texture 0 is sampled by untextured geometry and stands in for textures still loading.
         Resource default_tex = Texture::create(m_Ctx.get(), { 1, 1 }, { 1, 1, 1, 1 });
-        (void)default_tex;
+        m_Ctx->textures().set_placeholder(m_Ctx->textures().at(default_tex));
     }
     
+    template <typename F>
+    void Renderer::record(EStream stream, F&& write) {
+        IRenderPrimitive& primitive = this->stream(stream);
+        PrimitivePosition begin     = primitive.position();
+        write();
+        PrimitivePosition end       = primitive.position();
+        // Writes that fill a batch continue in the next one, each batch gets its own packet.
+        for (u32 batch = begin.batch; batch <= end.batch; batch++) {
+            u32 first = batch == begin.batch ? begin.vertex : 0;
+            u32 last  = batch == end.batch ? end.vertex : primitive.batch_size(batch);
+            if (last > first) {
+                m_Queue.push(m_Order, static_cast<u32>(stream), batch, first, last - first);
+            }
+        }
+    }
+
     void Renderer::draw_text(const Text& text) {
-        flush_if(m_2D, m_2D.quads().should_flush(text.text.length()), ERenderPrimitive::QUAD);
-        m_2D.draw_text(text);
+        record(EStream::QUADS, [&] { m_2D.draw_text(text); });
     }
    
     void Renderer::draw_triangle(const Triangle& triangle) {
-        flush_if(m_2D, m_2D.tris().should_flush(), ERenderPrimitive::TRIANGLE);
-        m_2D.draw_triangle(triangle);
+        record(EStream::TRIANGLES, [&] { m_2D.draw_triangle(triangle); });
     }
 
     void Renderer::draw_cube(const Quad& cube) {
-        flush_if(m_3D, m_3D.quads().should_flush(), ERenderPrimitive::QUAD);
-        m_3D.draw_cube(cube);
+        record(EStream::CUBES, [&] { m_3D.draw_cube(cube); });
     }
 
     void Renderer::draw_quad(const Quad& quad) {
         if (quad.col.a == 0) return;
-        flush_if(m_2D, m_2D.quads().should_flush(), ERenderPrimitive::QUAD);
-        m_2D.draw_cube(quad);
+        record(EStream::INSTANCED_QUADS, [&] { m_Quads.draw_quad(quad); });
     }
 
-    void Renderer::start_batch(RenderModule& module) {
-        module.reset();
+    void Renderer::draw_triangles(std::span<const Triangle> triangles) {
+        if (triangles.empty()) return;
+        record(EStream::TRIANGLES, [&] { m_2D.draw_triangles(triangles); });
+    }
+
+    void Renderer::draw_quads(std::span<const Quad> quads) {
+        if (quads.empty()) return;
+        record(EStream::INSTANCED_QUADS, [&] { m_Quads.draw_quads(quads); });
+    }
+
+    void Renderer::set_draw_order(const DrawOrder& order) {
+        m_Order = order;
+    }
+
+    const RenderQueueStats& Renderer::queue_stats() const {
+        return m_Queue.stats();
+    }
+
+    IRenderPrimitive& Renderer::stream(EStream stream) {
+        switch (stream) {
+            case EStream::CUBES:           return m_3D.primitive(ERenderPrimitive::QUAD);
+            case EStream::INSTANCED_QUADS: return m_Quads.instances();
+            case EStream::TRIANGLES:       return m_2D.primitive(ERenderPrimitive::TRIANGLE);
+            case EStream::QUADS:           return m_2D.primitive(ERenderPrimitive::QUAD);
+            default:
+                throw std::out_of_range("EStream");
+        }
     }
 
-    void Renderer::flush(RenderModule& module, ERenderPrimitive primitive) {
-        auto* cmd = m_Frames[m_Img].cmd_buffer;
-        module.flush(cmd, m_Ctx->devices());
+    vk::Pipeline& Renderer::pipeline(u32 index) {
+        switch (index) {
+            case 0:  return m_3D.pipeline();
+            case 1:  return m_Quads.pipeline();
+            case 2:  return m_2D.pipeline();
+            default:
+                throw std::out_of_range("Pipeline index");
+        }
     }
 
-    void Renderer::flush_if(RenderModule& module, bool flush, ERenderPrimitive primitive) {
-        if (flush) {
-            this->on_end();
-            start_batch(module);
-            this->on_begin();
+    void Renderer::begin_slot() {
+        m_Slot = (m_Slot + 1) % MAX_FRAMES_IN_FLIGHT;
+        FrameSlot& slot = m_Slots[m_Slot];
+        if (slot.serial > m_Retired) {
+            // The image's fence is only reset once it has been waited on, which retires the submission,
+            // so it still belongs to the submission that read this slot.
+            VkFence fence = m_Frames[slot.img].queue_submit;
+            VK_CHECK(vkWaitForFences(m_Ctx->devices().logical(), 1, &fence, true, UINT64_MAX));
+            m_Retired = slot.serial;
         }
     }
 
+    void Renderer::start_batch(RenderModule& module) {
+        module.reset(m_Slot);
+    }
+
     void Renderer::destroy() {
         auto* logical = m_Ctx->devices().logical();
 
@@ -79,24 +146,38 @@ namespace aby::vk {
             vkDestroySemaphore(logical, semaphore, IAllocator::get());
         }
         m_Swapchain.destroy(m_Ctx->devices(), m_Frames);
+        // The device is idle, free retired images while the descriptor pools they came from still exist.
+        m_Ctx->collect(m_Submitted, m_Submitted);
         m_2D.destroy();
         m_3D.destroy();
+        m_Quads.destroy();
     }
 
     void Renderer::on_begin() {
+        begin_slot();
         start_batch(m_2D);
+        start_batch(m_3D);
+        m_Quads.reset(m_Slot);
+        m_Queue.clear();
+        m_Order = {};
         auto viewport_size = m_Swapchain.size();
         glm::mat4 ortho_view_proj = glm::ortho(0.0f, static_cast<float>(viewport_size.x), 0.0f, static_cast<float>(viewport_size.y), -1.0f, 1.0f);
         m_2D.module()->set_uniforms(&ortho_view_proj, sizeof(ortho_view_proj));
+        m_Quads.set_uniforms(&ortho_view_proj, sizeof(ortho_view_proj));
     }
 
     void Renderer::on_begin(const glm::mat4& view_projection) {
+        begin_slot();
         start_batch(m_2D);
         start_batch(m_3D);
+        m_Quads.reset(m_Slot);
+        m_Queue.clear();
+        m_Order = {};
         m_3D.set_uniforms(&view_projection, sizeof(view_projection));
         auto viewport_size = m_Swapchain.size(); 
         glm::mat4 ortho_view_proj = glm::ortho(0.0f, static_cast<float>(viewport_size.x), 0.0f, static_cast<float>(viewport_size.y), -1.0f, 1.0f);
         m_2D.set_uniforms(&ortho_view_proj, sizeof(ortho_view_proj));
+        m_Quads.set_uniforms(&ortho_view_proj, sizeof(ortho_view_proj));
     }
 
     void Renderer::on_end() {
@@ -110,9 +191,14 @@ namespace aby::vk {
         }
         if (res != VK_SUCCESS) {
             vkQueueWaitIdle(m_Ctx->devices().graphics().Queue);
+            m_Retired = m_Submitted;
             return;
         }
         render(m_Img);
+        m_Submitted++;
+        m_Slots[m_Slot] = { m_Submitted, m_Img };
+        m_ImgSerials[m_Img] = m_Submitted;
+        m_Ctx->collect(m_Submitted, m_Retired);
         res = present_img(m_Img);
 
         if (res == VK_SUBOPTIMAL_KHR || res == VK_ERROR_OUT_OF_DATE_KHR)
@@ -137,6 +223,9 @@ namespace aby::vk {
         };
         VK_CHECK(vkBeginCommandBuffer(cmd, &begin_info));
 
+        // Texture uploads queued since the last frame are copied before anything samples them.
+        m_Ctx->uploads().flush(cmd, img);
+
     // Before starting rendering, transition the swapchain image to COLOR_ATTACHMENT_OPTIMAL
         helper::transition_image_layout(
             cmd,
@@ -209,18 +298,30 @@ namespace aby::vk {
 
         vkCmdBeginRendering(cmd, &rendering_info);
         
-        m_3D.pipeline().bind(cmd);
-        vkCmdSetViewport(cmd, 0, 1, &vp);
-        vkCmdSetScissor(cmd, 0, 1, &scissor);
-        vkCmdSetCullMode(cmd, VK_CULL_MODE_NONE);
-        vkCmdSetFrontFace(cmd, VK_FRONT_FACE_CLOCKWISE);
-        vkCmdSetPrimitiveTopology(cmd, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
-        flush(m_3D, ERenderPrimitive::ALL);
-       
-        m_2D.pipeline().bind(cmd);
-        vkCmdSetCullMode(cmd, VK_CULL_MODE_NONE);
-        vkCmdSetPrimitiveTopology(cmd, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
-        flush(m_2D, ERenderPrimitive::ALL);
+        // Within a layer and depth the streams keep the fixed order: 3D, instanced quads (backgrounds, panels),
+        // then the 2D batches, which carry the text. Ranges that continue each other are drawn with one call.
+        u32 bound_pipeline = UINT32_MAX;
+        u32 bound_stream   = UINT32_MAX;
+        u32 bound_batch    = UINT32_MAX;
+        for (const DrawPacket& packet : m_Queue.sort()) {
+            if (STREAM_PIPELINES[packet.stream] != bound_pipeline) {
+                bound_pipeline = STREAM_PIPELINES[packet.stream];
+                bound_stream   = UINT32_MAX;
+                pipeline(bound_pipeline).bind(cmd);
+                vkCmdSetViewport(cmd, 0, 1, &vp);
+                vkCmdSetScissor(cmd, 0, 1, &scissor);
+                vkCmdSetCullMode(cmd, VK_CULL_MODE_NONE);
+                vkCmdSetFrontFace(cmd, VK_FRONT_FACE_CLOCKWISE);
+                vkCmdSetPrimitiveTopology(cmd, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
+            }
+            IRenderPrimitive& primitive = stream(static_cast<EStream>(packet.stream));
+            if (packet.stream != bound_stream || packet.batch != bound_batch) {
+                bound_stream = packet.stream;
+                bound_batch  = packet.batch;
+                primitive.bind(cmd, packet.batch);
+            }
+            primitive.draw(cmd, packet.first, packet.count);
+        }
 
         ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), cmd);
 
@@ -289,6 +390,8 @@ namespace aby::vk {
         }
 
         vkDeviceWaitIdle(m_Ctx->devices().logical());
+        m_Ctx->uploads().retire_all();
+        m_Retired = m_Submitted;
         
         recreate_swapchain();
         
@@ -322,9 +425,14 @@ namespace aby::vk {
         auto queue_submit = m_Frames[img].queue_submit;
         auto cmd_pool = m_Frames[img].cmd_pool;
 
+        if (m_ImgSerials.size() != m_Frames.size()) {
+            m_ImgSerials.resize(m_Frames.size(), 0);
+        }
         if (queue_submit != VK_NULL_HANDLE) {
             vkWaitForFences(logical, 1, &queue_submit, true, UINT64_MAX);
             vkResetFences(logical, 1, &queue_submit);
+            m_Ctx->uploads().retire(img);
+            m_Retired = std::max(m_Retired, m_ImgSerials[img]);
         }
 
         if (cmd_pool != VK_NULL_HANDLE) {
@@ -371,6 +479,9 @@ namespace aby::vk {
     vk::RenderModule& Renderer::rm3d() {
         return m_3D;
     }
+    vk::InstancedQuadModule& Renderer::quads() {
+        return m_Quads;
+    }
 
     vk::Swapchain& Renderer::swapchain() {
         return m_Swapchain;
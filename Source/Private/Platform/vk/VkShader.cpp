@@ -17,7 +17,7 @@ namespace aby::vk {
         m_Logical(devices.logical()),
         m_Module(VK_NULL_HANDLE),
         m_Layout(VK_NULL_HANDLE),
-        m_Descriptor(ShaderCompiler::reflect(m_Data)) 
+        m_Descriptor(ShaderCompiler::reflect(app, path, m_Data)) 
     {
         Timer timer;
         // Create shader module
@@ -100,6 +100,11 @@ namespace aby::vk {
         vkDestroyDescriptorSetLayout(m_Logical, m_Layout, IAllocator::get());
     }
 
+    u64 Shader::device_bytes() const {
+        // The driver keeps its own copy of the spirv for the lifetime of the module.
+        return m_Module != VK_NULL_HANDLE ? bytes() : 0;
+    }
+
     const ShaderDescriptor& Shader::descriptor() const {
         return m_Descriptor;
     }
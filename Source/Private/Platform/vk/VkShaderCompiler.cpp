@@ -6,7 +6,10 @@
 #include <spirv_cross/spirv_glsl.hpp>
 #include <spirv_cross/spirv_reflect.hpp>
 
+#include <array>
+#include <cstring>
 #include <fstream>
+#include <string_view>
 
 namespace aby::vk::helper {
 
@@ -42,12 +45,51 @@ namespace aby::vk::helper {
 
         return stride;
     }
+
+    /**
+    * Narrower vertex format requested by the suffix of an input's name, e.g. a_color_unorm8,
+    * or VK_FORMAT_UNDEFINED for the 32-bit format of its type.
+    *  _unorm8  float vecN -> R8..._UNORM
+    *  _unorm16 float vecN -> R16..._UNORM
+    *  _f16     float vecN -> R16..._SFLOAT
+    *  _u16     uint  vecN -> R16..._UINT
+    */
+    static VkFormat get_packed_format(const std::string& name, const spirv_cross::SPIRType& type) {
+        struct PackedFormat {
+            std::string_view                suffix;
+            spirv_cross::SPIRType::BaseType basetype;
+            std::array<VkFormat, 4>         formats;
+        };
+        static constexpr PackedFormat PACKED_FORMATS[] = {
+            { "_unorm8",  spirv_cross::SPIRType::Float, { VK_FORMAT_R8_UNORM,   VK_FORMAT_R8G8_UNORM,    VK_FORMAT_R8G8B8_UNORM,       VK_FORMAT_R8G8B8A8_UNORM      } },
+            { "_unorm16", spirv_cross::SPIRType::Float, { VK_FORMAT_R16_UNORM,  VK_FORMAT_R16G16_UNORM,  VK_FORMAT_R16G16B16_UNORM,    VK_FORMAT_R16G16B16A16_UNORM  } },
+            { "_f16",     spirv_cross::SPIRType::Float, { VK_FORMAT_R16_SFLOAT, VK_FORMAT_R16G16_SFLOAT, VK_FORMAT_R16G16B16_SFLOAT,   VK_FORMAT_R16G16B16A16_SFLOAT } },
+            { "_u16",     spirv_cross::SPIRType::UInt,  { VK_FORMAT_R16_UINT,   VK_FORMAT_R16G16_UINT,   VK_FORMAT_R16G16B16_UINT,     VK_FORMAT_R16G16B16A16_UINT   } },
+        };
+        if (type.columns > 1 || type.vecsize < 1 || type.vecsize > 4) {
+            return VK_FORMAT_UNDEFINED;
+        }
+        for (const auto& packed : PACKED_FORMATS) {
+            if (type.basetype == packed.basetype && name.ends_with(packed.suffix)) {
+                return packed.formats[type.vecsize - 1];
+            }
+        }
+        return VK_FORMAT_UNDEFINED;
+    }
 }
 
 namespace aby::vk {
 
     std::vector<u32> ShaderCompiler::compile(App* app, DeviceManager& devices, const fs::path& path, EShader type) {
         auto cached = cache_dir(app, path);
+        if (auto archive = app->archive()) {
+            if (auto entry = archive->find(util::Archive::key(app->bin(), cached), util::EArchiveEntry::SPIRV)) {
+                auto bytes = archive->data(*entry);
+                std::vector<u32> out(bytes.size() / sizeof(u32));
+                std::memcpy(out.data(), bytes.data(), out.size() * sizeof(u32));
+                return out;
+            }
+        }
         if (fs::exists(cached)) {
             std::vector<u32> out;
             std::ifstream in(cached, std::ios::in | std::ios::binary);
@@ -106,6 +148,12 @@ namespace aby::vk {
             return {};
         }
 
+        // Reflection cached for the previous binary is stale now.
+        fs::path reflection = cached;
+        reflection += util::REFLECTION_EXT;
+        std::error_code ec;
+        fs::remove(reflection, ec);
+
         ABY_DBG("Compiled glsl shader: {}", path.string());
         return out;
     }
@@ -175,11 +223,15 @@ namespace aby::vk {
             uint32_t location = compiler.get_decoration(input.id, spv::DecorationLocation);
             uint32_t binding  = compiler.get_decoration(input.id, spv::DecorationBinding);
             uint32_t stride   = helper::get_stride(type);
-            uint32_t offset   = global_offset;
-            global_offset += stride;
 
-            VkFormat format = VK_FORMAT_UNDEFINED;
-            if (type.basetype == spirv_cross::SPIRType::Float) {
+            VkFormat format = helper::get_packed_format(input.name, type);
+            if (format != VK_FORMAT_UNDEFINED) {
+                stride = static_cast<uint32_t>(ShaderDescriptor::format_size(format));
+                // Keep narrow inputs aligned to their component size.
+                uint32_t component = stride / type.vecsize;
+                global_offset = (global_offset + component - 1) / component * component;
+            }
+            else if (type.basetype == spirv_cross::SPIRType::Float) {
                 switch (type.vecsize) {
                     case 1: format = VK_FORMAT_R32_SFLOAT; break;
                     case 2: format = VK_FORMAT_R32G32_SFLOAT; break;
@@ -213,11 +265,47 @@ namespace aby::vk {
                 ABY_ERR("Unsupported shader input type!");
             }
 
+            uint32_t offset = global_offset;
+            global_offset += stride;
             descriptor.inputs.emplace_back(location, binding, offset, stride, format);
         }
         return descriptor;
     }
 
+    ShaderDescriptor ShaderCompiler::reflect(App* app, const fs::path& path, const std::vector<u32>& binary_data) {
+        auto cached = cache_dir(app, path);
+        cached += util::REFLECTION_EXT;
+        if (auto archive = app->archive()) {
+            if (auto entry = archive->find(util::Archive::key(app->bin(), cached), util::EArchiveEntry::REFLECTION)) {
+                if (auto descriptor = ShaderDescriptor::deserialize(archive->data(*entry))) {
+                    return *descriptor;
+                }
+                ABY_WARN("Corrupt archived shader reflection: {}", path);
+            }
+        }
+
+        if (fs::exists(cached)) {
+            util::MappedFile file(cached);
+            if (file) {
+                auto view = file.view();
+                if (auto descriptor = ShaderDescriptor::deserialize({ reinterpret_cast<const std::byte*>(view.data()), view.size() })) {
+                    return *descriptor;
+                }
+            }
+        }
+
+        auto descriptor = reflect(binary_data);
+        auto bytes      = descriptor.serialize();
+        std::ofstream ofs(cached, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (ofs.is_open()) {
+            ofs.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        }
+        else {
+            ABY_WARN("Failed to cache shader reflection: {}", cached.string());
+        }
+        return descriptor;
+    }
+
     EShader ShaderCompiler::get_type_from_ext(const fs::path& ext) {
         if (ext == ".vert" || ext == ".vertex") {
             return EShader::VERTEX;
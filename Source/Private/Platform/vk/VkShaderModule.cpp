@@ -6,90 +6,92 @@
 
 namespace aby::vk {
 
-   class TextureResourceHandler : public IResourceHandler<aby::Texture> {
-   public:
-       TextureResourceHandler(ShaderModule* shader_module) : 
-           IResourceHandler(shader_module) 
-       {
-           auto logical = shader_module->m_Ctx->devices().logical();
-           VkDescriptorSetLayoutBinding binding[1] = {};
-           binding[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-           binding[0].descriptorCount = 1;
-           binding[0].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
-           VkDescriptorSetLayoutCreateInfo info = {};
-           info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-           info.bindingCount = 1;
-           info.pBindings = binding;
-           VK_CHECK(vkCreateDescriptorSetLayout(logical, &info, vk::Allocator::get(), &m_ImGuiLayout));
-       }
-
-       void on_add(Handle handle, Ref<aby::Texture> texture) override {
-           auto  tex = std::static_pointer_cast<vk::Texture>(texture);
-           tex->m_Handler      = this;
-           tex->m_Handle       = handle;
-           update_descriptor_sets(handle, tex);
-       }
-       
-       void on_erase(Handle handle, Ref<aby::Texture> texture) override {
-
-       }
-
-       void update_descriptor_sets(Handle handle, Ref<vk::Texture> tex) {
-           auto* shader_module = std::any_cast<ShaderModule*>(m_UserData);
-           auto logical        = shader_module->m_Ctx->devices().logical();
-
-           VkDescriptorImageInfo img_info{
-              .sampler = tex->sampler(),
-              .imageView = tex->view(),
-              .imageLayout = tex->layout(),
-           };
-
-           // Write to bindless texture array.
-           {
-               VkWriteDescriptorSet write{
-                   .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                   .pNext = nullptr,
-                   .dstSet = shader_module->m_Descriptors[1],
-                   .dstBinding = BINDLESS_TEXTURE_BINDING,
-                   .dstArrayElement = handle,
-                   .descriptorCount = 1,
-                   .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                   .pImageInfo = &img_info,
-                   .pBufferInfo = nullptr,
-                   .pTexelBufferView = nullptr,
-               };
-               vkUpdateDescriptorSets(logical, 1, &write, 0, nullptr);
-           }
-           // Write to vk::Texture::m_ImGuiID
-           {
-                VkDescriptorSetAllocateInfo alloc_info{
-                   .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
-                   .pNext = nullptr,
-                   .descriptorPool = shader_module->pool(),
-                   .descriptorSetCount = 1,
-                   .pSetLayouts = &m_ImGuiLayout,
-                };
-                vkAllocateDescriptorSets(logical, &alloc_info, &tex->imgui_descriptor());
-
-                VkWriteDescriptorSet write{
-                    .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                    .pNext = nullptr,
-                    .dstSet = tex->imgui_descriptor(),
-                    .dstBinding = {},
-                    .dstArrayElement = {},
-                    .descriptorCount = 1,
-                    .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                    .pImageInfo = &img_info,
-                    .pBufferInfo = nullptr,
-                    .pTexelBufferView = nullptr
-               };
-           
-               vkUpdateDescriptorSets(logical, 1, &write, 0, nullptr);
-           }
-       }
-   private:
-       VkDescriptorSetLayout m_ImGuiLayout;
-   };
+    TextureResourceHandler::TextureResourceHandler(ShaderModule* shader_module) : 
+        IResourceHandler(shader_module) 
+    {
+        auto logical = shader_module->m_Ctx->devices().logical();
+        VkDescriptorSetLayoutBinding binding[1] = {};
+        binding[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        binding[0].descriptorCount = 1;
+        binding[0].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+        VkDescriptorSetLayoutCreateInfo info = {};
+        info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        info.bindingCount = 1;
+        info.pBindings = binding;
+        VK_CHECK(vkCreateDescriptorSetLayout(logical, &info, vk::Allocator::get(), &m_ImGuiLayout));
+    }
+
+    void TextureResourceHandler::on_add(Handle handle, Ref<aby::Texture> texture) {
+        auto  tex = std::static_pointer_cast<vk::Texture>(texture);
+        // A placeholder is bound to every reserved handle, it keeps the handle it was added with.
+        if (tex->m_Handle == Resource::null) {
+            tex->m_Handler  = this;
+            tex->m_Handle   = handle;
+        }
+        update_descriptor_sets(handle, tex.get());
+    }
+    
+    void TextureResourceHandler::on_erase(Handle handle, Ref<aby::Texture> texture) {
+
+    }
+
+    VkDescriptorPool TextureResourceHandler::pool() const {
+        return std::any_cast<ShaderModule*>(m_UserData)->pool();
+    }
+
+    void TextureResourceHandler::update_descriptor_sets(Handle handle, vk::Texture* tex) {
+        auto* shader_module = std::any_cast<ShaderModule*>(m_UserData);
+        auto logical        = shader_module->m_Ctx->devices().logical();
+
+        VkDescriptorImageInfo img_info{
+           .sampler = tex->sampler(),
+           .imageView = tex->view(),
+           .imageLayout = tex->layout(),
+        };
+
+        // Write to bindless texture array.
+        {
+            VkWriteDescriptorSet write{
+                .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                .pNext = nullptr,
+                .dstSet = shader_module->m_Descriptors[1],
+                .dstBinding = BINDLESS_TEXTURE_BINDING,
+                .dstArrayElement = Resource::index_of(handle),
+                .descriptorCount = 1,
+                .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                .pImageInfo = &img_info,
+                .pBufferInfo = nullptr,
+                .pTexelBufferView = nullptr,
+            };
+            vkUpdateDescriptorSets(logical, 1, &write, 0, nullptr);
+        }
+        // Write to vk::Texture::m_ImGuiID, rewritten when the texture was recreated.
+        if (tex->imgui_descriptor() == VK_NULL_HANDLE) {
+            VkDescriptorSetAllocateInfo alloc_info{
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+                .pNext = nullptr,
+                .descriptorPool = shader_module->pool(),
+                .descriptorSetCount = 1,
+                .pSetLayouts = &m_ImGuiLayout,
+            };
+            vkAllocateDescriptorSets(logical, &alloc_info, &tex->imgui_descriptor());
+        }
+        {
+            VkWriteDescriptorSet write{
+                .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                .pNext = nullptr,
+                .dstSet = tex->imgui_descriptor(),
+                .dstBinding = {},
+                .dstArrayElement = {},
+                .descriptorCount = 1,
+                .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                .pImageInfo = &img_info,
+                .pBufferInfo = nullptr,
+                .pTexelBufferView = nullptr
+            };
+            vkUpdateDescriptorSets(logical, 1, &write, 0, nullptr);
+        }
+    }
 
 }
 
@@ -1,5 +1,58 @@
 #include "Platform/vk/VkShaderStructs.h"
 #include "Utility/Inserter.h"
+#include <algorithm>
+#include <cstring>
+
+namespace aby::vk::helper {
+
+    class DescriptorWriter {
+    public:
+        void u32(uint32_t value) {
+            auto bytes = reinterpret_cast<const std::byte*>(&value);
+            m_Data.insert(m_Data.end(), bytes, bytes + sizeof(value));
+        }
+        void str(const std::string& value) {
+            u32(static_cast<uint32_t>(value.size()));
+            auto bytes = reinterpret_cast<const std::byte*>(value.data());
+            m_Data.insert(m_Data.end(), bytes, bytes + value.size());
+        }
+        std::vector<std::byte>& data() { return m_Data; }
+    private:
+        std::vector<std::byte> m_Data;
+    };
+
+    class DescriptorReader {
+    public:
+        explicit DescriptorReader(std::span<const std::byte> bytes) : m_Bytes(bytes), m_Offset(0), bFailed(false) {}
+
+        uint32_t u32() {
+            uint32_t value = 0;
+            if (!take(sizeof(value))) return value;
+            std::memcpy(&value, m_Bytes.data() + m_Offset - sizeof(value), sizeof(value));
+            return value;
+        }
+        std::string str() {
+            uint32_t size = u32();
+            if (!take(size)) return {};
+            return std::string(reinterpret_cast<const char*>(m_Bytes.data() + m_Offset - size), size);
+        }
+        bool failed() const { return bFailed; }
+    private:
+        bool take(std::size_t bytes) {
+            if (bFailed || m_Offset + bytes > m_Bytes.size()) {
+                bFailed = true;
+                return false;
+            }
+            m_Offset += bytes;
+            return true;
+        }
+    private:
+        std::span<const std::byte> m_Bytes;
+        std::size_t                m_Offset;
+        bool                       bFailed;
+    };
+
+}
 
 namespace aby::vk {
 
@@ -18,13 +71,31 @@ namespace aby::vk {
         return binding_size_map;
     }
     std::map<std::size_t, std::size_t> ShaderDescriptor::input_binding_stride() const {
+        // Narrow formats may leave padding between inputs, so the stride is where the last input ends.
         std::map<std::size_t, std::size_t> binding_stride_map;
         for (const auto& input : inputs) {
-            binding_stride_map[input.binding] += format_size(input.format);
+            auto& stride = binding_stride_map[input.binding];
+            stride = std::max(stride, input.offset + format_size(input.format));
+        }
+        for (auto& [binding, stride] : binding_stride_map) {
+            stride = (stride + 3) & ~std::size_t(3);
         }
         return binding_stride_map;
     }
 
+    bool ShaderDescriptor::matches(uint32_t binding, std::span<const VertexAttribute> attributes) const {
+        std::size_t count = 0;
+        for (const auto& input : inputs) {
+            if (input.binding != binding) continue;
+            count++;
+            auto it = std::ranges::find(attributes, input.location, &VertexAttribute::location);
+            if (it == attributes.end() || it->offset != input.offset || it->format != input.format) {
+                return false;
+            }
+        }
+        return count == attributes.size();
+    }
+
     std::size_t ShaderDescriptor::format_size(VkFormat format) {
         switch (format) {
         case VK_FORMAT_R32_SFLOAT: return 4;
@@ -39,10 +110,95 @@ namespace aby::vk {
         case VK_FORMAT_R32G32_UINT: return 8;
         case VK_FORMAT_R32G32B32_UINT: return 12;
         case VK_FORMAT_R32G32B32A32_UINT: return 16;
+        case VK_FORMAT_R8_UNORM: return 1;
+        case VK_FORMAT_R8G8_UNORM: return 2;
+        case VK_FORMAT_R8G8B8_UNORM: return 3;
+        case VK_FORMAT_R8G8B8A8_UNORM: return 4;
+        case VK_FORMAT_R16_UNORM: return 2;
+        case VK_FORMAT_R16G16_UNORM: return 4;
+        case VK_FORMAT_R16G16B16_UNORM: return 6;
+        case VK_FORMAT_R16G16B16A16_UNORM: return 8;
+        case VK_FORMAT_R16_SFLOAT: return 2;
+        case VK_FORMAT_R16G16_SFLOAT: return 4;
+        case VK_FORMAT_R16G16B16_SFLOAT: return 6;
+        case VK_FORMAT_R16G16B16A16_SFLOAT: return 8;
+        case VK_FORMAT_R16_UINT: return 2;
+        case VK_FORMAT_R16G16_UINT: return 4;
+        case VK_FORMAT_R16G16B16_UINT: return 6;
+        case VK_FORMAT_R16G16B16A16_UINT: return 8;
         default: return 0;
         }
     }
 
+    std::vector<std::byte> ShaderDescriptor::serialize() const {
+        helper::DescriptorWriter w;
+        w.u32(static_cast<uint32_t>(uniforms.size()));
+        for (const auto& uniform : uniforms) {
+            w.str(uniform.name);
+            w.u32(uniform.set);
+            w.u32(uniform.binding);
+            w.u32(uniform.size);
+        }
+        w.u32(static_cast<uint32_t>(storages.size()));
+        for (const auto& storage : storages) {
+            w.str(storage.name);
+            w.u32(storage.set);
+            w.u32(storage.binding);
+        }
+        w.u32(static_cast<uint32_t>(samplers.size()));
+        for (const auto& sampler : samplers) {
+            w.str(sampler.name);
+            w.u32(sampler.set);
+            w.u32(sampler.binding);
+            w.u32(sampler.count);
+        }
+        w.u32(static_cast<uint32_t>(inputs.size()));
+        for (const auto& input : inputs) {
+            w.u32(input.location);
+            w.u32(input.binding);
+            w.u32(input.offset);
+            w.u32(input.stride);
+            w.u32(static_cast<uint32_t>(input.format));
+        }
+        return std::move(w.data());
+    }
+
+    std::optional<ShaderDescriptor> ShaderDescriptor::deserialize(std::span<const std::byte> bytes) {
+        helper::DescriptorReader r(bytes);
+        ShaderDescriptor descriptor;
+        // Fields are read one statement at a time, argument evaluation order is unspecified.
+        for (uint32_t i = 0, n = r.u32(); i < n && !r.failed(); i++) {
+            auto& uniform   = descriptor.uniforms.emplace_back();
+            uniform.name    = r.str();
+            uniform.set     = r.u32();
+            uniform.binding = r.u32();
+            uniform.size    = r.u32();
+        }
+        for (uint32_t i = 0, n = r.u32(); i < n && !r.failed(); i++) {
+            auto& storage   = descriptor.storages.emplace_back();
+            storage.name    = r.str();
+            storage.set     = r.u32();
+            storage.binding = r.u32();
+        }
+        for (uint32_t i = 0, n = r.u32(); i < n && !r.failed(); i++) {
+            auto& sampler   = descriptor.samplers.emplace_back();
+            sampler.name    = r.str();
+            sampler.set     = r.u32();
+            sampler.binding = r.u32();
+            sampler.count   = r.u32();
+        }
+        for (uint32_t i = 0, n = r.u32(); i < n && !r.failed(); i++) {
+            auto& input    = descriptor.inputs.emplace_back();
+            input.location = r.u32();
+            input.binding  = r.u32();
+            input.offset   = r.u32();
+            input.stride   = r.u32();
+            input.format   = static_cast<VkFormat>(r.u32());
+        }
+        if (r.failed()) return std::nullopt;
+        return descriptor;
+    }
+
 }
 
 namespace aby::vk {
@@ -52,11 +208,9 @@ namespace aby::vk {
         m_VertexSize(0),
         m_MaxVertices(max_vertices)
     {
-        auto mapped = util::map_vector(descriptor.inputs, [](const ShaderInput& input) { return input.binding; });
-        auto range = mapped.equal_range(binding);
-        for (auto it = range.first; it != range.second; ++it) {
-            ShaderInput& input = it->second;
-            m_VertexSize += descriptor.format_size(input.format);
+        auto strides = descriptor.input_binding_stride();
+        if (auto it = strides.find(binding); it != strides.end()) {
+            m_VertexSize = it->second;
         }
     }
 
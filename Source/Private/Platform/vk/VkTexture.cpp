@@ -2,8 +2,12 @@
 #include "Platform/vk/VkContext.h"
 #include "Platform/vk/VkAllocator.h"
 #include "Platform/vk/VkRenderer.h"
+#include "Platform/vk/VkShaderModule.h"
+#include "Rendering/MipChain.h"
 #include "Core/App.h"
 #include "Utility/Profiler.h"
+#include <numeric>
+#include <utility>
 
 // Texture
 namespace aby::vk {
@@ -75,6 +79,47 @@ namespace aby::vk {
         init();
     }
 
+    Texture::Texture(vk::Context* ctx, const glm::u32vec2& size, std::vector<std::byte>&& data, u32 channels, ETextureFormat format, bool upload) :
+        aby::Texture(size, std::move(data), channels, format),
+        m_Logical(ctx->devices().logical()),
+        m_Format(m_AbyFormat == ETextureFormat::BGRA ? VK_FORMAT_B8G8R8A8_SRGB : VK_FORMAT_UNDEFINED),
+        m_Layout(VK_IMAGE_LAYOUT_UNDEFINED),
+        m_Image(VK_NULL_HANDLE),
+        m_View(VK_NULL_HANDLE),
+        m_ImageMemory(VK_NULL_HANDLE),
+        m_Sampler(VK_NULL_HANDLE),
+        m_ImGuiID(VK_NULL_HANDLE),
+        m_Ctx(ctx),
+        m_Handler(nullptr),
+        m_Handle(Resource::null)
+    {
+        if (upload) {
+            init();
+        }
+    }
+
+    Texture::Texture(vk::Context* ctx, const glm::u32vec2& size, Ref<StagingBuffer> staging, u32 channels, ETextureFormat format, u32 levels, bool keep_data, bool upload) :
+        aby::Texture(size, channels, format, keep_data ? std::as_const(*staging).span().first(texture_bytes(size, channels, format)) : std::span<const std::byte>{}, levels),
+        m_Logical(ctx->devices().logical()),
+        m_Format(m_AbyFormat == ETextureFormat::BGRA ? VK_FORMAT_B8G8R8A8_SRGB : VK_FORMAT_UNDEFINED),
+        m_Layout(VK_IMAGE_LAYOUT_UNDEFINED),
+        m_Image(VK_NULL_HANDLE),
+        m_View(VK_NULL_HANDLE),
+        m_ImageMemory(VK_NULL_HANDLE),
+        m_Sampler(VK_NULL_HANDLE),
+        m_ImGuiID(VK_NULL_HANDLE),
+        m_Ctx(ctx),
+        m_Handler(nullptr),
+        m_Handle(Resource::null)
+    {
+        auto block = block_format(format);
+        auto chain = block == util::EBlockFormat::NONE ? MipChain(size, channels, levels) : MipChain(size, block, levels);
+        ABY_ASSERT(staging->size() >= chain.bytes(), "Staging buffer is smaller than the image");
+        if (upload) {
+            init(std::move(staging));
+        }
+    }
+
     Texture::Texture(vk::Context* ctx, const glm::u32vec2& size, const void* data, u32 channels, ETextureFormat format) :
         aby::Texture(size, data, channels, format),
         m_Logical(ctx->devices().logical()),
@@ -128,19 +173,63 @@ namespace aby::vk {
     }
 
     void Texture::init() {
-        auto c = this->channels();
-        auto& size = this->size();
-
-        const std::byte* p = this->data().data();
-        const void* vp = static_cast<const void*>(p);
-        ABY_ASSERT(p, "Data is not valid");
-        ABY_ASSERT(vp, "Data is not valid");
+        ABY_ASSERT(this->data().data(), "Data is not valid");
+
+        create_image();
+        if (!queue_upload(this->data())) {
+            // The ring is full, upload on the spot instead of waiting for a frame to retire.
+            vk::Buffer      staging(this->data().data(), this->bytes(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT, m_Ctx->devices());
+            Ref<CmdPool>    cmd_pool = m_Ctx->devices().create_cmd_pool();
+            VkCommandBuffer cmd      = helper::begin_single_time_commands(m_Logical, cmd_pool.get()->operator const VkCommandPool());
+            record_upload(cmd, staging, 0);
+            helper::end_single_time_commands(
+                cmd,
+                m_Logical,
+                cmd_pool.get()->operator const VkCommandPool(),
+                m_Ctx->devices().graphics().Queue
+            );
+            cmd_pool->destroy(m_Logical);
+            staging.destroy();
+        }
+        create_view_sampler();
+    }
+
+    static ImageUpload image_upload(const vk::Texture& tex, VkImage image, VkImageLayout layout) {
+        auto block = block_format(tex.aby::Texture::format());
+        return ImageUpload{
+            .image  = image,
+            .extent = tex.size(),
+            .texel  = block == util::EBlockFormat::NONE ? tex.channels() : util::block_bytes(block),
+            .layout = layout,
+            .levels = 1,
+            .block  = block,
+        };
+    }
 
-        vk::Buffer staging(vp, this->bytes(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT, m_Ctx->devices());
-        Ref<CmdPool> cmd_pool = m_Ctx->devices().create_cmd_pool();
+    void Texture::init(Ref<StagingBuffer> staging) {
+        create_image();
+        queue_upload(std::move(staging));
+        create_view_sampler();
+    }
 
+    void Texture::create_image() {
+        if (m_Format == VK_FORMAT_UNDEFINED) {
+            switch (m_AbyFormat) {
+            case ETextureFormat::BC1:
+                m_Format = VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+                break;
+            case ETextureFormat::BC3:
+                m_Format = VK_FORMAT_BC3_SRGB_BLOCK;
+                break;
+            case ETextureFormat::BC7:
+                m_Format = VK_FORMAT_BC7_SRGB_BLOCK;
+                break;
+            default:
+                break;
+            }
+        }
         if (m_Format == VK_FORMAT_UNDEFINED) {
-            switch (c) {
+            switch (this->channels()) {
             case 4:
                 m_Format = VK_FORMAT_R8G8B8A8_SRGB;
                 break;
@@ -158,6 +247,7 @@ namespace aby::vk {
             }
         }
 
+        auto& size = this->size();
         helper::create_img(
             size.x, size.y, m_Format,
             VK_IMAGE_TILING_OPTIMAL,
@@ -165,10 +255,30 @@ namespace aby::vk {
             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
             m_Image, m_ImageMemory,
             m_Ctx->devices().logical(),
-            m_Ctx->devices().physical()
+            m_Ctx->devices().physical(),
+            this->levels()
         );
-        VkCommandBuffer cmd = helper::begin_single_time_commands(m_Logical, cmd_pool.get()->operator const VkCommandPool());
+    }
 
+    bool Texture::queue_upload(std::span<const std::byte> pixels) {
+        ImageUpload upload = image_upload(*this, m_Image, m_Layout);
+        if (!m_Ctx->uploads().write(upload, pixels.data(), pixels.size())) {
+            return false;
+        }
+        m_Layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        return true;
+    }
+
+    void Texture::queue_upload(Ref<StagingBuffer> staging) {
+        ImageUpload upload = image_upload(*this, m_Image, m_Layout);
+        upload.levels      = this->levels();
+        m_Ctx->uploads().stage(upload, std::move(staging));
+        m_Layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    }
+
+    void Texture::record_upload(VkCommandBuffer cmd, VkBuffer staging, VkDeviceSize offset) {
+        auto& size = this->size();
+        m_Ctx->uploads().flush(cmd, m_Image);
         helper::transition_image_layout(
             cmd,
             m_Image,
@@ -180,7 +290,7 @@ namespace aby::vk {
             VK_PIPELINE_STAGE_TRANSFER_BIT     // Ensure the transfer completes before use
         );
 
-        helper::copy_buffer_to_img(cmd, staging, m_Image, size.x, size.y);
+        helper::copy_buffer_to_img(cmd, staging, m_Image, size.x, size.y, offset);
 
         helper::transition_image_layout(
             cmd,
@@ -192,16 +302,10 @@ namespace aby::vk {
             VK_PIPELINE_STAGE_TRANSFER_BIT,    // Ensure transfer completes
             VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT // The fragment shader will sample this image
         );
+    }
 
-        helper::end_single_time_commands(
-            cmd,
-            m_Logical,
-            cmd_pool.get()->operator const VkCommandPool(),
-            m_Ctx->devices().graphics().Queue
-        );
-
-        staging.destroy();
-        helper::create_img_view(m_Logical, m_Image, m_Format, m_View);
+    void Texture::create_view_sampler() {
+        helper::create_img_view(m_Logical, m_Image, m_Format, m_View, this->levels());
 
         VkSamplerCreateInfo samplerInfo{};
         samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
@@ -218,10 +322,71 @@ namespace aby::vk {
         samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
         samplerInfo.mipLodBias = 0.0f;
         samplerInfo.minLod = 0.0f;
-        samplerInfo.maxLod = VK_LOD_CLAMP_NONE; // If you have mipmaps, adjust accordingly
+        samplerInfo.maxLod = VK_LOD_CLAMP_NONE; // The view limits sampling to the levels the image has
 
         VK_CHECK(vkCreateSampler(m_Logical, &samplerInfo, IAllocator::get(), &m_Sampler));
-        cmd_pool->destroy(m_Logical);
+    }
+
+    void Texture::upload_batch(vk::Context* ctx, std::span<const Ref<vk::Texture>> textures) {
+        if (textures.empty()) return;
+        auto& devices = ctx->devices();
+
+        std::vector<Ref<vk::Texture>> immediate;
+        for (auto& tex : textures) {
+            ABY_ASSERT(tex->m_Image == VK_NULL_HANDLE, "Texture is already uploaded");
+            tex->create_image();
+            if (!tex->queue_upload(tex->data())) {
+                immediate.push_back(tex);
+            }
+            tex->create_view_sampler();
+        }
+        if (immediate.empty()) return;
+
+        // Every image the ring had no room for gets a slice of one staging buffer. Copy offsets must be
+        // a multiple of the texel size, 16 keeps them friendly to the transfer engine as well.
+        std::vector<VkDeviceSize> offsets;
+        offsets.reserve(immediate.size());
+        VkDeviceSize total = 0;
+        for (auto& tex : immediate) {
+            VkDeviceSize align = std::lcm<VkDeviceSize>(std::max<u32>(tex->channels(), 1), 16);
+            total = (total + align - 1) / align * align;
+            offsets.push_back(total);
+            total += tex->bytes();
+        }
+
+        vk::Buffer staging(total, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, devices);
+        for (std::size_t i = 0; i < immediate.size(); i++) {
+            auto view = immediate[i]->data();
+            staging.write(view.data(), view.size(), offsets[i]);
+        }
+
+        std::vector<VkBuffer> buffers(immediate.size(), staging);
+        submit_batch(ctx, immediate, buffers, offsets);
+        staging.destroy();
+    }
+
+    void Texture::upload_batch(vk::Context* ctx, std::span<const Ref<vk::Texture>> textures, std::span<const Ref<StagingBuffer>> staging) {
+        ABY_ASSERT(textures.size() == staging.size(), "Every texture requires a staging buffer");
+        for (std::size_t i = 0; i < textures.size(); i++) {
+            ABY_ASSERT(textures[i]->m_Image == VK_NULL_HANDLE, "Texture is already uploaded");
+            textures[i]->init(staging[i]);
+        }
+    }
+
+    void Texture::submit_batch(vk::Context* ctx, std::span<const Ref<vk::Texture>> textures, std::span<const VkBuffer> buffers, std::span<const VkDeviceSize> offsets) {
+        auto&           devices  = ctx->devices();
+        Ref<CmdPool>    cmd_pool = devices.create_cmd_pool();
+        VkCommandBuffer cmd      = helper::begin_single_time_commands(devices.logical(), cmd_pool->operator const VkCommandPool());
+        for (std::size_t i = 0; i < textures.size(); i++) {
+            textures[i]->record_upload(cmd, buffers[i], offsets[i]);
+        }
+        helper::end_single_time_commands(
+            cmd,
+            devices.logical(),
+            cmd_pool->operator const VkCommandPool(),
+            devices.graphics().Queue
+        );
+        cmd_pool->destroy(devices.logical());
     }
 
     Texture::~Texture() {
@@ -237,6 +402,7 @@ namespace aby::vk {
     }
 
     void Texture::destroy() {
+        if (m_Image)       m_Ctx->uploads().cancel(m_Image);
         if (m_Sampler)     vkDestroySampler(m_Logical, m_Sampler, IAllocator::get());
         if (m_View)        vkDestroyImageView(m_Logical, m_View, IAllocator::get());
         if (m_Image)       vkDestroyImage(m_Logical, m_Image, IAllocator::get());
@@ -246,21 +412,64 @@ namespace aby::vk {
         m_View        = VK_NULL_HANDLE;
         m_Image       = VK_NULL_HANDLE;
         m_ImageMemory = VK_NULL_HANDLE;
+        m_Layout      = VK_IMAGE_LAYOUT_UNDEFINED;
+    }
+
+    void Texture::retire() {
+        if (m_Image) m_Ctx->uploads().cancel(m_Image);
+        m_Ctx->retire(RetiredImage{
+            .image   = m_Image,
+            .view    = m_View,
+            .sampler = m_Sampler,
+            .memory  = m_ImageMemory,
+            .set     = m_ImGuiID,
+            .pool    = m_Handler && m_ImGuiID ? m_Handler->pool() : VK_NULL_HANDLE,
+        });
+
+        m_Sampler     = VK_NULL_HANDLE;
+        m_View        = VK_NULL_HANDLE;
+        m_Image       = VK_NULL_HANDLE;
+        m_ImageMemory = VK_NULL_HANDLE;
+        m_ImGuiID     = VK_NULL_HANDLE;
+        m_Layout      = VK_IMAGE_LAYOUT_UNDEFINED;
     }
     
     void Texture::sync() {
+        std::lock_guard lock(m_Mutex);
         switch (m_State) {
             case ETextureState::GOOD:     
                 return;
             case ETextureState::RECREATE: {
-                destroy();
+                // Frames in flight may still sample the old image through its ImGui descriptor,
+                // which is not update after bind, so the new image gets a fresh one.
+                retire();
                 init();
+                if (m_Handler) {
+                    m_Handler->update_descriptor_sets(m_Handle, this);
+                }
             } break;
             case ETextureState::UPLOAD:   
                 upload();
                 break;
+            case ETextureState::REGION:
+                upload_regions();
+                break;
         }
         m_State = ETextureState::GOOD;
+        m_Dirty.clear();
+        account();
+    }
+
+    void Texture::upload_regions() {
+        ABY_ASSERT(m_Image != VK_NULL_HANDLE, "Texture image is not initialized");
+
+        ImageUpload upload{ .image = m_Image, .extent = this->size(), .texel = this->channels(), .layout = m_Layout };
+        if (m_Ctx->uploads().write_regions(upload, data(), m_Dirty)) {
+            m_Layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            return;
+        }
+        // The ring is full, the immediate path uploads the whole image.
+        this->upload();
     }
 
     
@@ -271,10 +480,14 @@ namespace aby::vk {
 
         ABY_ASSERT(!view.empty(), "No data to upload");
         ABY_ASSERT(m_Image != VK_NULL_HANDLE, "Texture image is not initialized");
+        if (queue_upload(view)) return;
 
         vk::Buffer staging(view.data(), view.size(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT, m_Ctx->devices());
         Ref<CmdPool> cmd_pool = devices.create_cmd_pool();
         VkCommandBuffer cmd = helper::begin_single_time_commands(m_Logical, cmd_pool->operator const VkCommandPool());
+        // m_Layout already assumes the copies still queued in the ring, they have to run first
+        // or the frame flush would overwrite this upload with older pixels.
+        m_Ctx->uploads().flush(cmd, m_Image);
 
         // Optional: transition to transfer dst if layout is not already optimal
         helper::transition_image_layout(
@@ -313,6 +526,10 @@ namespace aby::vk {
         cmd_pool->destroy(m_Logical);
     }
 
+    u64 Texture::device_bytes() const {
+        return m_Image != VK_NULL_HANDLE ? aby::Texture::device_bytes() : 0;
+    }
+
     VkImage Texture::img() {
         return m_Image;
     }
@@ -426,6 +643,7 @@ namespace aby::vk {
     }
 
     void BufferedTexture::write(const glm::u32vec2& size, const void* data) {
+        ABY_ASSERT(!m_Exchange, "Streaming buffered textures are written through acquire/publish");
         PROFILE_SCOPE("Write");
         m_Idx = (m_Idx + 1) % m_Texs.size();
         PerTex& target = m_Texs[m_Idx];
@@ -475,6 +693,69 @@ namespace aby::vk {
     }
 
 
+    void BufferedTexture::stream() {
+        if (m_Exchange) return;
+        // The render thread holds a slot per frame in flight, one more is published and one is being written.
+        std::size_t frames = static_cast<vk::Renderer&>(m_Ctx->app()->renderer()).swapchain().frames_in_flight();
+        std::size_t bytes  = static_cast<std::size_t>(size().x) * size().y * channels();
+        u32         slots  = static_cast<u32>(frames) + 2;
+        for (u32 i = 0; i < slots; i++) {
+            m_Slots.push_back(create_ref<StagingBuffer>(bytes, m_Ctx->devices()));
+        }
+        m_Exchange = create_unique<util::SlotExchange>(slots);
+    }
+
+    std::span<std::byte> BufferedTexture::acquire() {
+        ABY_ASSERT(m_Exchange, "BufferedTexture is not streaming");
+        ABY_ASSERT(m_Writing == util::SlotExchange::NONE, "The acquired slot was not published");
+        m_Writing = m_Exchange->acquire();
+        if (m_Writing == util::SlotExchange::NONE) {
+            m_Starved.fetch_add(1, std::memory_order_relaxed);
+            return {};
+        }
+        return m_Slots[m_Writing]->span();
+    }
+
+    void BufferedTexture::publish() {
+        ABY_ASSERT(m_Writing != util::SlotExchange::NONE, "No slot was acquired");
+        m_Exchange->publish(std::exchange(m_Writing, util::SlotExchange::NONE));
+    }
+
+    bool BufferedTexture::sync() {
+        ABY_ASSERT(m_Exchange, "BufferedTexture is not streaming");
+        // The upload ring drops its reference once the frame that copied from a slot has completed.
+        std::erase_if(m_InFlight, [this](u32 slot) {
+            if (m_Slots[slot].use_count() > 1) return false;
+            m_Exchange->release(slot);
+            return true;
+        });
+
+        u32 slot = m_Exchange->take();
+        if (slot == util::SlotExchange::NONE) return false;
+
+        // The next image was last sampled a full rotation ago, the ring orders the copy after those reads.
+        m_Idx = (m_Idx + 1) % m_Texs.size();
+        PerTex& target = m_Texs[m_Idx];
+        ImageUpload upload{ .image = target.img, .extent = target.size, .texel = channels(), .layout = target.layout };
+        m_Ctx->uploads().stage(upload, m_Slots[slot]);
+        target.layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+        m_InFlight.push_back(slot);
+        m_Presented++;
+        m_Bytes += m_Slots[slot]->size();
+        return true;
+    }
+
+    StreamStats BufferedTexture::stream_stats() const {
+        return StreamStats{
+            .published = m_Exchange ? m_Exchange->published() : 0,
+            .presented = m_Presented,
+            .dropped   = m_Exchange ? m_Exchange->dropped() : 0,
+            .starved   = m_Starved.load(std::memory_order_relaxed),
+            .bytes     = m_Bytes,
+        };
+    }
+
     void BufferedTexture::init(PerTex& buffer) {
         VkDevice device = m_Ctx->devices().logical();
 
@@ -545,6 +826,7 @@ namespace aby::vk {
 
     void BufferedTexture::destroy(PerTex& buffer) {
         VkDevice device = m_Ctx->devices().logical();
+        if (buffer.img)  m_Ctx->uploads().cancel(buffer.img);
         if (buffer.view) vkDestroyImageView(device, buffer.view, nullptr);
         if (buffer.img)  vkDestroyImage(device, buffer.img, nullptr);
         if (buffer.mem)  vkFreeMemory(device, buffer.mem, nullptr);
@@ -553,6 +835,14 @@ namespace aby::vk {
     void BufferedTexture::upload(PerTex& buffer, const void* src_data) {
         auto device = m_Ctx->devices().logical();
         const VkDeviceSize size_bytes = buffer.size.x * buffer.size.y * channels();
+
+        ImageUpload queued{ .image = buffer.img, .extent = buffer.size, .texel = channels(), .layout = buffer.layout };
+        if (m_Ctx->uploads().write(queued, src_data, size_bytes)) {
+            buffer.layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            write_descriptor(buffer);
+            return;
+        }
+
         vk::Buffer staging(src_data, size_bytes, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, m_Ctx->devices());
 
         Ref<CmdPool> cmd_pool = m_Ctx->devices().create_cmd_pool();
@@ -591,7 +881,10 @@ namespace aby::vk {
         );
 
         staging.destroy();
+        write_descriptor(buffer);
+    }
 
+    void BufferedTexture::write_descriptor(PerTex& buffer) {
         if (buffer.set == VK_NULL_HANDLE) {
             VkDescriptorSetAllocateInfo alloc_info{
               .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
@@ -606,7 +899,7 @@ namespace aby::vk {
         VkDescriptorImageInfo img_info{
             .sampler     = m_Sampler,
             .imageView   = buffer.view,
-            .imageLayout = buffer.layout,
+            .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
         };
         
         VkWriteDescriptorSet write{
@@ -0,0 +1,215 @@
+#include "Platform/vk/VkUploadRing.h"
+#include "Platform/vk/VkDeviceManager.h"
+#include "Rendering/MipChain.h"
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+namespace aby::vk {
+
+    static VkBufferImageCopy image_copy(VkDeviceSize offset, const TextureRegion& region, u32 level = 0) {
+        return VkBufferImageCopy{
+            .bufferOffset      = offset,
+            .bufferRowLength   = 0, // Tightly packed
+            .bufferImageHeight = 0,
+            .imageSubresource  = { .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .mipLevel = level, .baseArrayLayer = 0, .layerCount = 1 },
+            .imageOffset       = { static_cast<i32>(region.offset.x), static_cast<i32>(region.offset.y), 0 },
+            .imageExtent       = { region.extent.x, region.extent.y, 1 },
+        };
+    }
+
+    static VkDeviceSize copy_alignment(u32 texel) {
+        // Copy offsets must be a multiple of the texel size, 16 keeps them friendly to the transfer engine as well.
+        return std::lcm<VkDeviceSize>(std::max<u32>(texel, 1), 16);
+    }
+
+    UploadRing::UploadRing() :
+        m_Logical(VK_NULL_HANDLE),
+        m_Buffer(nullptr),
+        m_Head(0),
+        m_Tail(0),
+        m_Pending{},
+        m_Detached{},
+        m_InFlight{}
+    {
+
+    }
+
+    void UploadRing::create(DeviceManager& devices, VkDeviceSize bytes) {
+        m_Logical = devices.logical();
+        m_Buffer  = create_unique<StagingBuffer>(bytes, devices);
+        m_Head    = 0;
+        m_Tail    = 0;
+    }
+
+    void UploadRing::destroy() {
+        if (!m_Buffer) return;
+        vkDeviceWaitIdle(m_Logical);
+        m_Pending.clear();
+        m_Detached.clear();
+        m_InFlight.clear();
+        m_Buffer.reset();
+    }
+
+    bool UploadRing::write(const ImageUpload& upload, const void* data, VkDeviceSize bytes) {
+        auto offset = allocate(bytes, copy_alignment(upload.texel));
+        if (!offset) return false;
+
+        std::memcpy(m_Buffer->span().data() + *offset, data, bytes);
+        std::vector<VkBufferImageCopy> copies = { image_copy(*offset, TextureRegion{ .offset = { 0, 0 }, .extent = upload.extent }) };
+        m_Pending.emplace_back(upload, *m_Buffer, std::move(copies), nullptr);
+        return true;
+    }
+
+    bool UploadRing::write_regions(const ImageUpload& upload, std::span<const std::byte> pixels, std::span<const TextureRegion> regions) {
+        ABY_ASSERT(upload.block == util::EBlockFormat::NONE, "Regions of block compressed images are not supported");
+        VkDeviceSize align = copy_alignment(upload.texel);
+        VkDeviceSize bytes = 0;
+        for (auto& region : regions) {
+            bytes = (bytes + align - 1) / align * align + region.area() * upload.texel;
+        }
+        auto base = allocate(bytes, align);
+        if (!base) return false;
+
+        std::vector<VkBufferImageCopy> copies;
+        copies.reserve(regions.size());
+        std::byte*   dst    = m_Buffer->span().data();
+        VkDeviceSize offset = *base;
+        for (auto& region : regions) {
+            offset = (offset + align - 1) / align * align;
+            copies.push_back(image_copy(offset, region));
+
+            std::size_t row = static_cast<std::size_t>(region.extent.x) * upload.texel;
+            for (u32 y = 0; y < region.extent.y; y++) {
+                std::size_t src = (static_cast<std::size_t>(region.offset.y + y) * upload.extent.x + region.offset.x) * upload.texel;
+                std::memcpy(dst + offset, pixels.data() + src, row);
+                offset += row;
+            }
+        }
+        m_Pending.emplace_back(upload, *m_Buffer, std::move(copies), nullptr);
+        return true;
+    }
+
+    void UploadRing::stage(const ImageUpload& upload, Ref<StagingBuffer> staging) {
+        VkBuffer                       buffer = *staging;
+        std::vector<VkBufferImageCopy> copies;
+        MipChain                       chain = upload.block == util::EBlockFormat::NONE ?
+            MipChain(upload.extent, upload.texel, upload.levels) :
+            MipChain(upload.extent, upload.block, upload.levels);
+        copies.reserve(chain.levels());
+        for (u32 i = 0; i < chain.levels(); i++) {
+            auto& level = chain.level(i);
+            copies.push_back(image_copy(level.offset, TextureRegion{ .offset = { 0, 0 }, .extent = level.size }, i));
+        }
+        m_Pending.emplace_back(upload, buffer, std::move(copies), std::move(staging));
+    }
+
+    void UploadRing::cancel(VkImage image) {
+        std::erase_if(m_Pending, [image](const Pending& pending) {
+            return pending.upload.image == image;
+        });
+    }
+
+    void UploadRing::flush(VkCommandBuffer cmd, u32 frame) {
+        u64 flushed = m_InFlight.empty() ? m_Tail : m_InFlight.back().end;
+        if (m_Pending.empty() && m_Detached.empty() && flushed == m_Head) return;
+
+        InFlight flight{ .frame = frame, .end = m_Head, .done = false, .staging = std::move(m_Detached) };
+        for (auto& pending : m_Pending) {
+            record(cmd, pending);
+            if (pending.staging) {
+                flight.staging.push_back(std::move(pending.staging));
+            }
+        }
+        m_Pending.clear();
+        m_Detached.clear();
+        m_InFlight.push_back(std::move(flight));
+    }
+
+    void UploadRing::flush(VkCommandBuffer cmd, VkImage image) {
+        for (auto& pending : m_Pending) {
+            if (pending.upload.image != image) continue;
+            record(cmd, pending);
+            // The ring bytes stay owned until the next frame is flushed, which covers everything written so far.
+            if (pending.staging) {
+                m_Detached.push_back(std::move(pending.staging));
+            }
+        }
+        cancel(image);
+    }
+
+    void UploadRing::record(VkCommandBuffer cmd, const Pending& pending) {
+        auto& upload  = pending.upload;
+        bool  sampled = upload.layout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        helper::transition_image_layout(
+            cmd,
+            upload.image,
+            upload.layout,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            sampled ? VK_ACCESS_SHADER_READ_BIT : 0,
+            VK_ACCESS_TRANSFER_WRITE_BIT,
+            sampled ? VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT
+        );
+        helper::copy_buffer_to_img(cmd, pending.buffer, upload.image, pending.copies);
+        helper::transition_image_layout(
+            cmd,
+            upload.image,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_ACCESS_TRANSFER_WRITE_BIT,
+            VK_ACCESS_SHADER_READ_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT
+        );
+    }
+
+    void UploadRing::retire(u32 frame) {
+        for (auto& flight : m_InFlight) {
+            if (flight.frame == frame) flight.done = true;
+        }
+        // Frames may complete out of order, the ring only advances past the oldest one.
+        while (!m_InFlight.empty() && m_InFlight.front().done) {
+            m_Tail = m_InFlight.front().end;
+            m_InFlight.pop_front();
+        }
+    }
+
+    void UploadRing::retire_all() {
+        for (auto& flight : m_InFlight) {
+            flight.done = true;
+        }
+        while (!m_InFlight.empty()) {
+            m_Tail = m_InFlight.front().end;
+            m_InFlight.pop_front();
+        }
+    }
+
+    std::optional<VkDeviceSize> UploadRing::allocate(VkDeviceSize bytes, VkDeviceSize align) {
+        VkDeviceSize cap = capacity();
+        if (bytes == 0 || bytes > cap) return std::nullopt;
+
+        u64 offset  = m_Head % cap;
+        u64 aligned = (offset + align - 1) / align * align;
+        // An allocation never straddles the end of the buffer, the remainder is skipped.
+        u64 pos = aligned + bytes > cap ? m_Head + (cap - offset) : m_Head + (aligned - offset);
+        if (pos + bytes - m_Tail > cap) {
+            return std::nullopt;
+        }
+        m_Head = pos + bytes;
+        return pos % cap;
+    }
+
+    std::size_t UploadRing::pending() const {
+        return m_Pending.size();
+    }
+
+    VkDeviceSize UploadRing::capacity() const {
+        return m_Buffer ? m_Buffer->size() : 0;
+    }
+
+    VkDeviceSize UploadRing::used() const {
+        return m_Head - m_Tail;
+    }
+
+}
@@ -6,30 +6,69 @@
 
 namespace aby {
 
+    /**
+    * Points textures added to the context at its dirty queue.
+    */
+    class TextureQueueHandler : public IResourceHandler<Texture> {
+    public:
+        TextureQueueHandler(util::MPSCStack<Resource::Handle>* queue) :
+            IResourceHandler(queue)
+        {
+        }
+
+        void on_add(Handle handle, Ref<Texture> texture) override {
+            // A placeholder is bound to every reserved handle, it keeps the handle it was added with.
+            if (texture->m_Queue) return;
+            texture->m_Queue       = std::any_cast<util::MPSCStack<Resource::Handle>*>(m_UserData);
+            texture->m_QueueHandle = handle;
+            // Written before it was added.
+            if (texture->dirty()) {
+                texture->queue_sync();
+            }
+        }
+
+        void on_erase(Handle handle, Ref<Texture> texture) override {
+
+        }
+    };
+
+    /**
+    * Counts the bytes of textures bound to a handle against the residency budgets.
+    */
+    class TextureResidencyHandler : public IResourceHandler<Texture> {
+    public:
+        TextureResidencyHandler(Context* ctx) :
+            IResourceHandler(ctx)
+        {
+        }
+
+        void on_add(Handle handle, Ref<Texture> texture) override {
+            std::any_cast<Context*>(m_UserData)->residency().attach(handle, *texture);
+        }
+
+        void on_erase(Handle handle, Ref<Texture> texture) override {
+            auto* ctx = std::any_cast<Context*>(m_UserData);
+            // Erasing a reserved handle must not uncount the placeholder bound to the others.
+            if (texture == ctx->textures().placeholder()) return;
+            ctx->residency().detach(*texture);
+        }
+    };
+
     Context::Context(App* app, Window* window) :
         m_App(app),
         m_Backend(app->info().backend),
         m_Window(window),
         m_Shaders{},
+        m_DirtyTextures{},
         m_Textures{},
         m_Fonts{},
-        m_LoadThread([this](EResource type) -> Resource::Handle {
-            switch (type) {
-                using enum EResource;
-                case SHADER:
-                    return static_cast<Resource::Handle>(this->shaders().size());
-                case TEXTURE:
-                    return static_cast<Resource::Handle>(this->textures().size());
-                case FONT:
-                    return static_cast<Resource::Handle>(this->fonts().size());
-                case MAX_ENUM:
-                case NONE:
-                default:
-                    throw std::runtime_error("Resource must have a type");
-            }
-        })
+        m_LoadPool(),
+        m_Residency(this, app->info().texture_cpu_budget, app->info().texture_gpu_budget),
+        m_Streamer(this, app->info().texture_stream_budget),
+        m_Atlas(this)
     {
-
+        m_Textures.add_handler(create_unique<TextureQueueHandler>(&m_DirtyTextures));
+        m_Textures.add_handler(create_unique<TextureResidencyHandler>(this));
     }
 
     Ref<Context> Context::create(App* app, Window* window) {
@@ -77,12 +116,62 @@ namespace aby {
         return m_Fonts;
     }
     
-    util::LoadThread& Context::load_thread() {
-        return m_LoadThread;
+    util::LoadPool& Context::load_pool() {
+        return m_LoadPool;
     }
     
-    const util::LoadThread& Context::load_thread() const {
-        return m_LoadThread;
+    const util::LoadPool& Context::load_pool() const {
+        return m_LoadPool;
+    }
+
+    std::vector<ResourceStats> Context::resource_stats() const {
+        return {
+            m_Textures.stats("Textures"),
+            m_Fonts.stats("Fonts"),
+            m_Shaders.stats("Shaders"),
+        };
+    }
+
+    util::FileError Context::export_resource_stats(const fs::path& file) const {
+        if (file.has_parent_path() && !fs::exists(file.parent_path())) {
+            fs::create_directories(file.parent_path());
+        }
+        return util::File(file).write(to_json(resource_stats()));
+    }
+
+    std::size_t Context::sync_textures() {
+        return m_DirtyTextures.drain([this](Resource::Handle handle) {
+            Resource resource(EResource::TEXTURE, handle);
+            // Erased since it was written.
+            if (!m_Textures.contains(resource)) return;
+            auto tex = m_Textures.at(resource);
+            tex->m_Queued.store(false, std::memory_order_release);
+            tex->sync();
+        });
+    }
+
+    TextureResidency& Context::residency() {
+        return m_Residency;
+    }
+
+    const TextureResidency& Context::residency() const {
+        return m_Residency;
+    }
+
+    TextureStreamer& Context::streamer() {
+        return m_Streamer;
+    }
+
+    const TextureStreamer& Context::streamer() const {
+        return m_Streamer;
+    }
+
+    TextureAtlas& Context::atlas() {
+        return m_Atlas;
+    }
+
+    const TextureAtlas& Context::atlas() const {
+        return m_Atlas;
     }
 
 }
\ No newline at end of file
@@ -4,10 +4,11 @@
 namespace aby {
 
     void Dockspace::on_create(App* app, bool deserialized) {
-		auto path	     = app->bin() / "Textures";
-        m_Icons.minimize = Texture::create(&app->ctx(), path / "MinimizeIcon.png");
-		m_Icons.maximize = Texture::create(&app->ctx(), path / "MaximizeIcon.png");
-		m_Icons.exit     = Texture::create(&app->ctx(), path / "ExitIcon.png");
+		auto  path       = app->bin() / "Textures";
+		auto& atlas      = app->ctx().atlas();
+		m_Icons.minimize = atlas.add(path / "MinimizeIcon.png");
+		m_Icons.maximize = atlas.add(path / "MaximizeIcon.png");
+		m_Icons.exit     = atlas.add(path / "ExitIcon.png");
     }
    
     void Dockspace::on_event(App* app, Event& event) {
@@ -112,22 +113,28 @@ namespace aby {
 		auto  button_size = ImVec2(button_dim, button_dim);
 		float right_edge  = ImGui::GetWindowContentRegionMax().x;
 		auto& textures    = app->ctx().textures();
-		auto  minimize    = textures.at(m_Icons.minimize);
-		auto  maximize    = textures.at(m_Icons.maximize);
-		auto  exit        = textures.at(m_Icons.exit);
-
+		auto& atlas       = app->ctx().atlas();
+		// Icons that failed to load keep an empty button.
+		auto  icon_button = [&](const char* name, const std::optional<TextureAtlas::Sprite>& sprite) {
+			if (!sprite) {
+				return ImGui::Button(name, button_size);
+			}
+			auto region = atlas.region(*sprite);
+			auto page   = textures.at(region.texture);
+			return ImGui::ImageButton(name, page->imgui_id(), button_size, region.uv0(), region.uv1());
+		};
 
 		ImGui::SetCursorPosX(right_edge - bttn_width - padding);
 		ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(0, 0));
-		if (ImGui::ImageButton("Minimize", minimize->imgui_id(), button_size)) {
+		if (icon_button("Minimize", m_Icons.minimize)) {
 			app->window()->set_minimized(true);
 		}
 		ImGui::SameLine(0.0f);
-		if (ImGui::ImageButton("Maximize", maximize->imgui_id(), button_size)) {
+		if (icon_button("Maximize", m_Icons.maximize)) {
 			app->window()->set_maximized(!app->window()->is_maximized());
 		}
 		ImGui::SameLine(0.0f);
-		if (ImGui::ImageButton("Exit", exit->imgui_id(), button_size)) {
+		if (icon_button("Exit", m_Icons.exit)) {
 			app->quit();
 		}
 		ImGui::PopStyleVar();
@@ -4,31 +4,63 @@
 #include <stb_image/stb_image_write.h>
 #include <FT/abyft.h>
 #include <imgui/imgui.h>
+#include <mutex>
+#include <optional>
 
 namespace aby {
 
+    // ft::Library::get() is one FT_Library for the process and create_font_data opens the face and
+    // rasterizes in a single call, so the lock covers both and fonts rasterize one at a time.
+    // Narrowing it to face creation, or a library per loading thread, needs AbyssFreetype to split the call.
+    static std::mutex s_LibraryMutex;
+
     Resource Font::create(Context* ctx, const fs::path& path, u32 pt) {
-        return ctx->load_thread().add_task(EResource::FONT, [ctx, path, pt]() {
+        glm::vec2 dpi   = ctx->window()->dpi();
+        fs::path  cache = ctx->app()->cache();
+        Resource  font  = ctx->fonts().reserve();
+        Resource  atlas = ctx->textures().reserve();
+
+        struct State {
+            std::optional<ft::FontData> data;
+            float                       raster_ms = 0.f;
+        };
+        auto  state = create_ref<State>();
+        auto  name  = path.filename().string();
+        auto& pool  = ctx->load_pool();
+
+        auto raster = pool.add_node(name + ": rasterize", util::ELoadAffinity::WORKER, [state, path, pt, dpi, cache]() {
+            std::lock_guard lock(s_LibraryMutex);
             Timer timer;
-            auto font = CreateRefEnabler<Font>::create(ctx, path, ctx->window()->dpi(), pt);
-            ABY_LOG("Loaded Font: {}ms", timer.elapsed().milli());
-            ABY_LOG("  Name: \"{}\"", font->name());
-            ABY_LOG("  Size:  {}pt", font->size());
-            return ctx->fonts().add(font);
+            state->data.emplace(ft::Library::get().create_font_data(cache, ft::FontCfg{
+                .pt      = pt,
+                .dpi     = { dpi.x, dpi.y },
+                .range   = ft::CharRange(32, 128),
+                .path    = path,
+                .verbose = true,
+            }));
+            state->raster_ms = timer.elapsed().milli();
         });
+
+        // The atlas png only exists once rasterization wrote it to the cache.
+        auto texture = Texture::load(ctx, atlas, name + " atlas", [state]() { return state->data->png; }, { raster });
+
+        pool.add_node(name + ": publish", util::ELoadAffinity::MAIN, [ctx, font, atlas, pt, state]() {
+            Timer timer;
+            auto loaded = CreateRefEnabler<Font>::create(std::move(*state->data), atlas, pt);
+            ctx->fonts().load_stats().record(state->raster_ms, timer.elapsed().milli());
+            ABY_LOG("Loaded Font: {}ms", state->raster_ms);
+            ABY_LOG("  Name: \"{}\"", loaded->name());
+            ABY_LOG("  Size:  {}pt", loaded->size());
+            ctx->fonts().replace(font, loaded);
+        }, { texture });
+        return font;
     }
 
-    Font::Font(Context* ctx, const fs::path& path, const glm::vec2& dpi, u32 pt) :
+    Font::Font(ft::FontData&& data, Resource texture, u32 pt) :
         m_SizePt(pt),
-        m_Data(ft::Library::get().create_font_data(ctx->app()->cache(), ft::FontCfg{
-            .pt      = pt, 
-            .dpi     = { dpi.x, dpi.y }, 
-            .range   = ft::CharRange(32, 128),
-            .path    = path,
-            .verbose = true,
-        }))
+        m_Data(std::move(data)),
+        m_Texture(texture)
     {
-        m_Texture            = Texture::create(ctx, m_Data.png);
     }
 
     Font::~Font() {
@@ -64,6 +96,14 @@ namespace aby {
     }
 
 
+    u64 Font::bytes() const {
+        return m_Data.glyphs.size() * sizeof(ft::Glyphs::value_type) + m_Data.name.size();
+    }
+
+    u64 Font::device_bytes() const {
+        return 0;
+    }
+
     glm::vec2 Font::measure(const std::string& text) const {
         glm::vec2 size(0, m_Data.text_height);
         if (m_Data.is_mono) {
@@ -0,0 +1,93 @@
+#include "Rendering/ImageCache.h"
+#include "Core/Log.h"
+#include "Utility/ArchiveFormat.h"
+#include "Utility/File.h"
+#include <stb_image/stb_image.h>
+#include <array>
+#include <cstring>
+#include <format>
+
+namespace aby {
+
+    /**
+    * Header of a cached image, followed by its tightly packed pixels.
+    */
+    struct ImageCacheHeader {
+        std::array<char, 8> magic;
+        u32                 version;
+        u32                 decoder;
+        u32                 width;
+        u32                 height;
+        u32                 channels;
+        u32                 reserved;
+    };
+    static constexpr std::array<char, 8> IMAGE_CACHE_MAGIC   = { 'A', 'B', 'Y', 'I', 'M', 'A', 'G', 'E' };
+    static constexpr u32                 IMAGE_CACHE_VERSION = 1;
+    static constexpr u32                 DECODER_VERSION     = STBI_VERSION;
+
+    ImageCache::ImageCache(const fs::path& dir) :
+        m_Dir(dir)
+    {
+
+    }
+
+    u64 ImageCache::key(std::string_view encoded) {
+        return util::fnv1a_64(std::format("{:016x}|{}|{}", util::fnv1a_64(encoded), IMAGE_CACHE_VERSION, DECODER_VERSION));
+    }
+
+    std::optional<ImageCache::Entry> ImageCache::find(u64 key) const {
+        fs::path file = path(key);
+        std::error_code ec;
+        if (!fs::exists(file, ec)) return std::nullopt;
+
+        Entry entry{ .file = util::MappedFile(file) };
+        if (!entry.file) return std::nullopt;
+        auto view = entry.file.view();
+        if (view.size() < sizeof(ImageCacheHeader)) return std::nullopt;
+
+        ImageCacheHeader header;
+        std::memcpy(&header, view.data(), sizeof(header));
+        std::size_t bytes = static_cast<std::size_t>(header.width) * header.height * header.channels;
+        if (header.magic != IMAGE_CACHE_MAGIC || header.version != IMAGE_CACHE_VERSION || header.decoder != DECODER_VERSION ||
+            header.channels < 1 || header.channels > 4 || view.size() != sizeof(header) + bytes)
+        {
+            return std::nullopt;
+        }
+
+        entry.size     = { header.width, header.height };
+        entry.channels = header.channels;
+        entry.pixels   = { reinterpret_cast<const std::byte*>(view.data()) + sizeof(header), bytes };
+        return entry;
+    }
+
+    bool ImageCache::store(u64 key, const glm::u32vec2& size, u32 channels, std::span<const std::byte> pixels) const {
+        std::size_t bytes = static_cast<std::size_t>(size.x) * size.y * channels;
+        ABY_ASSERT(pixels.size() >= bytes, "Pixels are smaller than the image");
+
+        ImageCacheHeader header{
+            .magic    = IMAGE_CACHE_MAGIC,
+            .version  = IMAGE_CACHE_VERSION,
+            .decoder  = DECODER_VERSION,
+            .width    = size.x,
+            .height   = size.y,
+            .channels = channels,
+            .reserved = 0,
+        };
+
+        fs::path file = path(key);
+        if (auto err = util::File(file).write_atomic({ std::as_bytes(std::span(&header, 1)), pixels.first(bytes) }); !err.empty()) {
+            ABY_WARN("Failed to cache image: {}", err);
+            return false;
+        }
+        return true;
+    }
+
+    const fs::path& ImageCache::dir() const {
+        return m_Dir;
+    }
+
+    fs::path ImageCache::path(u64 key) const {
+        return m_Dir / std::format("{:016x}.img", key);
+    }
+
+}
@@ -0,0 +1,211 @@
+#include "Rendering/MipChain.h"
+#include "Core/Log.h"
+#include "Utility/File.h"
+#include "Utility/Thread.h"
+#include <stb_image/stb_image_resize2.h>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <numeric>
+
+namespace aby {
+
+    /**
+    * Header of a cached mip chain, followed by the levels after level 0 as laid out by MipChain.
+    */
+    struct MipCacheHeader {
+        std::array<char, 8> magic;
+        u32                 version;
+        u32                 width;
+        u32                 height;
+        u32                 channels;
+        u32                 levels;
+        u32                 reserved;
+    };
+    static constexpr std::array<char, 8> MIP_CACHE_MAGIC   = { 'A', 'B', 'Y', 'M', 'I', 'P', 'S', '\0' };
+    static constexpr u32                 MIP_CACHE_VERSION = 1;
+
+    // Levels smaller than this are not worth waking the loading threads for.
+    static constexpr std::size_t MIN_SPLIT_BYTES = 64 * 1024;
+
+    static stbir_pixel_layout pixel_layout(ETextureFormat format) {
+        switch (format) {
+            case ETextureFormat::R:    return STBIR_1CHANNEL;
+            case ETextureFormat::RG:   return STBIR_2CHANNEL;
+            case ETextureFormat::RGB:  return STBIR_RGB;
+            case ETextureFormat::RGBA: return STBIR_RGBA;
+            case ETextureFormat::BGRA: return STBIR_BGRA;
+            default:
+                ABY_ASSERT(false, "Unsupported texture format");
+                break;
+        }
+        return STBIR_RGBA;
+    }
+
+    static std::size_t texel_bytes(ETextureFormat format) {
+        switch (format) {
+            case ETextureFormat::R:   return 1;
+            case ETextureFormat::RG:  return 2;
+            case ETextureFormat::RGB: return 3;
+            default:                  return 4;
+        }
+    }
+
+    MipChain::MipChain(const glm::u32vec2& size, u32 channels, u32 levels) :
+        MipChain(size, channels, util::EBlockFormat::NONE, levels)
+    {
+
+    }
+
+    MipChain::MipChain(const glm::u32vec2& size, util::EBlockFormat format, u32 levels) :
+        MipChain(size, 4, format, levels)
+    {
+
+    }
+
+    MipChain::MipChain(const glm::u32vec2& size, u32 channels, util::EBlockFormat format, u32 levels) :
+        m_Channels(channels),
+        m_Block(format),
+        m_Levels{},
+        m_Bytes(0)
+    {
+        ABY_ASSERT(size.x > 0 && size.y > 0, "Mip chain of an empty image");
+        u32 full = full_levels(size);
+        levels   = levels == 0 ? full : std::min(levels, full);
+
+        bool        blocks = format != util::EBlockFormat::NONE;
+        std::size_t align  = std::lcm<std::size_t>(blocks ? util::block_bytes(format) : std::max<u32>(channels, 1), 16);
+        glm::u32vec2 dim   = size;
+        m_Levels.reserve(levels);
+        for (u32 i = 0; i < levels; i++) {
+            std::size_t bytes = blocks ? util::block_image_bytes(format, dim.x, dim.y) : static_cast<std::size_t>(dim.x) * dim.y * channels;
+            m_Bytes = (m_Bytes + align - 1) / align * align;
+            m_Levels.emplace_back(dim, m_Bytes, bytes);
+            m_Bytes += bytes;
+            dim      = glm::max(dim / 2u, glm::u32vec2(1));
+        }
+    }
+
+    u32 MipChain::full_levels(const glm::u32vec2& size) {
+        return std::bit_width(std::max(size.x, size.y));
+    }
+
+    void MipChain::generate(std::span<std::byte> pixels, ETextureFormat format, util::LoadPool* pool) const {
+        ABY_ASSERT(pixels.size() >= m_Bytes, "Buffer is smaller than the mip chain");
+        ABY_ASSERT(m_Block == util::EBlockFormat::NONE, "Block compressed mip chains can not be generated");
+        auto        layout  = pixel_layout(format);
+        std::size_t threads = pool ? pool->threads() + 1 : 1;
+        for (std::size_t i = 1; i < m_Levels.size(); i++) {
+            const MipLevel& src = m_Levels[i - 1];
+            const MipLevel& dst = m_Levels[i];
+
+            STBIR_RESIZE resize;
+            stbir_resize_init(
+                &resize,
+                pixels.data() + src.offset, static_cast<int>(src.size.x), static_cast<int>(src.size.y), 0,
+                pixels.data() + dst.offset, static_cast<int>(dst.size.x), static_cast<int>(dst.size.y), 0,
+                layout, STBIR_TYPE_UINT8_SRGB
+            );
+            // A box filter at a 2:1 ratio averages each 2x2 block, the classic mip filter.
+            stbir_set_filters(&resize, STBIR_FILTER_BOX, STBIR_FILTER_BOX);
+
+            int want   = static_cast<int>(std::clamp<std::size_t>(dst.bytes / MIN_SPLIT_BYTES, 1, threads));
+            int splits = stbir_build_samplers_with_splits(&resize, want);
+            ABY_ASSERT(splits > 0, "Failed to build mip level {} samplers", i);
+            if (pool && splits > 1) {
+                pool->parallel_for(static_cast<std::size_t>(splits), [&resize](std::size_t split) {
+                    stbir_resize_extended_split(&resize, static_cast<int>(split), 1);
+                });
+            }
+            else {
+                stbir_resize_extended_split(&resize, 0, splits);
+            }
+            stbir_free_samplers(&resize);
+        }
+    }
+
+    bool MipChain::load(const fs::path& file, std::span<std::byte> pixels) const {
+        if (m_Levels.size() < 2 || !fs::exists(file)) return false;
+        ABY_ASSERT(pixels.size() >= m_Bytes, "Buffer is smaller than the mip chain");
+
+        util::MappedFile mapped(file);
+        if (!mapped) return false;
+        auto        view  = mapped.view();
+        std::size_t begin = m_Levels[1].offset;
+        if (view.size() != sizeof(MipCacheHeader) + m_Bytes - begin) return false;
+
+        MipCacheHeader header;
+        std::memcpy(&header, view.data(), sizeof(header));
+        if (header.magic != MIP_CACHE_MAGIC || header.version != MIP_CACHE_VERSION ||
+            header.width != m_Levels[0].size.x || header.height != m_Levels[0].size.y ||
+            header.channels != m_Channels || header.levels != m_Levels.size())
+        {
+            return false;
+        }
+        std::memcpy(pixels.data() + begin, view.data() + sizeof(header), m_Bytes - begin);
+        return true;
+    }
+
+    bool MipChain::save(const fs::path& file, std::span<const std::byte> pixels) const {
+        if (m_Levels.size() < 2) return false;
+        ABY_ASSERT(pixels.size() >= m_Bytes, "Buffer is smaller than the mip chain");
+
+        MipCacheHeader header{
+            .magic    = MIP_CACHE_MAGIC,
+            .version  = MIP_CACHE_VERSION,
+            .width    = m_Levels[0].size.x,
+            .height   = m_Levels[0].size.y,
+            .channels = m_Channels,
+            .levels   = static_cast<u32>(m_Levels.size()),
+            .reserved = 0,
+        };
+        std::size_t begin = m_Levels[1].offset;
+
+        auto levels = pixels.subspan(begin, m_Bytes - begin);
+        if (auto err = util::File(file).write_atomic({ std::as_bytes(std::span(&header, 1)), levels }); !err.empty()) {
+            ABY_WARN("Failed to cache mip chain: {}", err);
+            return false;
+        }
+        return true;
+    }
+
+    u32 MipChain::levels() const {
+        return static_cast<u32>(m_Levels.size());
+    }
+
+    u32 MipChain::channels() const {
+        return m_Channels;
+    }
+
+    util::EBlockFormat MipChain::block() const {
+        return m_Block;
+    }
+
+    const MipLevel& MipChain::level(u32 index) const {
+        ABY_ASSERT(index < m_Levels.size(), "Mip level {} out of range", index);
+        return m_Levels[index];
+    }
+
+    std::span<const MipLevel> MipChain::all() const {
+        return m_Levels;
+    }
+
+    std::size_t MipChain::bytes() const {
+        return m_Bytes;
+    }
+
+    void downsample(std::span<const std::byte> src, const glm::u32vec2& src_size, std::span<std::byte> dst, const glm::u32vec2& dst_size, ETextureFormat format) {
+        std::size_t channels = texel_bytes(format);
+        ABY_ASSERT(src.size() >= static_cast<std::size_t>(src_size.x) * src_size.y * channels, "Source is smaller than its size");
+        ABY_ASSERT(dst.size() >= static_cast<std::size_t>(dst_size.x) * dst_size.y * channels, "Destination is smaller than its size");
+        // The box filter widens with the ratio, so every source texel contributes.
+        void* out = stbir_resize(
+            src.data(), static_cast<int>(src_size.x), static_cast<int>(src_size.y), 0,
+            dst.data(), static_cast<int>(dst_size.x), static_cast<int>(dst_size.y), 0,
+            pixel_layout(format), STBIR_TYPE_UINT8_SRGB, STBIR_EDGE_CLAMP, STBIR_FILTER_BOX
+        );
+        ABY_ASSERT(out, "Failed to downsample image");
+    }
+
+}
@@ -0,0 +1,123 @@
+#include "Rendering/RenderQueue.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+
+namespace aby {
+
+    static constexpr u32 NO_PIPELINE  = UINT32_MAX;
+    static constexpr u32 MAX_SEQUENCE = (1u << 23) - 1;
+
+    /**
+    * Bits of a float that compare as unsigned integers in the order of the floats.
+    */
+    static u32 depth_bits(float depth) {
+        u32 bits = std::bit_cast<u32>(depth);
+        return (bits & 0x8000'0000u) ? ~bits : (bits | 0x8000'0000u);
+    }
+
+    RenderQueue::RenderQueue(std::vector<u32> pipelines) :
+        m_Pipelines(std::move(pipelines)),
+        m_Packets{},
+        m_Scratch{},
+        m_Stats{},
+        m_UnsortedBinds(0),
+        m_Sequence(0),
+        m_LastPipeline(NO_PIPELINE)
+    {
+
+    }
+
+    u64 RenderQueue::make_key(const DrawOrder& order, u32 sequence) {
+        u64 key = (static_cast<u64>(order.layer) << 56) | (static_cast<u64>(order.blend) << 55);
+        key |= (~static_cast<u64>(depth_bits(order.depth)) & 0xFFFF'FFFFull) << 23;
+        key |= std::min(sequence, MAX_SEQUENCE);
+        return key;
+    }
+
+    void RenderQueue::push(const DrawOrder& order, u32 stream, u32 batch, u32 first, u32 count) {
+        ABY_ASSERT(stream < m_Pipelines.size(), "Unknown stream", stream);
+        m_Packets.push_back({ make_key(order, m_Sequence++), stream, batch, first, count });
+        if (u32 pipeline = m_Pipelines[stream]; pipeline != m_LastPipeline) {
+            m_UnsortedBinds++;
+            m_LastPipeline = pipeline;
+        }
+    }
+
+    void RenderQueue::clear() {
+        m_Packets.clear();
+        m_UnsortedBinds = 0;
+        m_Sequence      = 0;
+        m_LastPipeline  = NO_PIPELINE;
+    }
+
+    std::span<const DrawPacket> RenderQueue::sort() {
+        RenderQueueStats stats{ .packets = m_Packets.size(), .unsorted_binds = m_UnsortedBinds };
+
+        // LSD radix sort on the key bytes, all histograms are built in one pass and
+        // bytes every key shares (most of them in a frame) are skipped.
+        std::array<std::array<u32, 256>, 8> histograms{};
+        for (const auto& packet : m_Packets) {
+            for (std::size_t b = 0; b < 8; b++) {
+                histograms[b][(packet.key >> (b * 8)) & 0xFF]++;
+            }
+        }
+        m_Scratch.resize(m_Packets.size());
+        for (std::size_t b = 0; b < 8; b++) {
+            auto& counts = histograms[b];
+            if (m_Packets.empty() || counts[(m_Packets[0].key >> (b * 8)) & 0xFF] == m_Packets.size()) {
+                continue;
+            }
+            u32 offset = 0;
+            for (auto& count : counts) {
+                u32 n = count;
+                count = offset;
+                offset += n;
+            }
+            for (const auto& packet : m_Packets) {
+                m_Scratch[counts[(packet.key >> (b * 8)) & 0xFF]++] = packet;
+            }
+            m_Packets.swap(m_Scratch);
+        }
+
+        // Merge ranges that continue the previous one, e.g. consecutive draws of a stream that end up next to each other.
+        std::size_t merged   = 0;
+        u32         pipeline = NO_PIPELINE;
+        for (std::size_t i = 0; i < m_Packets.size(); i++) {
+            const DrawPacket& packet = m_Packets[i];
+            if (merged > 0) {
+                DrawPacket& last = m_Packets[merged - 1];
+                if (last.stream == packet.stream && last.batch == packet.batch && last.first + last.count == packet.first) {
+                    last.count += packet.count;
+                    continue;
+                }
+            }
+            if (m_Pipelines[packet.stream] != pipeline) {
+                pipeline = m_Pipelines[packet.stream];
+                stats.pipeline_binds++;
+            }
+            m_Packets[merged++] = packet;
+        }
+        m_Packets.resize(merged);
+        stats.draws = merged;
+        m_Stats     = stats;
+        return m_Packets;
+    }
+
+    std::span<const DrawPacket> RenderQueue::packets() const {
+        return m_Packets;
+    }
+
+    const RenderQueueStats& RenderQueue::stats() const {
+        return m_Stats;
+    }
+
+    std::size_t RenderQueue::size() const {
+        return m_Packets.size();
+    }
+
+    bool RenderQueue::empty() const {
+        return m_Packets.empty();
+    }
+
+}
@@ -2,6 +2,7 @@
 #include "Platform/vk/VkShader.h"
 #include "Platform/vk/VkContext.h"
 #include "Core/Log.h"
+#include "Core/Time.h"
 
 
 namespace std {
@@ -32,12 +33,15 @@ namespace aby {
 	Resource Shader::create(Context* ctx, const fs::path& path, EShader type) {
 		switch (ctx->backend()) {
 			case EBackend::VULKAN: {
+				Timer timer;
 				auto shader = vk::Shader::create(
 					ctx->app(),
 					static_cast<vk::Context*>(ctx)->devices(),
 					path,
 					type
 				);
+				// Compilation, reflection and module creation are not timed separately.
+				ctx->shaders().load_stats().record(timer.elapsed().milli(), 0.f);
 				return ctx->shaders().add(shader);
 			}
 			default:
@@ -54,4 +58,12 @@ namespace aby {
 		return std::span(m_Data.begin(), m_Data.size());
 	}
 
+	u64 Shader::bytes() const {
+		return m_Data.size() * sizeof(u32);
+	}
+
+	u64 Shader::device_bytes() const {
+		return 0;
+	}
+
 }
\ No newline at end of file
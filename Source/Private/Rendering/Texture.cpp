@@ -1,10 +1,16 @@
 #include "Rendering/Texture.h"
+#include "Rendering/MipChain.h"
+#include "Rendering/ImageCache.h"
+#include "Rendering/TextureResidency.h"
 #include "Core/Log.h"
 #include "Core/App.h"
 #include "Platform/vk/VkTexture.h"
 #include "Platform/vk/VkContext.h"
 #include <stb_image/stb_image.h>
+#include <stb_target.h>
 #include <array>
+#include <cstring>
+#include <optional>
 
 
 namespace aby {
@@ -15,26 +21,322 @@ namespace aby {
             case 1: return format == ETextureFormat::R;
             case 2: return format == ETextureFormat::RG;
             case 3: return format == ETextureFormat::RGB;
-            case 4: return format == ETextureFormat::RGBA || format == ETextureFormat::BGRA;
+            case 4: return format == ETextureFormat::RGBA || format == ETextureFormat::BGRA || block_format(format) != util::EBlockFormat::NONE;
             default: std::unreachable();
         }
     }
 
-    Resource Texture::create(Context* ctx, const fs::path& path) {
+    util::EBlockFormat block_format(ETextureFormat format) {
+        switch (format) {
+            case ETextureFormat::BC1: return util::EBlockFormat::BC1;
+            case ETextureFormat::BC3: return util::EBlockFormat::BC3;
+            case ETextureFormat::BC7: return util::EBlockFormat::BC7;
+            default:                  return util::EBlockFormat::NONE;
+        }
+    }
+
+    u64 texture_bytes(const glm::u32vec2& size, u32 channels, ETextureFormat format) {
+        auto block = block_format(format);
+        if (block != util::EBlockFormat::NONE) {
+            return util::block_image_bytes(block, size.x, size.y);
+        }
+        return static_cast<u64>(size.x) * size.y * channels;
+    }
+
+    /**
+    * Result of decoding an image file on a loading thread.
+    * Pixels are decoded straight into persistently mapped staging memory the upload copies from,
+    * images found in the asset archive are copied there from the mapping without decoding.
+    */
+    struct DecodedImage {
+        glm::u32vec2           size     = { 0, 0 };
+        u32                    channels = 0;
+        ETextureFormat         format   = ETextureFormat::NONE;
+        Ref<vk::StagingBuffer> staging  = nullptr; /// Every mip level, laid out by MipChain.
+        u32                    levels   = 1;
+        float                  mip_ms   = 0.f;
+        bool                   cached   = false;   /// Mips were read from the cache instead of generated.
+    };
+
+    static bool has_option(ETextureLoad options, ETextureLoad option) {
+        return (options & option) != ETextureLoad::NONE;
+    }
+
+    static ETextureFormat format_from_channels(u32 channels) {
+        switch (channels) {
+            case 1: return ETextureFormat::R;
+            case 2: return ETextureFormat::RG;
+            case 3: return ETextureFormat::RGB;
+            case 4: return ETextureFormat::RGBA;
+            default: return ETextureFormat::NONE;
+        }
+    }
+
+    static ETextureFormat format_from_blocks(util::EBlockFormat format) {
+        switch (format) {
+            case util::EBlockFormat::BC1: return ETextureFormat::BC1;
+            case util::EBlockFormat::BC3: return ETextureFormat::BC3;
+            case util::EBlockFormat::BC7: return ETextureFormat::BC7;
+            default:                      return ETextureFormat::NONE;
+        }
+    }
+
+    static bool supports_blocks(Context* ctx) {
+        switch (ctx->backend()) {
+            case EBackend::VULKAN:
+                return static_cast<vk::Context*>(ctx)->devices().texture_compression_bc();
+            default:
+                return false;
+        }
+    }
+
+    // Longest side of the preview a streamed texture is bound to first.
+    static constexpr u32 PREVIEW_SIZE = 64;
+
+    static Ref<vk::StagingBuffer> create_staging(Context* ctx, std::size_t bytes) {
+        switch (ctx->backend()) {
+            case EBackend::VULKAN:
+                return create_ref<vk::StagingBuffer>(bytes, static_cast<vk::Context*>(ctx)->devices());
+            default:
+                ABY_ASSERT(false, "Unsupported ctx backend");
+                break;
+        }
+        return nullptr;
+    }
+
+    static bool decode_file(Context* ctx, const fs::path& path, u32 levels, std::optional<MipChain>& chain, DecodedImage& out) {
+        util::MappedFile file(path);
+        if (!file) {
+            ABY_ERR("{}", file.error());
+            return false;
+        }
+        std::optional<ImageCache> cache;
+        u64                       key = 0;
+        if (ctx->app()->info().cache_images) {
+            cache.emplace(ctx->app()->cache() / "Images");
+            key = ImageCache::key(file.view());
+            if (auto entry = cache->find(key)) {
+                out.size     = entry->size;
+                out.channels = entry->channels;
+                out.format   = format_from_channels(out.channels);
+                chain.emplace(out.size, out.channels, levels);
+                out.staging  = create_staging(ctx, chain->bytes());
+                std::memcpy(out.staging->span().data(), entry->pixels.data(), entry->pixels.size());
+                return true;
+            }
+        }
+
+        auto encoded = reinterpret_cast<const stbi_uc*>(file.view().data());
+        auto length  = static_cast<int>(file.size());
+
+        int w, h, c;
+        constexpr int LOAD_ALL_CHANNELS = 0;
+        if (!stbi_info_from_memory(encoded, length, &w, &h, &c)) {
+            ABY_ERR("[stbi_image::stbi_info]: {} ({})", stbi_failure_reason(), path);
+            return false;
+        }
+
+        out.size     = { static_cast<u32>(w), static_cast<u32>(h) };
+        out.channels = static_cast<u32>(c);
+        out.format   = format_from_channels(out.channels);
+        chain.emplace(out.size, out.channels, levels);
+
+        std::size_t bytes   = chain->level(0).bytes;
+        auto        staging = create_staging(ctx, chain->bytes());
+        std::byte*  target  = staging->span().data();
+
+        stb::set_decode_target(target, bytes);
+        unsigned char* data = stbi_load_from_memory(encoded, length, &w, &h, &c, LOAD_ALL_CHANNELS);
+        stb::clear_decode_target();
+        if (!data) {
+            ABY_ERR("[stbi_image::stbi_load]: {} ({})", stbi_failure_reason(), path);
+            return false;
+        }
+        // Decoders that finish in an intermediate buffer hand back heap memory instead of the target.
+        if (reinterpret_cast<std::byte*>(data) != target) {
+            std::memcpy(target, data, bytes);
+            stbi_image_free(data);
+        }
+        if (cache) {
+            cache->store(key, out.size, out.channels, staging->span().first(bytes));
+        }
+
+        out.staging = std::move(staging);
+        return true;
+    }
+
+    static fs::path mip_cache_path(Context* ctx, const fs::path& path) {
+        // Keyed by the file and its last write, so an edited file never hits a stale chain.
+        // Images only found in the archive are stamped with the archive instead.
+        std::error_code ec;
+        fs::path stamped = path;
+        if (auto archive = ctx->app()->archive(); archive && !fs::exists(path, ec)) {
+            stamped = archive->path();
+        }
+        auto size = fs::file_size(stamped, ec);
+        auto time = fs::last_write_time(stamped, ec);
+        auto key  = std::format("{}|{}|{}", util::Archive::key(ctx->app()->bin(), path), size, time.time_since_epoch().count());
+        return ctx->app()->cache() / "Mips" / std::format("{:016x}.mips", util::fnv1a_64(key));
+    }
+
+    static void generate_mips(Context* ctx, const fs::path& path, ETextureLoad options, const MipChain& chain, DecodedImage& out) {
+        Timer    timer;
+        auto     pixels = out.staging->span();
+        fs::path cached = has_option(options, ETextureLoad::CACHE_MIPS) ? mip_cache_path(ctx, path) : fs::path{};
+        if (!cached.empty() && chain.load(cached, pixels)) {
+            out.cached = true;
+        }
+        else {
+            chain.generate(pixels, out.format, &ctx->load_pool());
+            if (!cached.empty()) {
+                chain.save(cached, pixels);
+            }
+        }
+        out.levels = chain.levels();
+        out.mip_ms = timer.elapsed().milli();
+    }
+
+    /**
+    * Copy a block compressed archive image to staging memory, the mip chain baked by aby_package is used as is.
+    * Devices without BC support get level 0 decoded to RGBA and their mips generated like any other image.
+    */
+    static bool load_blocks(Context* ctx, const fs::path& path, ETextureLoad options, const util::ArchiveImageView& image, std::optional<MipChain>& chain, DecodedImage& out) {
+        bool mips    = has_option(options, ETextureLoad::MIPS | ETextureLoad::CACHE_MIPS);
+        out.size     = image.size;
+        out.channels = 4;
+        if (supports_blocks(ctx)) {
+            chain.emplace(image.size, image.format, mips ? image.levels : 1);
+            out.format  = format_from_blocks(image.format);
+            out.levels  = chain->levels();
+            out.staging = create_staging(ctx, chain->bytes());
+            std::memcpy(out.staging->span().data(), image.pixels.data(), chain->bytes());
+            return true;
+        }
+
+        chain.emplace(image.size, out.channels, mips ? 0 : 1);
+        out.format  = ETextureFormat::RGBA;
+        out.staging = create_staging(ctx, chain->bytes());
+        auto blocks = image.pixels.first(util::block_image_bytes(image.format, image.size.x, image.size.y));
+        auto rgba   = out.staging->span().first(chain->level(0).bytes);
+        if (!util::decode_image(
+            image.format,
+            { reinterpret_cast<const std::uint8_t*>(blocks.data()), blocks.size() },
+            image.size.x, image.size.y,
+            { reinterpret_cast<std::uint8_t*>(rgba.data()), rgba.size() }))
+        {
+            ABY_ERR("Unsupported block encoding ({})", path);
+            return false;
+        }
+        return true;
+    }
+
+    /**
+    * Level 0 of an image in staging memory sized for its whole chain, copied from the archive or decoded from the file.
+    * Levels of the chain after out.levels are left for generate_mips.
+    */
+    static bool decode_level0(Context* ctx, const fs::path& path, ETextureLoad options, std::optional<MipChain>& chain, DecodedImage& out) {
+        u32 levels = has_option(options, ETextureLoad::MIPS | ETextureLoad::CACHE_MIPS) ? 0 : 1;
+
+        if (auto archive = ctx->app()->archive()) {
+            if (auto image = archive->image(util::Archive::key(ctx->app()->bin(), path))) {
+                if (image->format != util::EBlockFormat::NONE) {
+                    return load_blocks(ctx, path, options, *image, chain, out);
+                }
+                out.size     = image->size;
+                out.channels = image->channels;
+                out.format   = format_from_channels(out.channels);
+                chain.emplace(out.size, out.channels, levels);
+                out.staging  = create_staging(ctx, chain->bytes());
+                std::memcpy(out.staging->span().data(), image->pixels.data(), image->pixels.size());
+                return true;
+            }
+        }
+        return decode_file(ctx, path, levels, chain, out);
+    }
+
+    static bool decode_image(Context* ctx, const fs::path& path, ETextureLoad options, DecodedImage& out) {
+        // Staging memory holds the whole chain, level 0 is decoded into its start.
+        std::optional<MipChain> chain;
+        if (!decode_level0(ctx, path, options, chain, out)) {
+            return false;
+        }
+        if (chain->levels() > out.levels) {
+            generate_mips(ctx, path, options, *chain, out);
+        }
+        return true;
+    }
+
+    /**
+    * Small version of a decoded image a streamed texture is bound to until its full resolution is uploaded.
+    * Block compressed chains use their stored mip tail, other images are box filtered down from level 0.
+    * @return false if the image is not larger than a preview or has no tail to use.
+    */
+    static bool make_preview(Context* ctx, const MipChain& chain, const DecodedImage& image, DecodedImage& out) {
+        auto longest = [](const glm::u32vec2& size) { return std::max(size.x, size.y); };
+        if (longest(image.size) <= PREVIEW_SIZE) return false;
+
+        out.channels = image.channels;
+        out.format   = image.format;
+        if (chain.block() != util::EBlockFormat::NONE) {
+            u32 first = 0;
+            while (first + 1 < image.levels && longest(chain.level(first).size) > PREVIEW_SIZE) first++;
+            const MipLevel& level = chain.level(first);
+            if (longest(level.size) > PREVIEW_SIZE) return false;
+
+            // Levels start at multiples of 16 from the first level on, so the tail keeps its layout.
+            std::size_t bytes = chain.bytes() - level.offset;
+            out.size    = level.size;
+            out.levels  = image.levels - first;
+            out.staging = create_staging(ctx, bytes);
+            std::memcpy(out.staging->span().data(), image.staging->span().data() + level.offset, bytes);
+            return true;
+        }
+
+        float scale = static_cast<float>(PREVIEW_SIZE) / static_cast<float>(longest(image.size));
+        out.size    = glm::max(glm::u32vec2(glm::round(glm::vec2(image.size) * scale)), glm::u32vec2(1));
+        out.levels  = 1;
+        out.staging = create_staging(ctx, MipChain(out.size, out.channels, 1).bytes());
+        downsample(image.staging->span().first(chain.level(0).bytes), image.size, out.staging->span(), out.size, image.format);
+        return true;
+    }
+
+    /**
+    * Create the texture of a decoded image and queue its upload, main thread only.
+    */
+    static Ref<Texture> upload_decoded(Context* ctx, const fs::path& path, DecodedImage& image, ETextureLoad options, float decode_ms) {
+        switch (ctx->backend()) {
+            case EBackend::VULKAN: {
+                Timer timer;
+                auto tex = create_ref<vk::Texture>(static_cast<vk::Context*>(ctx), image.size, std::move(image.staging), image.channels, image.format, image.levels, has_option(options, ETextureLoad::KEEP_DATA));
+                auto upload_ms = timer.elapsed().milli();
+                ctx->textures().load_stats().record(decode_ms, upload_ms);
+                ABY_LOG("Loaded Texture: {}ms", decode_ms + upload_ms);
+                ABY_LOG("  Path:     {}", path);
+                ABY_LOG("  Decode:   {}ms", decode_ms);
+                ABY_LOG("  Upload:   {}ms", upload_ms);
+                if (image.levels > 1) {
+                    ABY_LOG("  Mips:     {} levels, {}ms{}", image.levels, image.mip_ms, image.cached ? " (cached)" : "");
+                }
+                ABY_LOG("  Size:     ({}, {})", EXPAND_VEC2(tex->size()));
+                ABY_LOG("  Channels: {}", tex->channels());
+                ABY_LOG("  Bytes:    {}", tex->device_bytes());
+                image = {};
+                return tex;
+            }
+            default:
+                ABY_ASSERT(false, "Unsupported ctx backend");
+                break;
+        }
+        return nullptr;
+    }
+
+    Resource Texture::create(Context* ctx, const fs::path& path, ETextureLoad options) {
         ABY_ASSERT(ctx, "(aby::Context*)ctx is invalid!");
         switch (ctx->backend()) {
             case EBackend::VULKAN: {
-                return ctx->load_thread().add_task(EResource::TEXTURE, [ctx = ctx, path = path]() {
-                    Timer timer;
-                    auto tex = create_ref<vk::Texture>(static_cast<vk::Context*>(ctx), path);
-                    auto elapsed = timer.elapsed();
-                    ABY_LOG("Loaded Texture: {}ms", elapsed.milli());
-                    ABY_LOG("  Path:     {}", path);
-                    ABY_LOG("  Size:     ({}, {})", EXPAND_VEC2(tex->size()));
-                    ABY_LOG("  Channels: {}", tex->channels());
-                    ABY_LOG("  Bytes:    {}", tex->bytes());
-                    return ctx->textures().add(tex);
-                });
+                Resource texture = ctx->textures().reserve();
+                load(ctx, texture, path.filename().string(), [path]() { return path; }, {}, options);
+                return texture;
             }
             default:
                 ABY_ASSERT(false, "Unsupported ctx backend");
@@ -43,15 +345,179 @@ namespace aby {
         return {};
     }
 
+    util::LoadPool::Node Texture::load(Context* ctx, Resource texture, const std::string& name, std::function<fs::path()> path, const std::vector<util::LoadPool::Node>& deps, ETextureLoad options) {
+        ABY_ASSERT(ctx, "(aby::Context*)ctx is invalid!");
+        if (has_option(options, ETextureLoad::STREAM)) {
+            return stream(ctx, texture, name, std::move(path), deps, options);
+        }
+        struct State {
+            fs::path     path;
+            DecodedImage image;
+            bool         decoded   = false;
+            float        decode_ms = 0.f;
+            Ref<Texture> tex       = nullptr;
+        };
+        auto  state = create_ref<State>();
+        auto& pool  = ctx->load_pool();
+
+        auto decode = pool.add_node(name + ": decode", util::ELoadAffinity::WORKER, [ctx, state, options, path = std::move(path)]() {
+            Timer timer;
+            state->path      = path();
+            state->decoded   = decode_image(ctx, state->path, options, state->image);
+            state->decode_ms = timer.elapsed().milli();
+        }, deps);
+
+        auto upload = pool.add_node(name + ": upload", util::ELoadAffinity::MAIN, [ctx, state, options]() {
+            // A failed decode leaves the handle on the placeholder.
+            if (!state->decoded) return;
+            state->tex = upload_decoded(ctx, state->path, state->image, options, state->decode_ms);
+        }, { decode });
+
+        return pool.add_node(name + ": bind", util::ELoadAffinity::MAIN, [ctx, texture, state, options]() {
+            if (state->tex) {
+                state->tex->m_Source  = std::move(state->path);
+                state->tex->m_Options = options;
+                ctx->textures().replace(texture, std::move(state->tex));
+            }
+        }, { upload });
+    }
+
+    util::LoadPool::Node Texture::stream(Context* ctx, Resource texture, const std::string& name, std::function<fs::path()> path, const std::vector<util::LoadPool::Node>& deps, ETextureLoad options) {
+        struct State {
+            fs::path                path;
+            DecodedImage            image;
+            DecodedImage            preview;
+            std::optional<MipChain> chain;
+            bool                    decoded   = false;
+            bool                    previewed = false;
+            float                   decode_ms = 0.f;
+        };
+        auto  state = create_ref<State>();
+        auto& pool  = ctx->load_pool();
+
+        auto decode = pool.add_node(name + ": decode", util::ELoadAffinity::WORKER, [ctx, state, options, path = std::move(path)]() {
+            Timer timer;
+            state->path      = path();
+            state->decoded   = decode_level0(ctx, state->path, options, state->chain, state->image);
+            state->previewed = state->decoded && make_preview(ctx, *state->chain, state->image, state->preview);
+            state->decode_ms = timer.elapsed().milli();
+        }, deps);
+
+        auto preview = pool.add_node(name + ": preview", util::ELoadAffinity::MAIN, [ctx, texture, state]() {
+            if (!state->previewed) return;
+            switch (ctx->backend()) {
+                case EBackend::VULKAN: {
+                    auto& image = state->preview;
+                    ctx->textures().replace(texture, create_ref<vk::Texture>(static_cast<vk::Context*>(ctx), image.size, std::move(image.staging), image.channels, image.format, image.levels));
+                    image = {};
+                } break;
+                default:
+                    ABY_ASSERT(false, "Unsupported ctx backend");
+                    break;
+            }
+        }, { decode });
+
+        // The mips are generated after the preview is out, they are not needed before the full image is uploaded.
+        auto mips = pool.add_node(name + ": mips", util::ELoadAffinity::WORKER, [ctx, state, options]() {
+            if (state->decoded && state->chain->levels() > state->image.levels) {
+                generate_mips(ctx, state->path, options, *state->chain, state->image);
+            }
+        }, { decode });
+
+        // After the preview, so it never replaces the full image.
+        pool.add_node(name + ": stream", util::ELoadAffinity::MAIN, [ctx, texture, state, options]() {
+            if (!state->decoded) return;
+            u64 bytes = state->image.staging->size();
+            ctx->streamer().enqueue(texture, bytes, [ctx, texture, state, options]() {
+                auto tex = upload_decoded(ctx, state->path, state->image, options, state->decode_ms);
+                if (!tex) return;
+                tex->m_Source  = std::move(state->path);
+                tex->m_Options = options;
+                ctx->textures().replace(texture, std::move(tex));
+            });
+        }, { preview, mips });
+
+        return preview;
+    }
+
+    std::vector<Resource> Texture::create_batch(Context* ctx, std::span<const fs::path> paths, ETextureLoad options) {
+        ABY_ASSERT(ctx, "(aby::Context*)ctx is invalid!");
+        struct Item {
+            Resource     texture;
+            fs::path     path;
+            DecodedImage image;
+            bool         decoded   = false;
+            float        decode_ms = 0.f;
+        };
+        auto  items = create_ref<std::vector<Item>>(paths.size());
+        auto& pool  = ctx->load_pool();
+
+        std::vector<Resource>             textures;
+        std::vector<util::LoadPool::Node> decodes;
+        textures.reserve(paths.size());
+        decodes.reserve(paths.size());
+        for (std::size_t i = 0; i < paths.size(); i++) {
+            auto& item   = (*items)[i];
+            item.texture = ctx->textures().reserve();
+            item.path    = paths[i];
+            textures.push_back(item.texture);
+            decodes.push_back(pool.add_node(item.path.filename().string() + ": decode", util::ELoadAffinity::WORKER, [ctx, items, i, options]() {
+                auto& decoding     = (*items)[i];
+                Timer timer;
+                decoding.decoded   = decode_image(ctx, decoding.path, options, decoding.image);
+                decoding.decode_ms = timer.elapsed().milli();
+            }));
+        }
+
+        pool.add_node(std::format("Batch of {}: upload", paths.size()), util::ELoadAffinity::MAIN, [ctx, items, options]() {
+            switch (ctx->backend()) {
+                case EBackend::VULKAN: {
+                    Timer timer;
+                    std::vector<Ref<vk::Texture>>       created;
+                    std::vector<Ref<vk::StagingBuffer>> staging;
+                    std::vector<Item*>                  owners;
+                    for (auto& item : *items) {
+                        // A failed decode leaves the handle on the placeholder.
+                        if (!item.decoded) continue;
+                        auto& image = item.image;
+                        created.push_back(create_ref<vk::Texture>(static_cast<vk::Context*>(ctx), image.size, image.staging, image.channels, image.format, image.levels, has_option(options, ETextureLoad::KEEP_DATA), false));
+                        staging.push_back(std::move(image.staging));
+                        owners.push_back(&item);
+                    }
+                    vk::Texture::upload_batch(static_cast<vk::Context*>(ctx), created, staging);
+                    auto upload_ms = timer.elapsed().milli();
+
+                    u64   bytes     = 0;
+                    float decode_ms = 0.f;
+                    for (std::size_t i = 0; i < created.size(); i++) {
+                        bytes     += created[i]->device_bytes();
+                        decode_ms += owners[i]->decode_ms;
+                        ctx->textures().load_stats().record(owners[i]->decode_ms, upload_ms / created.size());
+                        created[i]->m_Source  = std::move(owners[i]->path);
+                        created[i]->m_Options = options;
+                        ctx->textures().replace(owners[i]->texture, created[i]);
+                    }
+                    ABY_LOG("Loaded Texture Batch: {} of {}", created.size(), items->size());
+                    ABY_LOG("  Decode:   {}ms (summed over threads)", decode_ms);
+                    ABY_LOG("  Upload:   {}ms", upload_ms);
+                    ABY_LOG("  Bytes:    {}", bytes);
+                } break;
+                default:
+                    ABY_ASSERT(false, "Unsupported ctx backend");
+                    break;
+            }
+        }, decodes);
+
+        return textures;
+    }
+
     Resource Texture::create(Context* ctx) {
         ABY_ASSERT(ctx, "(aby::Context*)ctx is invalid!");
         switch (ctx->backend()) {
             case EBackend::VULKAN:
             {
-                return ctx->load_thread().add_task(EResource::TEXTURE, [ctx]() {
-                    auto tex = create_ref<vk::Texture>(static_cast<vk::Context*>(ctx));
-                    return ctx->textures().add(tex);
-                });
+                auto tex = create_ref<vk::Texture>(static_cast<vk::Context*>(ctx));
+                return ctx->textures().add(tex);
             }
             default:
                 ABY_ASSERT(false, "Unsupported ctx backend");
@@ -64,17 +530,16 @@ namespace aby {
         switch (ctx->backend()) {
             case EBackend::VULKAN:
             {
-                return ctx->load_thread().add_task(EResource::TEXTURE, [ctx, size, color]() {
-                    Timer timer;
-                    auto tex = create_ref<vk::Texture>(static_cast<vk::Context*>(ctx), size, color);
-                    auto elapsed = timer.elapsed();
-                    ABY_LOG("Loaded Texture: {}ms", elapsed.milli());
-                    ABY_LOG("  Color:    ({}, {}, {}, {})", EXPAND_COLOR(color));
-                    ABY_LOG("  Size:     ({}, {})", EXPAND_VEC2(tex->size()));
-                    ABY_LOG("  Channels: {}", tex->channels());
-                    ABY_LOG("  Bytes:    {}", tex->bytes());
-                    return ctx->textures().add(tex);
-                });
+                Timer timer;
+                auto tex = create_ref<vk::Texture>(static_cast<vk::Context*>(ctx), size, color);
+                auto elapsed = timer.elapsed();
+                ctx->textures().load_stats().record(0.f, elapsed.milli());
+                ABY_LOG("Loaded Texture: {}ms", elapsed.milli());
+                ABY_LOG("  Color:    ({}, {}, {}, {})", EXPAND_COLOR(color));
+                ABY_LOG("  Size:     ({}, {})", EXPAND_VEC2(tex->size()));
+                ABY_LOG("  Channels: {}", tex->channels());
+                ABY_LOG("  Bytes:    {}", tex->bytes());
+                return ctx->textures().add(tex);
             }
             default:
                 ABY_ASSERT(false, "Unsupported ctx backend");
@@ -89,16 +554,15 @@ namespace aby {
         switch (ctx->backend()) {
             case EBackend::VULKAN:
             {
-                return ctx->load_thread().add_task(EResource::TEXTURE, [ctx, size, data, channels, format]() {
-                    Timer timer;
-                    auto tex = create_ref<vk::Texture>(static_cast<vk::Context*>(ctx), size, data, channels, format);
-                    auto elapsed = timer.elapsed();
-                    ABY_LOG("Loaded Texture: {}ms", elapsed.milli());
-                    ABY_LOG("  Size:     ({}, {})", EXPAND_VEC2(tex->size()));
-                    ABY_LOG("  Channels: {}", tex->channels());
-                    ABY_LOG("  Bytes:    {}", tex->bytes());
-                    return ctx->textures().add(tex);
-                });
+                Timer timer;
+                auto tex = create_ref<vk::Texture>(static_cast<vk::Context*>(ctx), size, data, channels, format);
+                auto elapsed = timer.elapsed();
+                ctx->textures().load_stats().record(0.f, elapsed.milli());
+                ABY_LOG("Loaded Texture: {}ms", elapsed.milli());
+                ABY_LOG("  Size:     ({}, {})", EXPAND_VEC2(tex->size()));
+                ABY_LOG("  Channels: {}", tex->channels());
+                ABY_LOG("  Bytes:    {}", tex->bytes());
+                return ctx->textures().add(tex);
             }
             default:
                 ABY_ASSERT(false, "Unsupported ctx backend");
@@ -111,16 +575,15 @@ namespace aby {
         ABY_ASSERT(ctx, "(aby::Context*)ctx is invalid!");
         switch (ctx->backend()) {
         case EBackend::VULKAN: {
-            return ctx->load_thread().add_task(EResource::TEXTURE, [ctx, size, data, channels, format]() {
-                Timer timer;
-                auto tex = create_ref<vk::Texture>(static_cast<vk::Context*>(ctx), size, data, channels, format);
-                auto elapsed = timer.elapsed();
-                ABY_LOG("Loaded Texture: {}ms", elapsed.milli());
-                ABY_LOG("  Size:     ({}, {})", EXPAND_VEC2(tex->size()));
-                ABY_LOG("  Channels: {}", tex->channels());
-                ABY_LOG("  Bytes:    {}", tex->bytes());
-                return ctx->textures().add(tex);
-            });
+            Timer timer;
+            auto tex = create_ref<vk::Texture>(static_cast<vk::Context*>(ctx), size, data, channels, format);
+            auto elapsed = timer.elapsed();
+            ctx->textures().load_stats().record(0.f, elapsed.milli());
+            ABY_LOG("Loaded Texture: {}ms", elapsed.milli());
+            ABY_LOG("  Size:     ({}, {})", EXPAND_VEC2(tex->size()));
+            ABY_LOG("  Channels: {}", tex->channels());
+            ABY_LOG("  Bytes:    {}", tex->bytes());
+            return ctx->textures().add(tex);
         }
         default:
             ABY_ASSERT(false, "Unsupported ctx backend");
@@ -132,6 +595,7 @@ namespace aby {
     Texture::Texture() :
         m_Size(0, 0),
         m_Channels(0),
+        m_Levels(1),
         m_AbyFormat(ETextureFormat::RGBA),
         m_State(ETextureState::GOOD)
     { }
@@ -139,6 +603,7 @@ namespace aby {
     Texture::Texture(const fs::path& path) :
         m_Size(0, 0),
         m_Channels(0),
+        m_Levels(1),
         m_AbyFormat(ETextureFormat::RGBA),
         m_State(ETextureState::GOOD)
 
@@ -171,6 +636,7 @@ namespace aby {
     Texture::Texture(const glm::u32vec2& size, const glm::vec4& color) :
         m_Size(size),
         m_Channels(4),
+        m_Levels(1),
         m_AbyFormat(ETextureFormat::RGBA),
         m_State(ETextureState::GOOD)
     {
@@ -194,6 +660,7 @@ namespace aby {
     Texture::Texture(const glm::u32vec2& size, const std::vector<std::byte>& data, u32 channels, ETextureFormat format) :
         m_Size(size),
         m_Channels(channels), 
+        m_Levels(1),
         m_Data(data),
         m_AbyFormat(format),
         m_State(ETextureState::GOOD)
@@ -203,9 +670,23 @@ namespace aby {
         ABY_ASSERT(check_format_channels(channels, format), "Channel count does not align with texture format");
     }
 
+    Texture::Texture(const glm::u32vec2& size, std::vector<std::byte>&& data, u32 channels, ETextureFormat format) :
+        m_Size(size),
+        m_Channels(channels), 
+        m_Levels(1),
+        m_Data(std::move(data)),
+        m_AbyFormat(format),
+        m_State(ETextureState::GOOD)
+    {
+        ABY_ASSERT(m_Data.size() % channels == 0, "Invalid texture data size");
+        ABY_ASSERT(m_Size.x * m_Size.y * channels == m_Data.size(), "Data size does not match square image");
+        ABY_ASSERT(check_format_channels(channels, format), "Channel count does not align with texture format");
+    }
+
     Texture::Texture(const glm::u32vec2& size, const void* data, u32 channels, ETextureFormat format) :
         m_Size(size), 
         m_Channels(channels),
+        m_Levels(1),
         m_AbyFormat(format),
         m_State(ETextureState::GOOD)
     {
@@ -216,12 +697,28 @@ namespace aby {
         std::memcpy(m_Data.data(), data, byte_ct);
     }
 
+    Texture::Texture(const glm::u32vec2& size, u32 channels, ETextureFormat format, std::span<const std::byte> data, u32 levels) :
+        m_Size(size),
+        m_Channels(channels),
+        m_Levels(levels),
+        m_AbyFormat(format),
+        m_State(ETextureState::GOOD),
+        m_Data(data.begin(), data.end())
+    {
+        ABY_ASSERT(check_format_channels(channels, format), "Channel count does not align with texture format");
+        ABY_ASSERT(data.empty() || data.size() == texture_bytes(size, channels, format), "Data size does not match image");
+    }
+
     Texture::Texture(const Texture& other) :
         m_Size(other.m_Size),
         m_Channels(other.m_Channels),
+        m_Levels(other.m_Levels),
         m_Data(other.m_Data),
         m_AbyFormat(other.m_AbyFormat),
-        m_State(other.m_State)
+        m_State(other.m_State),
+        m_Dirty(other.m_Dirty),
+        m_Source(other.m_Source),
+        m_Options(other.m_Options)
     {
 
     }
@@ -229,28 +726,95 @@ namespace aby {
     Texture::Texture(Texture&& other) noexcept :
         m_Size(std::move(other.m_Size)),
         m_Channels(std::move(other.m_Channels)),
+        m_Levels(other.m_Levels),
         m_Data(std::move(other.m_Data)),
         m_AbyFormat(std::move(other.m_AbyFormat)),
-        m_State(std::move(other.m_State))
+        m_State(std::move(other.m_State)),
+        m_Dirty(std::move(other.m_Dirty)),
+        m_Source(std::move(other.m_Source)),
+        m_Options(other.m_Options)
     {
 
     }
 
    
     void Texture::write(const glm::u32vec2& size, const std::vector<std::byte>& data) {
-        m_State = m_Size != size ? ETextureState::RECREATE : ETextureState::UPLOAD;
-        m_Data  = data;
-        m_Size  = size;
+        std::lock_guard lock(m_Mutex);
+        ABY_ASSERT(block_format(m_AbyFormat) == util::EBlockFormat::NONE, "Block compressed textures are read only");
+        // A resize still pending must stay a recreate, the image has the old size until the next sync.
+        if (m_State != ETextureState::RECREATE) {
+            m_State = m_Size != size || m_Levels > 1 ? ETextureState::RECREATE : ETextureState::UPLOAD;
+        }
+        m_Data   = data;
+        m_Size   = size;
+        m_Levels = 1;
+        m_Dirty.clear();
+        account();
+        queue_sync();
     }
     
     void Texture::write(const glm::u32vec2& size, const void* data) {
         std::size_t byte_ct = size.x * size.y * m_Channels;
 
-        m_State = m_Size != size ? ETextureState::RECREATE : ETextureState::UPLOAD;
-        m_Size  = size;
+        std::lock_guard lock(m_Mutex);
+        ABY_ASSERT(block_format(m_AbyFormat) == util::EBlockFormat::NONE, "Block compressed textures are read only");
+        if (m_State != ETextureState::RECREATE) {
+            m_State = m_Size != size || m_Levels > 1 ? ETextureState::RECREATE : ETextureState::UPLOAD;
+        }
+        m_Size   = size;
+        m_Levels = 1;
+        m_Dirty.clear();
 
         m_Data.resize(byte_ct);
         std::memcpy(m_Data.data(), data, byte_ct);
+        account();
+        queue_sync();
+    }
+
+    void Texture::write_region(const glm::u32vec2& offset, const glm::u32vec2& extent, const void* data) {
+        std::lock_guard lock(m_Mutex);
+        ABY_ASSERT(block_format(m_AbyFormat) == util::EBlockFormat::NONE, "Block compressed textures are read only");
+        ABY_ASSERT(offset.x + extent.x <= m_Size.x && offset.y + extent.y <= m_Size.y, "Region is out of bounds");
+        ABY_ASSERT(m_Data.size() == static_cast<std::size_t>(m_Size.x) * m_Size.y * m_Channels, "Texture has no cpu side data to write into");
+        if (extent.x == 0 || extent.y == 0) return;
+
+        std::size_t row = static_cast<std::size_t>(extent.x) * m_Channels;
+        auto*       src = static_cast<const std::byte*>(data);
+        for (u32 y = 0; y < extent.y; y++) {
+            std::size_t dst = (static_cast<std::size_t>(offset.y + y) * m_Size.x + offset.x) * m_Channels;
+            std::memcpy(m_Data.data() + dst, src + y * row, row);
+        }
+
+        // The mips below level 0 would go stale, drop the chain.
+        if (m_Levels > 1) {
+            m_State  = ETextureState::RECREATE;
+            m_Levels = 1;
+            m_Dirty.clear();
+            account();
+            queue_sync();
+            return;
+        }
+        // A pending full upload already covers the region.
+        if (m_State == ETextureState::UPLOAD || m_State == ETextureState::RECREATE) return;
+
+        TextureRegion::insert(m_Dirty, TextureRegion{ .offset = offset, .extent = extent });
+        m_State = ETextureState::REGION;
+        queue_sync();
+    }
+
+    void Texture::account() {
+        if (!m_Residency) return;
+        u64 cpu = bytes();
+        u64 gpu = device_bytes();
+        m_Residency->count(static_cast<i64>(cpu - m_CpuCounted), static_cast<i64>(gpu - m_GpuCounted));
+        m_CpuCounted = cpu;
+        m_GpuCounted = gpu;
+    }
+
+    void Texture::queue_sync() {
+        if (m_Queue && !m_Queued.exchange(true, std::memory_order_acq_rel)) {
+            m_Queue->push(m_QueueHandle);
+        }
     }
 
     const glm::u32vec2& Texture::size() const {
@@ -270,6 +834,36 @@ namespace aby {
         return m_Data.size();
     }
 
+    u32 Texture::levels() const {
+        return m_Levels;
+    }
+
+    ETextureLoad Texture::load_options() const {
+        return m_Options;
+    }
+
+    u64 Texture::device_bytes() const {
+        u64          bytes = 0;
+        glm::u32vec2 dim   = m_Size;
+        for (u32 i = 0; i < m_Levels; i++) {
+            bytes += texture_bytes(dim, m_Channels, m_AbyFormat);
+            dim    = glm::max(dim / 2u, glm::u32vec2(1));
+        }
+        return bytes;
+    }
+
+    const fs::path& Texture::source() const {
+        return m_Source;
+    }
+
+    void Texture::release_data() {
+        std::lock_guard lock(m_Mutex);
+        if (dirty()) return;
+        m_Data.clear();
+        m_Data.shrink_to_fit();
+        account();
+    }
+
     bool Texture::dirty() const {
         return m_State != ETextureState::GOOD;
     }
@@ -281,6 +875,42 @@ namespace aby {
 
 }
 
+namespace aby {
+
+    bool TextureRegion::overlaps(const TextureRegion& other) const {
+        return offset.x < other.offset.x + other.extent.x && other.offset.x < offset.x + extent.x &&
+               offset.y < other.offset.y + other.extent.y && other.offset.y < offset.y + extent.y;
+    }
+
+    TextureRegion TextureRegion::merged(const TextureRegion& other) const {
+        glm::u32vec2 min = glm::min(offset, other.offset);
+        glm::u32vec2 max = glm::max(offset + extent, other.offset + other.extent);
+        return TextureRegion{ .offset = min, .extent = max - min };
+    }
+
+    u64 TextureRegion::area() const {
+        return static_cast<u64>(extent.x) * extent.y;
+    }
+
+    void TextureRegion::insert(std::vector<TextureRegion>& regions, TextureRegion region) {
+        // Growing the region may make it overlap regions already checked, repeat until nothing merges.
+        bool merged = true;
+        while (merged) {
+            merged = false;
+            for (auto it = regions.begin(); it != regions.end(); ++it) {
+                if (it->overlaps(region)) {
+                    region = region.merged(*it);
+                    regions.erase(it);
+                    merged = true;
+                    break;
+                }
+            }
+        }
+        regions.push_back(region);
+    }
+
+}
+
 namespace aby {
 
     Ref<BufferedTexture> BufferedTexture::create(Context* ctx, const glm::u32vec2& size, const std::vector<std::byte>& data, u32 channels, ETextureFormat format, std::size_t buffers) {
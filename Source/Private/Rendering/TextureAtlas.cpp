@@ -0,0 +1,297 @@
+#include "Rendering/TextureAtlas.h"
+#include "Rendering/Context.h"
+#include "Rendering/Texture.h"
+#include "Rendering/ImageCache.h"
+#include "Core/App.h"
+#include "Core/Log.h"
+#include "Utility/Archive.h"
+#include <stb_image/stb_image.h>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace aby {
+
+    SkylinePacker::SkylinePacker(const glm::u32vec2& size) :
+        m_Size(size),
+        m_Skyline{ Node{ 0, 0, size.x } },
+        m_Used(0)
+    {
+
+    }
+
+    std::optional<glm::u32vec2> SkylinePacker::insert(const glm::u32vec2& size) {
+        if (size.x == 0 || size.y == 0) return std::nullopt;
+
+        constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+        std::size_t best        = npos;
+        u32         best_y      = 0;
+        u32         best_bottom = std::numeric_limits<u32>::max();
+        u32         best_width  = std::numeric_limits<u32>::max();
+        for (std::size_t i = 0; i < m_Skyline.size(); i++) {
+            auto y = fit(i, size);
+            if (!y) continue;
+            // Lowest bottom edge first, then the narrowest segment to leave wide gaps open.
+            u32 bottom = *y + size.y;
+            if (bottom < best_bottom || (bottom == best_bottom && m_Skyline[i].width < best_width)) {
+                best        = i;
+                best_y      = *y;
+                best_bottom = bottom;
+                best_width  = m_Skyline[i].width;
+            }
+        }
+        if (best == npos) return std::nullopt;
+
+        Node node{ m_Skyline[best].x, best_bottom, size.x };
+        m_Skyline.insert(m_Skyline.begin() + best, node);
+
+        // The new segment covers the start of the following ones.
+        for (std::size_t i = best + 1; i < m_Skyline.size();) {
+            u32   end = m_Skyline[i - 1].x + m_Skyline[i - 1].width;
+            Node& cur = m_Skyline[i];
+            if (cur.x >= end) break;
+            u32 covered = end - cur.x;
+            if (cur.width <= covered) {
+                m_Skyline.erase(m_Skyline.begin() + i);
+                continue;
+            }
+            cur.x     += covered;
+            cur.width -= covered;
+            break;
+        }
+
+        for (std::size_t i = 0; i + 1 < m_Skyline.size();) {
+            if (m_Skyline[i].y == m_Skyline[i + 1].y) {
+                m_Skyline[i].width += m_Skyline[i + 1].width;
+                m_Skyline.erase(m_Skyline.begin() + i + 1);
+            }
+            else {
+                i++;
+            }
+        }
+
+        m_Used += static_cast<u64>(size.x) * size.y;
+        return glm::u32vec2{ node.x, best_y };
+    }
+
+    void SkylinePacker::grow(const glm::u32vec2& size) {
+        ABY_ASSERT(size.x >= m_Size.x && size.y >= m_Size.y, "Packer can not shrink");
+        if (size.x > m_Size.x) {
+            if (m_Skyline.back().y == 0) {
+                m_Skyline.back().width += size.x - m_Size.x;
+            }
+            else {
+                m_Skyline.push_back(Node{ m_Size.x, 0, size.x - m_Size.x });
+            }
+        }
+        m_Size = size;
+    }
+
+    std::optional<u32> SkylinePacker::fit(std::size_t index, const glm::u32vec2& size) const {
+        if (m_Skyline[index].x + size.x > m_Size.x) return std::nullopt;
+
+        // Rest on the highest segment below the rectangle.
+        u32 y         = 0;
+        u32 remaining = size.x;
+        for (std::size_t i = index; remaining > 0; i++) {
+            y = std::max(y, m_Skyline[i].y);
+            if (y + size.y > m_Size.y) return std::nullopt;
+            remaining -= std::min(remaining, m_Skyline[i].width);
+        }
+        return y;
+    }
+
+    const glm::u32vec2& SkylinePacker::size() const {
+        return m_Size;
+    }
+
+    u64 SkylinePacker::used() const {
+        return m_Used;
+    }
+
+}
+
+namespace aby {
+
+    void AtlasRegion::apply(Quad& quad) const {
+        quad.texinfo = glm::vec3(uv_offset, static_cast<float>(texture.index()));
+        quad.uvs     = uv_scale;
+    }
+
+    ImVec2 AtlasRegion::uv0() const {
+        return ImVec2(uv_offset.x, uv_offset.y);
+    }
+
+    ImVec2 AtlasRegion::uv1() const {
+        return ImVec2(uv_offset.x + uv_scale.x, uv_offset.y + uv_scale.y);
+    }
+
+}
+
+namespace aby {
+
+    TextureAtlas::TextureAtlas(Context* ctx, const glm::u32vec2& page_size, const glm::u32vec2& max_page_size, u32 padding) :
+        m_Ctx(ctx),
+        m_PageSize(page_size),
+        m_MaxPageSize(glm::max(page_size, max_page_size)),
+        m_Padding(padding),
+        m_Pages{},
+        m_Sprites{}
+    {
+
+    }
+
+    std::optional<TextureAtlas::Sprite> TextureAtlas::add(const glm::u32vec2& size, const void* data, u32 channels) {
+        ABY_ASSERT(channels >= 1 && channels <= 4, "Unsupported channel count: {}", channels);
+        glm::u32vec2 padded = size + 2u * m_Padding;
+        if (size.x == 0 || size.y == 0 || padded.x > m_MaxPageSize.x || padded.y > m_MaxPageSize.y) {
+            ABY_WARN("Image of size ({}, {}) does not fit in an atlas page", EXPAND_VEC2(size));
+            return std::nullopt;
+        }
+
+        std::vector<std::byte> rgba(static_cast<std::size_t>(size.x) * size.y * 4);
+        auto* src = static_cast<const std::byte*>(data);
+        for (std::size_t i = 0, n = static_cast<std::size_t>(size.x) * size.y; i < n; i++) {
+            const std::byte* in  = src + i * channels;
+            std::byte*       out = rgba.data() + i * 4;
+            switch (channels) {
+                case 1: out[0] = out[1] = out[2] = in[0]; out[3] = std::byte{ 0xFF }; break;
+                case 2: out[0] = out[1] = out[2] = in[0]; out[3] = in[1];             break;
+                case 3: std::memcpy(out, in, 3);          out[3] = std::byte{ 0xFF }; break;
+                case 4: std::memcpy(out, in, 4);                                      break;
+            }
+        }
+
+        std::optional<glm::u32vec2> pos;
+        u32 index = 0;
+        for (; index < m_Pages.size() && !pos; index++) {
+            pos = place(m_Pages[index], size);
+        }
+        if (pos) {
+            index--;
+        }
+        else {
+            pos = place(add_page(), size);
+            ABY_ASSERT(pos, "Image does not fit in an empty atlas page");
+        }
+
+        auto page = m_Ctx->textures().at(m_Pages[index].texture);
+        page->write_region(*pos, size, rgba.data());
+        m_Sprites.emplace_back(index, *pos, size);
+        return static_cast<Sprite>(m_Sprites.size() - 1);
+    }
+
+    std::optional<TextureAtlas::Sprite> TextureAtlas::add(const fs::path& path) {
+        if (auto archive = m_Ctx->app()->archive()) {
+            if (auto image = archive->image(util::Archive::key(m_Ctx->app()->bin(), path))) {
+                if (image->format == util::EBlockFormat::NONE) {
+                    return add(image->size, image->pixels.data(), image->channels);
+                }
+                // Pages are uncompressed, so are the sprites written into them.
+                std::vector<std::uint8_t> rgba(static_cast<std::size_t>(image->size.x) * image->size.y * 4);
+                auto blocks = image->pixels.first(util::block_image_bytes(image->format, image->size.x, image->size.y));
+                if (!util::decode_image(image->format, { reinterpret_cast<const std::uint8_t*>(blocks.data()), blocks.size() }, image->size.x, image->size.y, rgba)) {
+                    ABY_ERR("Unsupported block encoding ({})", path);
+                    return std::nullopt;
+                }
+                return add(image->size, rgba.data(), 4);
+            }
+        }
+
+        util::MappedFile file(path);
+        if (!file) {
+            ABY_ERR("{}", file.error());
+            return std::nullopt;
+        }
+        std::optional<ImageCache> cache;
+        u64                       key = 0;
+        if (m_Ctx->app()->info().cache_images) {
+            cache.emplace(m_Ctx->app()->cache() / "Images");
+            key = ImageCache::key(file.view());
+            if (auto entry = cache->find(key)) {
+                return add(entry->size, entry->pixels.data(), entry->channels);
+            }
+        }
+
+        int w, h, c;
+        constexpr int LOAD_ALL_CHANNELS = 0;
+        auto pixels = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(file.view().data()), static_cast<int>(file.size()), &w, &h, &c, LOAD_ALL_CHANNELS);
+        if (!pixels) {
+            ABY_ERR("[stbi_image::stbi_load]: {} ({})", stbi_failure_reason(), path);
+            return std::nullopt;
+        }
+        glm::u32vec2 size(static_cast<u32>(w), static_cast<u32>(h));
+        if (cache) {
+            cache->store(key, size, static_cast<u32>(c), { reinterpret_cast<const std::byte*>(pixels), static_cast<std::size_t>(w) * h * c });
+        }
+        auto sprite = add(size, pixels, static_cast<u32>(c));
+        stbi_image_free(pixels);
+        return sprite;
+    }
+
+    AtlasRegion TextureAtlas::region(Sprite sprite) const {
+        ABY_ASSERT(sprite < m_Sprites.size(), "Invalid atlas sprite {}", sprite);
+        const Entry& entry = m_Sprites[sprite];
+        const Page&  page  = m_Pages[entry.page];
+        glm::vec2    dim(page.packer.size());
+        return AtlasRegion{
+            .texture   = page.texture,
+            .uv_offset = glm::vec2(entry.pos) / dim,
+            .uv_scale  = glm::vec2(entry.size) / dim,
+        };
+    }
+
+    std::size_t TextureAtlas::pages() const {
+        return m_Pages.size();
+    }
+
+    Resource TextureAtlas::page(std::size_t index) const {
+        return m_Pages[index].texture;
+    }
+
+    std::size_t TextureAtlas::sprites() const {
+        return m_Sprites.size();
+    }
+
+    std::optional<glm::u32vec2> TextureAtlas::place(Page& page, const glm::u32vec2& size) {
+        glm::u32vec2 padded = size + 2u * m_Padding;
+        auto         pos    = page.packer.insert(padded);
+        while (!pos) {
+            glm::u32vec2 old_size = page.packer.size();
+            glm::u32vec2 new_size = old_size;
+            // Double the shorter side first to keep pages square-ish.
+            if (new_size.x <= new_size.y && new_size.x < m_MaxPageSize.x) {
+                new_size.x = std::min(new_size.x * 2, m_MaxPageSize.x);
+            }
+            else if (new_size.y < m_MaxPageSize.y) {
+                new_size.y = std::min(new_size.y * 2, m_MaxPageSize.y);
+            }
+            else if (new_size.x < m_MaxPageSize.x) {
+                new_size.x = std::min(new_size.x * 2, m_MaxPageSize.x);
+            }
+            else {
+                return std::nullopt;
+            }
+            page.packer.grow(new_size);
+
+            // Sprites keep their texel position, only their uvs change.
+            auto                   tex = m_Ctx->textures().at(page.texture);
+            auto                   old = tex->data();
+            std::vector<std::byte> pixels(static_cast<std::size_t>(new_size.x) * new_size.y * 4);
+            for (u32 y = 0; y < old_size.y; y++) {
+                std::memcpy(pixels.data() + static_cast<std::size_t>(y) * new_size.x * 4, old.data() + static_cast<std::size_t>(y) * old_size.x * 4, old_size.x * 4);
+            }
+            tex->write(new_size, pixels);
+            pos = page.packer.insert(padded);
+        }
+        return *pos + m_Padding;
+    }
+
+    TextureAtlas::Page& TextureAtlas::add_page() {
+        std::vector<std::byte> pixels(static_cast<std::size_t>(m_PageSize.x) * m_PageSize.y * 4);
+        Resource texture = Texture::create(m_Ctx, m_PageSize, pixels, 4, ETextureFormat::RGBA);
+        m_Ctx->residency().pin(texture);
+        return m_Pages.emplace_back(texture, SkylinePacker(m_PageSize));
+    }
+
+}
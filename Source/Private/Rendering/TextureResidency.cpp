@@ -0,0 +1,252 @@
+#include "Rendering/TextureResidency.h"
+#include "Rendering/Context.h"
+#include "Rendering/Texture.h"
+#include "Platform/vk/VkCommon.h"
+#include "Core/Log.h"
+#include <algorithm>
+
+namespace aby {
+
+    static u64 frames_in_flight(Context* ctx) {
+        switch (ctx->backend()) {
+            case EBackend::VULKAN:
+                return vk::MAX_FRAMES_IN_FLIGHT;
+            default:
+                ABY_ASSERT(false, "Unsupported ctx backend");
+        }
+        return 0;
+    }
+
+    TextureResidency::TextureResidency(Context* ctx, u64 cpu_budget, u64 gpu_budget) :
+        m_Ctx(ctx),
+        m_Stalled(false),
+        m_StalledCpu(0),
+        m_StalledGpu(0),
+        m_NextScan(0),
+        m_CpuBudget(cpu_budget),
+        m_GpuBudget(gpu_budget),
+        m_CpuBytes(0),
+        m_GpuBytes(0),
+        m_Frame(0),
+        m_FramesInFlight(frames_in_flight(ctx)),
+        m_Entries{},
+        m_Retired{}
+    {
+
+    }
+
+    void TextureResidency::touch(Resource texture) {
+        if (texture.type() != EResource::TEXTURE) return;
+        touch(texture.index());
+    }
+
+    void TextureResidency::touch(u32 index) {
+        Entry& e    = entry(index);
+        e.last_used = m_Frame;
+        if (e.unloaded && !e.reloading) {
+            // The handle may have been erased while unloaded, its file must not be decoded for nothing.
+            if (m_Ctx->textures().contains(e.unloaded)) {
+                reload(e);
+            }
+            else {
+                e = Entry{};
+            }
+        }
+    }
+
+    void TextureResidency::pin(Resource texture) {
+        if (texture.type() != EResource::TEXTURE) return;
+        entry(texture.index()).pinned = texture;
+    }
+
+    void TextureResidency::unpin(Resource texture) {
+        if (texture.type() != EResource::TEXTURE || texture.index() >= m_Entries.size()) return;
+        Entry& e = m_Entries[texture.index()];
+        if (e.pinned == texture) {
+            e.pinned  = {};
+            m_Stalled = false;
+        }
+    }
+
+    void TextureResidency::update() {
+        auto& textures = m_Ctx->textures();
+        m_Frame++;
+
+        // Unloaded textures are kept alive until no frame in flight can sample them.
+        std::erase_if(m_Retired, [this](const Retired& retired) {
+            return m_Frame - retired.frame > m_FramesInFlight;
+        });
+
+        for (auto& e : m_Entries) {
+            if (e.unloaded && !textures.contains(e.unloaded)) {
+                // Erased while unloaded, nothing of it is left to reload.
+                e = Entry{};
+            }
+            else if (e.reloading && textures.ready(e.unloaded)) {
+                e.unloaded  = {};
+                e.source    = {};
+                e.reloading = false;
+            }
+        }
+
+        enforce_budgets();
+    }
+
+    void TextureResidency::clear() {
+        m_Retired.clear();
+        m_Entries.clear();
+        m_Stalled = false;
+    }
+
+    void TextureResidency::attach(Resource::Handle handle, Texture& texture) {
+        // Handles of a recycled slot differ in generation, reloads and reserves of the same handle keep the entry.
+        Entry& e = entry(Resource::index_of(handle));
+        if (e.handle != handle) {
+            e = Entry{ .handle = handle };
+        }
+
+        std::lock_guard lock(texture.m_Mutex);
+        // The placeholder is bound to every reserved handle, it is counted once.
+        if (texture.m_Residency) return;
+        texture.m_Residency = this;
+        texture.account();
+    }
+
+    void TextureResidency::detach(Texture& texture) {
+        std::lock_guard lock(texture.m_Mutex);
+        if (texture.m_Residency != this) return;
+        count(-static_cast<i64>(texture.m_CpuCounted), -static_cast<i64>(texture.m_GpuCounted));
+        texture.m_Residency  = nullptr;
+        texture.m_CpuCounted = 0;
+        texture.m_GpuCounted = 0;
+    }
+
+    void TextureResidency::count(i64 cpu_bytes, i64 gpu_bytes) {
+        // Unsigned wrap around adds negative deltas.
+        m_CpuBytes.fetch_add(static_cast<u64>(cpu_bytes), std::memory_order_relaxed);
+        m_GpuBytes.fetch_add(static_cast<u64>(gpu_bytes), std::memory_order_relaxed);
+    }
+
+    void TextureResidency::enforce_budgets() {
+        u64 cpu_bytes = m_CpuBytes;
+        u64 gpu_bytes = m_GpuBytes;
+        if (cpu_bytes <= m_CpuBudget && gpu_bytes <= m_GpuBudget) {
+            m_Stalled = false;
+            return;
+        }
+        // Nothing could be evicted last time, nor can it now unless the totals changed or a texture left the frames in flight.
+        if (m_Stalled && cpu_bytes == m_StalledCpu && gpu_bytes == m_StalledGpu && m_Frame < m_NextScan) return;
+
+        struct Candidate {
+            u64          last_used;
+            Resource     handle;
+            Ref<Texture> texture;
+        };
+
+        auto&       textures    = m_Ctx->textures();
+        const auto& placeholder = textures.placeholder();
+
+        std::vector<Candidate> candidates;
+        u64                    next_scan = UINT64_MAX;
+        for (auto& [handle, tex] : textures) {
+            if (!tex || tex == placeholder) continue;
+            u32  index     = Resource::index_of(handle);
+            u64  last_used = index < m_Entries.size() ? m_Entries[index].last_used : 0;
+            bool pinned    = index < m_Entries.size() && m_Entries[index].pinned.handle() == handle;
+            if (pinned) continue;
+            if (m_Frame - last_used <= m_FramesInFlight) {
+                next_scan = std::min(next_scan, last_used + m_FramesInFlight + 1);
+                continue;
+            }
+            {
+                // Written from any thread.
+                std::lock_guard lock(tex->m_Mutex);
+                if (tex->dirty()) {
+                    // Clean again after the next sync.
+                    next_scan = std::min(next_scan, m_Frame + 1);
+                    continue;
+                }
+            }
+            candidates.emplace_back(last_used, Resource(EResource::TEXTURE, handle), tex);
+        }
+
+        std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+            return a.last_used < b.last_used;
+        });
+
+        // Unloading detaches the texture and releasing its data reports it, both update the totals.
+        bool evicted = false;
+        for (auto& [last_used, handle, tex] : candidates) {
+            if (m_CpuBytes <= m_CpuBudget && m_GpuBytes <= m_GpuBudget) break;
+
+            // Only file textures can be brought back, and a texture referenced outside
+            // of the resource class (the class and this candidate) may still be in use.
+            if (m_GpuBytes > m_GpuBudget && !tex->source().empty() && tex.use_count() <= 2) {
+                Entry& e    = entry(handle.index());
+                e.unloaded  = handle;
+                e.source    = tex->source();
+                // A reload brings the mips back but not the cpu side copy.
+                e.options   = tex->load_options() & ~ETextureLoad::KEEP_DATA;
+                e.reloading = false;
+                u64 device_bytes = tex->device_bytes();
+                m_Retired.emplace_back(m_Frame, textures.unload(handle));
+                ABY_DBG("Unloaded Texture: {} ({} bytes)", e.source, device_bytes);
+                evicted = true;
+            }
+            else if (m_CpuBytes > m_CpuBudget && tex->bytes() > 0) {
+                tex->release_data();
+                evicted = true;
+            }
+        }
+
+        m_Stalled    = !evicted;
+        m_StalledCpu = m_CpuBytes;
+        m_StalledGpu = m_GpuBytes;
+        m_NextScan   = next_scan;
+    }
+
+    void TextureResidency::reload(Entry& e) {
+        e.reloading = true;
+        Texture::load(m_Ctx, e.unloaded, e.source.filename().string(), [path = e.source]() { return path; }, {}, e.options);
+    }
+
+    TextureResidency::Entry& TextureResidency::entry(u32 index) {
+        ABY_ASSERT(index <= Resource::MAX_INDEX, "Texture index {} out of range", index);
+        if (index >= m_Entries.size()) {
+            m_Entries.resize(index + 1);
+        }
+        return m_Entries[index];
+    }
+
+    void TextureResidency::set_budgets(u64 cpu_budget, u64 gpu_budget) {
+        m_CpuBudget = cpu_budget;
+        m_GpuBudget = gpu_budget;
+        m_Stalled   = false;
+    }
+
+    u64 TextureResidency::cpu_budget() const {
+        return m_CpuBudget;
+    }
+
+    u64 TextureResidency::gpu_budget() const {
+        return m_GpuBudget;
+    }
+
+    u64 TextureResidency::cpu_bytes() const {
+        return m_CpuBytes;
+    }
+
+    u64 TextureResidency::gpu_bytes() const {
+        return m_GpuBytes;
+    }
+
+    u64 TextureResidency::frame() const {
+        return m_Frame;
+    }
+
+    u64 TextureResidency::last_used(Resource texture) const {
+        if (texture.type() != EResource::TEXTURE || texture.index() >= m_Entries.size()) return 0;
+        return m_Entries[texture.index()].last_used;
+    }
+
+}
@@ -0,0 +1,70 @@
+#include "Rendering/TextureStreamer.h"
+#include "Rendering/Context.h"
+#include <algorithm>
+
+namespace aby {
+
+    TextureStreamer::TextureStreamer(Context* ctx, u64 budget) :
+        m_Ctx(ctx),
+        m_Budget(budget),
+        m_Order(0),
+        m_PendingBytes(0),
+        m_Pending{}
+    {
+
+    }
+
+    void TextureStreamer::enqueue(Resource texture, u64 bytes, Upload&& upload) {
+        m_Pending.emplace_back(texture, bytes, m_Order++, std::move(upload));
+        m_PendingBytes += bytes;
+    }
+
+    u64 TextureStreamer::update() {
+        if (m_Pending.empty()) return 0;
+
+        // Highest priority at the back, so uploads pop from the end.
+        auto& residency = m_Ctx->residency();
+        std::sort(m_Pending.begin(), m_Pending.end(), [&residency](const Pending& a, const Pending& b) {
+            u64 used_a = residency.last_used(a.texture);
+            u64 used_b = residency.last_used(b.texture);
+            if (used_a != used_b) return used_a < used_b;
+            return a.order > b.order;
+        });
+
+        u64 uploaded = 0;
+        while (!m_Pending.empty()) {
+            const Pending& next = m_Pending.back();
+            if (uploaded > 0 && uploaded + next.bytes > m_Budget) break;
+
+            Pending pending = std::move(m_Pending.back());
+            m_Pending.pop_back();
+            m_PendingBytes -= pending.bytes;
+            if (!m_Ctx->textures().contains(pending.texture)) continue;
+            pending.upload();
+            uploaded += pending.bytes;
+        }
+        return uploaded;
+    }
+
+    void TextureStreamer::clear() {
+        m_Pending.clear();
+        m_PendingBytes = 0;
+    }
+
+    void TextureStreamer::set_budget(u64 budget) {
+        m_Budget = budget;
+    }
+
+    u64 TextureStreamer::budget() const {
+        return m_Budget;
+    }
+
+    std::size_t TextureStreamer::pending() const {
+        return m_Pending.size();
+    }
+
+    u64 TextureStreamer::pending_bytes() const {
+        return m_PendingBytes;
+    }
+
+}
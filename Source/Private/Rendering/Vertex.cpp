@@ -1,4 +1,10 @@
 #include "Rendering/Vertex.h"
+#include <glm/gtc/packing.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define ABY_SSE2
+    #include <emmintrin.h>
+#endif
 
 namespace aby {
 
@@ -20,6 +26,15 @@ namespace aby {
     Vertex::Vertex(const glm::vec2& pos, const glm::vec4& col, const glm::vec3& texinfo, const glm::vec2& uvs) :
         pos(pos, 0), col(col), texinfo(texinfo), uvs(uvs) {}
 
+    PackedVertex::PackedVertex(const glm::vec3& pos, u32 col, const glm::u16vec2& texcoord, u16 texture) :
+        pos(pos), col(col), texcoord(texcoord), texture(texture) {}
+
+    PackedVertex::PackedVertex(const Vertex& vertex) :
+        pos(vertex.pos), 
+        col(glm::packUnorm4x8(vertex.col)),
+        texcoord(glm::u16vec2(glm::round(glm::clamp(glm::vec2(vertex.texinfo) * vertex.uvs, 0.f, 1.f) * 65535.f))),
+        texture(static_cast<u16>(vertex.texinfo.z)) {}
+
 }
 
 namespace aby {
@@ -43,6 +58,44 @@ namespace aby {
     Quad::Quad(const glm::vec3& size, const glm::vec3& pos, const glm::vec4& col, float texture, const glm::vec2& uvs) :
         pos(pos), col(col), texinfo(0, 0, texture), uvs(uvs), size(size) {}
 
+    QuadInstance::QuadInstance(const Quad& quad) :
+        pos(quad.pos), size(quad.size), col(glm::packUnorm4x8(quad.col)), texture(static_cast<u32>(quad.texinfo.z)), uvs(glm::vec2(quad.texinfo), quad.uvs) {}
+
+    void pack_quads(std::span<const Quad> quads, QuadInstance* out) {
+        std::size_t i = 0;
+#ifdef ABY_SSE2
+        const __m128 zero  = _mm_setzero_ps();
+        const __m128 one   = _mm_set1_ps(1.f);
+        const __m128 scale = _mm_set1_ps(255.f);
+        auto unorm8 = [&](const glm::vec4& col) {
+            return _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(&col.x), zero), one), scale));
+        };
+        alignas(16) u32 cols[4];
+        alignas(16) u32 textures[4];
+        for (; i + 4 <= quads.size(); i += 4) {
+            const Quad* q = quads.data() + i;
+            // Saturate the 16 channels of four colors down to bytes, one RGBA8 per lane.
+            __m128i lo = _mm_packs_epi32(unorm8(q[0].col), unorm8(q[1].col));
+            __m128i hi = _mm_packs_epi32(unorm8(q[2].col), unorm8(q[3].col));
+            _mm_store_si128(reinterpret_cast<__m128i*>(cols), _mm_packus_epi16(lo, hi));
+            __m128 texture = _mm_set_ps(q[3].texinfo.z, q[2].texinfo.z, q[1].texinfo.z, q[0].texinfo.z);
+            _mm_store_si128(reinterpret_cast<__m128i*>(textures), _mm_cvttps_epi32(texture));
+
+            for (std::size_t j = 0; j < 4; j++) {
+                QuadInstance& instance = out[i + j];
+                instance.pos     = q[j].pos;
+                instance.size    = glm::vec2(q[j].size);
+                instance.col     = cols[j];
+                instance.texture = textures[j];
+                instance.uvs     = glm::vec4(glm::vec2(q[j].texinfo), q[j].uvs);
+            }
+        }
+#endif
+        for (; i < quads.size(); i++) {
+            out[i] = QuadInstance(quads[i]);
+        }
+    }
+
 }
 
 namespace aby {
@@ -0,0 +1,123 @@
+#include "Utility/Archive.h"
+#include <algorithm>
+#include <cstring>
+
+namespace aby::util {
+
+    Archive::Archive(const fs::path& path) :
+        m_File(path),
+        m_Path(path),
+        m_Entries{},
+        m_Names{},
+        m_Error{}
+    {
+        if (!m_File) {
+            m_Error = m_File.error();
+            return;
+        }
+
+        auto view = m_File.view();
+        if (view.size() < sizeof(ArchiveHeader)) {
+            m_Error = std::format("Archive is too small: {}", path);
+            return;
+        }
+
+        ArchiveHeader header;
+        std::memcpy(&header, view.data(), sizeof(header));
+        if (header.magic != ARCHIVE_MAGIC) {
+            m_Error = std::format("Not an asset archive: {}", path);
+            return;
+        }
+        if (header.version != ARCHIVE_VERSION) {
+            m_Error = std::format("Unsupported archive version {} (expected {}): {}", header.version, ARCHIVE_VERSION, path);
+            return;
+        }
+
+        u64 index_bytes = static_cast<u64>(header.entry_count) * sizeof(ArchiveEntry);
+        if (header.index_offset % alignof(ArchiveEntry) != 0 ||
+            header.index_offset + index_bytes > header.names_offset ||
+            header.names_offset > view.size())
+        {
+            m_Error = std::format("Corrupt archive index: {}", path);
+            return;
+        }
+
+        m_Entries = { reinterpret_cast<const ArchiveEntry*>(view.data() + header.index_offset), header.entry_count };
+        m_Names   = view.substr(header.names_offset);
+        for (const auto& entry : m_Entries) {
+            if (entry.offset + entry.size > header.index_offset ||
+                static_cast<u64>(entry.name_offset) + entry.name_size > m_Names.size())
+            {
+                m_Error   = std::format("Corrupt archive entry: {}", path);
+                m_Entries = {};
+                m_Names   = {};
+                return;
+            }
+        }
+    }
+
+    const ArchiveEntry* Archive::find(std::string_view name, EArchiveEntry kind) const {
+        u64  hash = fnv1a_64(name);
+        auto it   = std::lower_bound(m_Entries.begin(), m_Entries.end(), hash, [](const ArchiveEntry& entry, u64 hash) {
+            return entry.hash < hash;
+        });
+        for (; it != m_Entries.end() && it->hash == hash; ++it) {
+            if (it->kind == kind && this->name(*it) == name) {
+                return &*it;
+            }
+        }
+        return nullptr;
+    }
+
+    std::span<const std::byte> Archive::data(const ArchiveEntry& entry) const {
+        return { reinterpret_cast<const std::byte*>(m_File.view().data() + entry.offset), entry.size };
+    }
+
+    std::string_view Archive::name(const ArchiveEntry& entry) const {
+        return m_Names.substr(entry.name_offset, entry.name_size);
+    }
+
+    std::optional<ArchiveImageView> Archive::image(std::string_view name) const {
+        auto entry = find(name, EArchiveEntry::IMAGE);
+        if (!entry || entry->size < sizeof(ArchiveImage)) return std::nullopt;
+
+        auto         bytes = data(*entry);
+        ArchiveImage image;
+        std::memcpy(&image, bytes.data(), sizeof(image));
+        if (image.format != EBlockFormat::NONE && (block_bytes(image.format) == 0 || image.channels != 4 || image.levels == 0)) {
+            return std::nullopt;
+        }
+        u64 pixels = archive_image_bytes(image);
+        if (pixels == 0 || sizeof(ArchiveImage) + pixels > bytes.size()) return std::nullopt;
+
+        return ArchiveImageView{
+            .size     = { image.width, image.height },
+            .channels = image.channels,
+            .levels   = image.format == EBlockFormat::NONE ? 1u : image.levels,
+            .format   = image.format,
+            .pixels   = bytes.subspan(sizeof(ArchiveImage), pixels),
+        };
+    }
+
+    std::span<const ArchiveEntry> Archive::entries() const {
+        return m_Entries;
+    }
+
+    const fs::path& Archive::path() const {
+        return m_Path;
+    }
+
+    FileError Archive::error() const {
+        return m_Error;
+    }
+
+    std::string Archive::key(const fs::path& root, const fs::path& path) {
+        fs::path relative = path.is_absolute() ? path.lexically_relative(root) : path;
+        return relative.lexically_normal().generic_string();
+    }
+
+    Archive::operator bool() const {
+        return m_Error.empty() && static_cast<bool>(m_File);
+    }
+
+}
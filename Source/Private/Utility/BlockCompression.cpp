@@ -0,0 +1,590 @@
+#include "Utility/BlockCompression.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace aby::util {
+
+    namespace {
+
+        constexpr int BLOCK_TEXELS = 16;
+
+        using Texel = std::array<float, 4>;
+
+        /**
+        * Endpoints and palette indices of one block.
+        */
+        struct Fit {
+            Texel                                  e0      = {};
+            Texel                                  e1      = {};
+            std::array<std::uint8_t, BLOCK_TEXELS> indices = {};
+            float                                  error   = std::numeric_limits<float>::max();
+        };
+
+        /**
+        * Mean and direction of the largest spread of the texels, power iteration on their covariance.
+        */
+        void principal_axis(const Texel* texels, const bool* skip, int channels, Texel& mean, Texel& axis) {
+            mean = {};
+            Texel lo, hi;
+            lo.fill(255.f);
+            hi.fill(0.f);
+            int count = 0;
+            for (int i = 0; i < BLOCK_TEXELS; i++) {
+                if (skip[i]) continue;
+                for (int c = 0; c < channels; c++) {
+                    mean[c] += texels[i][c];
+                    lo[c]    = std::min(lo[c], texels[i][c]);
+                    hi[c]    = std::max(hi[c], texels[i][c]);
+                }
+                count++;
+            }
+            for (int c = 0; c < channels; c++) mean[c] /= static_cast<float>(count);
+
+            float cov[4][4] = {};
+            for (int i = 0; i < BLOCK_TEXELS; i++) {
+                if (skip[i]) continue;
+                for (int a = 0; a < channels; a++) {
+                    for (int b = 0; b < channels; b++) {
+                        cov[a][b] += (texels[i][a] - mean[a]) * (texels[i][b] - mean[b]);
+                    }
+                }
+            }
+
+            // Starting from the bounding box diagonal converges in a few steps for typical blocks.
+            axis = {};
+            for (int c = 0; c < channels; c++) axis[c] = hi[c] - lo[c];
+            for (int iter = 0; iter < 8; iter++) {
+                Texel next = {};
+                float norm = 0.f;
+                for (int a = 0; a < channels; a++) {
+                    for (int b = 0; b < channels; b++) next[a] += cov[a][b] * axis[b];
+                    norm = std::max(norm, std::abs(next[a]));
+                }
+                if (norm < 1e-6f) break;
+                for (int c = 0; c < channels; c++) axis[c] = next[c] / norm;
+            }
+            float len = 0.f;
+            for (int c = 0; c < channels; c++) len += axis[c] * axis[c];
+            len = std::sqrt(len);
+            if (len < 1e-6f) {
+                axis = {};
+                return;
+            }
+            for (int c = 0; c < channels; c++) axis[c] /= len;
+        }
+
+        void clamp_texel(Texel& t, int channels) {
+            for (int c = 0; c < channels; c++) t[c] = std::clamp(t[c], 0.f, 255.f);
+        }
+
+        /**
+        * Pick the closest palette entry for every texel.
+        * Palette entry k is e0 + weights[k] * (e1 - e0).
+        */
+        void assign_indices(const Texel* texels, const bool* skip, int channels, std::span<const float> weights, Fit& fit) {
+            fit.error = 0.f;
+            for (int i = 0; i < BLOCK_TEXELS; i++) {
+                if (skip[i]) continue;
+                float best = std::numeric_limits<float>::max();
+                for (std::size_t k = 0; k < weights.size(); k++) {
+                    float err = 0.f;
+                    for (int c = 0; c < channels; c++) {
+                        float v = fit.e0[c] + weights[k] * (fit.e1[c] - fit.e0[c]) - texels[i][c];
+                        err += v * v;
+                    }
+                    if (err < best) {
+                        best           = err;
+                        fit.indices[i] = static_cast<std::uint8_t>(k);
+                    }
+                }
+                fit.error += best;
+            }
+        }
+
+        /**
+        * Fit two endpoints and per texel indices to a block.
+        * Endpoints start at the extent of the texels along their principal axis, then are refined by
+        * solving for the endpoints that minimize the error of the chosen indices (least squares).
+        *
+        * @param skip     Texels that do not take part, e.g. BC1 transparent texels
+        * @param weights  Interpolation weight of each palette entry
+        * @param quantize Snaps both endpoints to values representable in the block
+        */
+        template <typename Quantize>
+        Fit fit_block(const Texel* texels, const bool* skip, int channels, std::span<const float> weights, Quantize&& quantize) {
+            Texel mean, axis;
+            principal_axis(texels, skip, channels, mean, axis);
+
+            float tmin = std::numeric_limits<float>::max();
+            float tmax = std::numeric_limits<float>::lowest();
+            for (int i = 0; i < BLOCK_TEXELS; i++) {
+                if (skip[i]) continue;
+                float t = 0.f;
+                for (int c = 0; c < channels; c++) t += (texels[i][c] - mean[c]) * axis[c];
+                tmin = std::min(tmin, t);
+                tmax = std::max(tmax, t);
+            }
+
+            Fit cur;
+            for (int c = 0; c < channels; c++) {
+                cur.e0[c] = mean[c] + tmin * axis[c];
+                cur.e1[c] = mean[c] + tmax * axis[c];
+            }
+
+            Fit best;
+            constexpr int REFINE_STEPS = 3;
+            for (int step = 0; step < REFINE_STEPS; step++) {
+                clamp_texel(cur.e0, channels);
+                clamp_texel(cur.e1, channels);
+                quantize(cur.e0, cur.e1);
+                assign_indices(texels, skip, channels, weights, cur);
+                if (cur.error < best.error) best = cur;
+                if (cur.error == 0.f) break;
+
+                float a = 0.f, b = 0.f, d = 0.f;
+                Texel x0 = {}, x1 = {};
+                for (int i = 0; i < BLOCK_TEXELS; i++) {
+                    if (skip[i]) continue;
+                    float w  = weights[cur.indices[i]];
+                    float iw = 1.f - w;
+                    a += iw * iw;
+                    b += iw * w;
+                    d += w * w;
+                    for (int c = 0; c < channels; c++) {
+                        x0[c] += iw * texels[i][c];
+                        x1[c] += w * texels[i][c];
+                    }
+                }
+                float det = a * d - b * b;
+                if (std::abs(det) < 1e-6f) break;
+                for (int c = 0; c < channels; c++) {
+                    cur.e0[c] = (d * x0[c] - b * x1[c]) / det;
+                    cur.e1[c] = (a * x1[c] - b * x0[c]) / det;
+                }
+            }
+            return best;
+        }
+
+        void load_texels(const std::uint8_t* rgba, Texel* texels) {
+            for (int i = 0; i < BLOCK_TEXELS; i++) {
+                for (int c = 0; c < 4; c++) texels[i][c] = rgba[i * 4 + c];
+            }
+        }
+
+        void put16(std::uint8_t* out, std::uint16_t v) {
+            out[0] = static_cast<std::uint8_t>(v);
+            out[1] = static_cast<std::uint8_t>(v >> 8);
+        }
+
+        std::uint16_t get16(const std::uint8_t* in) {
+            return static_cast<std::uint16_t>(in[0] | (in[1] << 8));
+        }
+
+        /**
+        * Little endian bit stream of a 128 bit BC7 block.
+        */
+        class BitWriter {
+        public:
+            explicit BitWriter(std::uint8_t* data) : m_Data(data), m_Pos(0) {}
+
+            void write(std::uint32_t value, std::uint32_t bits) {
+                for (std::uint32_t i = 0; i < bits; i++, m_Pos++) {
+                    if ((value >> i) & 1u) m_Data[m_Pos >> 3] |= static_cast<std::uint8_t>(1u << (m_Pos & 7));
+                }
+            }
+        private:
+            std::uint8_t* m_Data;
+            std::uint32_t m_Pos;
+        };
+
+        class BitReader {
+        public:
+            explicit BitReader(const std::uint8_t* data) : m_Data(data), m_Pos(0) {}
+
+            std::uint32_t read(std::uint32_t bits) {
+                std::uint32_t value = 0;
+                for (std::uint32_t i = 0; i < bits; i++, m_Pos++) {
+                    value |= static_cast<std::uint32_t>((m_Data[m_Pos >> 3] >> (m_Pos & 7)) & 1u) << i;
+                }
+                return value;
+            }
+        private:
+            const std::uint8_t* m_Data;
+            std::uint32_t       m_Pos;
+        };
+
+    }
+
+    // BC1
+
+    namespace {
+
+        std::uint16_t pack565(const Texel& t) {
+            auto r = static_cast<std::uint16_t>(std::lround(t[0] * 31.f / 255.f));
+            auto g = static_cast<std::uint16_t>(std::lround(t[1] * 63.f / 255.f));
+            auto b = static_cast<std::uint16_t>(std::lround(t[2] * 31.f / 255.f));
+            return static_cast<std::uint16_t>((r << 11) | (g << 5) | b);
+        }
+
+        std::array<int, 3> unpack565(std::uint16_t v) {
+            int r = (v >> 11) & 31;
+            int g = (v >> 5) & 63;
+            int b = v & 31;
+            return { (r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2) };
+        }
+
+        void quantize565(Texel& e0, Texel& e1) {
+            for (Texel* e : { &e0, &e1 }) {
+                auto v = unpack565(pack565(*e));
+                for (int c = 0; c < 3; c++) (*e)[c] = static_cast<float>(v[c]);
+            }
+        }
+
+        /**
+        * @param punch_through Texels with alpha < 128 use the transparent entry of three color blocks
+        */
+        void encode_bc1_color(const std::uint8_t* rgba, std::uint8_t* block, bool punch_through) {
+            Texel texels[BLOCK_TEXELS];
+            load_texels(rgba, texels);
+
+            bool skip[BLOCK_TEXELS];
+            int  transparent = 0;
+            for (int i = 0; i < BLOCK_TEXELS; i++) {
+                skip[i]      = punch_through && rgba[i * 4 + 3] < 128;
+                transparent += skip[i];
+            }
+            if (transparent == BLOCK_TEXELS) {
+                // c0 == c1 selects three color mode, index 3 is transparent black.
+                std::memset(block, 0, 4);
+                std::memset(block + 4, 0xFF, 4);
+                return;
+            }
+
+            static constexpr std::array<float, 4> FOUR_COLOR  = { 0.f, 1.f, 1.f / 3.f, 2.f / 3.f };
+            static constexpr std::array<float, 3> THREE_COLOR = { 0.f, 1.f, 0.5f };
+            std::span<const float> weights = transparent ? std::span<const float>(THREE_COLOR) : std::span<const float>(FOUR_COLOR);
+            Fit fit = fit_block(texels, skip, 3, weights, quantize565);
+
+            std::uint16_t c0 = pack565(fit.e0);
+            std::uint16_t c1 = pack565(fit.e1);
+            if (transparent) {
+                // Three color blocks need c0 <= c1.
+                if (c0 > c1) {
+                    std::swap(c0, c1);
+                    for (auto& idx : fit.indices) if (idx < 2) idx ^= 1;
+                }
+                for (int i = 0; i < BLOCK_TEXELS; i++) if (skip[i]) fit.indices[i] = 3;
+            }
+            else if (c0 < c1) {
+                // Four color blocks need c0 > c1, swapping the endpoints mirrors the palette.
+                std::swap(c0, c1);
+                for (auto& idx : fit.indices) idx ^= 1;
+            }
+            else if (c0 == c1) {
+                fit.indices.fill(0);
+            }
+
+            std::uint32_t bits = 0;
+            for (int i = 0; i < BLOCK_TEXELS; i++) bits |= static_cast<std::uint32_t>(fit.indices[i]) << (i * 2);
+            put16(block, c0);
+            put16(block + 2, c1);
+            for (int i = 0; i < 4; i++) block[4 + i] = static_cast<std::uint8_t>(bits >> (i * 8));
+        }
+
+        /**
+        * @param four_color BC3 color blocks always use four colors
+        */
+        void decode_bc1_color(const std::uint8_t* block, std::uint8_t* texels, bool four_color) {
+            std::uint16_t c0 = get16(block);
+            std::uint16_t c1 = get16(block + 2);
+            auto          p0 = unpack565(c0);
+            auto          p1 = unpack565(c1);
+
+            std::uint8_t palette[4][4];
+            for (int c = 0; c < 3; c++) {
+                palette[0][c] = static_cast<std::uint8_t>(p0[c]);
+                palette[1][c] = static_cast<std::uint8_t>(p1[c]);
+                if (four_color || c0 > c1) {
+                    palette[2][c] = static_cast<std::uint8_t>((2 * p0[c] + p1[c]) / 3);
+                    palette[3][c] = static_cast<std::uint8_t>((p0[c] + 2 * p1[c]) / 3);
+                }
+                else {
+                    palette[2][c] = static_cast<std::uint8_t>((p0[c] + p1[c]) / 2);
+                    palette[3][c] = 0;
+                }
+            }
+            palette[0][3] = palette[1][3] = palette[2][3] = 255;
+            palette[3][3] = (four_color || c0 > c1) ? 255 : 0;
+
+            std::uint32_t bits = block[4] | (block[5] << 8) | (block[6] << 16) | (static_cast<std::uint32_t>(block[7]) << 24);
+            for (int i = 0; i < BLOCK_TEXELS; i++) {
+                std::memcpy(texels + i * 4, palette[(bits >> (i * 2)) & 3], 4);
+            }
+        }
+
+    }
+
+    // BC3
+
+    namespace {
+
+        /**
+        * Alpha palette of a BC3/BC4 block, 8 interpolated values if a0 > a1,
+        * otherwise 6 interpolated values followed by 0 and 255.
+        */
+        std::array<int, 8> alpha_palette(int a0, int a1) {
+            std::array<int, 8> p{ a0, a1 };
+            if (a0 > a1) {
+                for (int i = 2; i < 8; i++) p[i] = ((8 - i) * a0 + (i - 1) * a1) / 7;
+            }
+            else {
+                for (int i = 2; i < 6; i++) p[i] = ((6 - i) * a0 + (i - 1) * a1) / 5;
+                p[6] = 0;
+                p[7] = 255;
+            }
+            return p;
+        }
+
+        void encode_alpha(const std::uint8_t* rgba, std::uint8_t* block) {
+            int lo = 255, hi = 0;
+            int inner_lo = 255, inner_hi = 0;
+            for (int i = 0; i < BLOCK_TEXELS; i++) {
+                int a = rgba[i * 4 + 3];
+                lo = std::min(lo, a);
+                hi = std::max(hi, a);
+                if (a != 0 && a != 255) {
+                    inner_lo = std::min(inner_lo, a);
+                    inner_hi = std::max(inner_hi, a);
+                }
+            }
+            if (inner_lo > inner_hi) inner_lo = inner_hi = lo;
+
+            // Either spread 8 values over the whole range, or 6 over the values between
+            // 0 and 255 when the block mixes fully transparent/opaque texels with soft edges.
+            struct Candidate { int a0, a1; };
+            const Candidate candidates[2] = {
+                { hi, lo },
+                { inner_lo, inner_hi },
+            };
+
+            std::uint64_t best_bits  = 0;
+            int           best_error = std::numeric_limits<int>::max();
+            Candidate     best       = candidates[0];
+            for (const Candidate& candidate : candidates) {
+                auto          palette = alpha_palette(candidate.a0, candidate.a1);
+                std::uint64_t bits    = 0;
+                int           error   = 0;
+                for (int i = 0; i < BLOCK_TEXELS; i++) {
+                    int a    = rgba[i * 4 + 3];
+                    int pick = 0;
+                    int err  = std::numeric_limits<int>::max();
+                    for (int k = 0; k < 8; k++) {
+                        int e = std::abs(palette[k] - a);
+                        if (e < err) {
+                            err  = e;
+                            pick = k;
+                        }
+                    }
+                    error += err * err;
+                    bits  |= static_cast<std::uint64_t>(pick) << (i * 3);
+                }
+                if (error < best_error) {
+                    best_error = error;
+                    best_bits  = bits;
+                    best       = candidate;
+                }
+            }
+
+            block[0] = static_cast<std::uint8_t>(best.a0);
+            block[1] = static_cast<std::uint8_t>(best.a1);
+            for (int i = 0; i < 6; i++) block[2 + i] = static_cast<std::uint8_t>(best_bits >> (i * 8));
+        }
+
+        void decode_alpha(const std::uint8_t* block, std::uint8_t* texels) {
+            auto          palette = alpha_palette(block[0], block[1]);
+            std::uint64_t bits    = 0;
+            for (int i = 0; i < 6; i++) bits |= static_cast<std::uint64_t>(block[2 + i]) << (i * 8);
+            for (int i = 0; i < BLOCK_TEXELS; i++) {
+                texels[i * 4 + 3] = static_cast<std::uint8_t>(palette[(bits >> (i * 3)) & 7]);
+            }
+        }
+
+    }
+
+    // BC7
+
+    namespace {
+
+        constexpr std::array<int, 16> BC7_WEIGHTS4 = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+        constexpr std::uint32_t       BC7_MODE6    = 6;
+
+        constexpr std::array<float, 16> bc7_weights() {
+            std::array<float, 16> w{};
+            for (std::size_t i = 0; i < w.size(); i++) w[i] = static_cast<float>(BC7_WEIGHTS4[i]) / 64.f;
+            return w;
+        }
+
+        /**
+        * Mode 6 endpoints are 7 bits per channel plus a p-bit shared by the channels of the endpoint.
+        */
+        void quantize_mode6(Texel& e0, Texel& e1) {
+            for (Texel* e : { &e0, &e1 }) {
+                Texel best_value;
+                float best_error = std::numeric_limits<float>::max();
+                for (int p = 0; p < 2; p++) {
+                    Texel value;
+                    float error = 0.f;
+                    for (int c = 0; c < 4; c++) {
+                        float q  = std::clamp(std::round(((*e)[c] - static_cast<float>(p)) / 2.f), 0.f, 127.f);
+                        value[c] = q * 2.f + static_cast<float>(p);
+                        error   += (value[c] - (*e)[c]) * (value[c] - (*e)[c]);
+                    }
+                    if (error < best_error) {
+                        best_error = error;
+                        best_value = value;
+                    }
+                }
+                *e = best_value;
+            }
+        }
+
+        void encode_bc7(const std::uint8_t* rgba, std::uint8_t* block) {
+            Texel texels[BLOCK_TEXELS];
+            load_texels(rgba, texels);
+            bool skip[BLOCK_TEXELS] = {};
+
+            static constexpr auto WEIGHTS = bc7_weights();
+            Fit fit = fit_block(texels, skip, 4, WEIGHTS, quantize_mode6);
+
+            // The MSB of the first index is implied zero (anchor), mirror the palette if it is set.
+            if (fit.indices[0] >= 8) {
+                std::swap(fit.e0, fit.e1);
+                for (auto& idx : fit.indices) idx = static_cast<std::uint8_t>(15 - idx);
+            }
+
+            std::array<std::uint32_t, 2> ep[4];
+            std::uint32_t p0 = static_cast<std::uint32_t>(fit.e0[0]) & 1u;
+            std::uint32_t p1 = static_cast<std::uint32_t>(fit.e1[0]) & 1u;
+            for (int c = 0; c < 4; c++) {
+                ep[c] = { static_cast<std::uint32_t>(fit.e0[c]) >> 1, static_cast<std::uint32_t>(fit.e1[c]) >> 1 };
+            }
+
+            std::memset(block, 0, 16);
+            BitWriter bits(block);
+            bits.write(1u << BC7_MODE6, BC7_MODE6 + 1);
+            for (int c = 0; c < 4; c++) {
+                bits.write(ep[c][0], 7);
+                bits.write(ep[c][1], 7);
+            }
+            bits.write(p0, 1);
+            bits.write(p1, 1);
+            bits.write(fit.indices[0], 3);
+            for (int i = 1; i < BLOCK_TEXELS; i++) bits.write(fit.indices[i], 4);
+        }
+
+        bool decode_bc7(const std::uint8_t* block, std::uint8_t* texels) {
+            if ((block[0] & 0x7F) != (1u << BC7_MODE6)) return false;
+
+            BitReader bits(block);
+            bits.read(BC7_MODE6 + 1);
+            int ep[4][2];
+            for (int c = 0; c < 4; c++) {
+                ep[c][0] = static_cast<int>(bits.read(7)) << 1;
+                ep[c][1] = static_cast<int>(bits.read(7)) << 1;
+            }
+            int p0 = static_cast<int>(bits.read(1));
+            int p1 = static_cast<int>(bits.read(1));
+            for (int c = 0; c < 4; c++) {
+                ep[c][0] |= p0;
+                ep[c][1] |= p1;
+            }
+            for (int i = 0; i < BLOCK_TEXELS; i++) {
+                int w = BC7_WEIGHTS4[bits.read(i == 0 ? 3 : 4)];
+                for (int c = 0; c < 4; c++) {
+                    texels[i * 4 + c] = static_cast<std::uint8_t>(((64 - w) * ep[c][0] + w * ep[c][1] + 32) >> 6);
+                }
+            }
+            return true;
+        }
+
+    }
+
+    void encode_block(EBlockFormat format, const std::uint8_t* texels, std::uint8_t* block) {
+        switch (format) {
+            case EBlockFormat::BC1:
+                encode_bc1_color(texels, block, true);
+                break;
+            case EBlockFormat::BC3:
+                encode_alpha(texels, block);
+                encode_bc1_color(texels, block + 8, false);
+                break;
+            case EBlockFormat::BC7:
+                encode_bc7(texels, block);
+                break;
+            default:
+                break;
+        }
+    }
+
+    bool decode_block(EBlockFormat format, const std::uint8_t* block, std::uint8_t* texels) {
+        switch (format) {
+            case EBlockFormat::BC1:
+                decode_bc1_color(block, texels, false);
+                return true;
+            case EBlockFormat::BC3:
+                decode_bc1_color(block + 8, texels, true);
+                decode_alpha(block, texels);
+                return true;
+            case EBlockFormat::BC7:
+                return decode_bc7(block, texels);
+            default:
+                return false;
+        }
+    }
+
+    void encode_image(EBlockFormat format, std::span<const std::uint8_t> rgba, std::uint32_t width, std::uint32_t height, std::span<std::uint8_t> blocks) {
+        const std::uint32_t stride = block_bytes(format);
+        if (stride == 0 || width == 0 || height == 0) return;
+        if (rgba.size() < static_cast<std::size_t>(width) * height * 4 || blocks.size() < block_image_bytes(format, width, height)) return;
+
+        std::uint8_t  texels[BLOCK_TEXELS * 4];
+        std::uint8_t* out = blocks.data();
+        for (std::uint32_t by = 0; by < height; by += BLOCK_DIM) {
+            for (std::uint32_t bx = 0; bx < width; bx += BLOCK_DIM) {
+                for (std::uint32_t y = 0; y < BLOCK_DIM; y++) {
+                    std::uint32_t sy = std::min(by + y, height - 1);
+                    for (std::uint32_t x = 0; x < BLOCK_DIM; x++) {
+                        std::uint32_t sx = std::min(bx + x, width - 1);
+                        std::memcpy(texels + (y * BLOCK_DIM + x) * 4, rgba.data() + (static_cast<std::size_t>(sy) * width + sx) * 4, 4);
+                    }
+                }
+                encode_block(format, texels, out);
+                out += stride;
+            }
+        }
+    }
+
+    bool decode_image(EBlockFormat format, std::span<const std::uint8_t> blocks, std::uint32_t width, std::uint32_t height, std::span<std::uint8_t> rgba) {
+        const std::uint32_t stride = block_bytes(format);
+        if (stride == 0) return false;
+        if (rgba.size() < static_cast<std::size_t>(width) * height * 4 || blocks.size() < block_image_bytes(format, width, height)) return false;
+
+        std::uint8_t        texels[BLOCK_TEXELS * 4];
+        const std::uint8_t* in = blocks.data();
+        for (std::uint32_t by = 0; by < height; by += BLOCK_DIM) {
+            for (std::uint32_t bx = 0; bx < width; bx += BLOCK_DIM) {
+                if (!decode_block(format, in, texels)) return false;
+                in += stride;
+                for (std::uint32_t y = 0; y < BLOCK_DIM && by + y < height; y++) {
+                    std::uint32_t cols = std::min(BLOCK_DIM, width - bx);
+                    std::memcpy(rgba.data() + (static_cast<std::size_t>(by + y) * width + bx) * 4, texels + y * BLOCK_DIM * 4, cols * 4);
+                }
+            }
+        }
+        return true;
+    }
+
+}
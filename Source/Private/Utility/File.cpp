@@ -3,6 +3,7 @@
 
 #include <fstream>
 #include <sstream>
+#include <thread>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -166,6 +167,34 @@ namespace aby::util {
         return {};
     }
 
+    FileError File::write_atomic(std::initializer_list<std::span<const std::byte>> parts) {
+        std::error_code ec;
+        std::filesystem::create_directories(m_Path.parent_path(), ec);
+
+        std::filesystem::path tmp = m_Path;
+        tmp += std::format(".{}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+        {
+            std::ofstream ofs(tmp, std::ios::out | std::ios::binary | std::ios::trunc);
+            if (!ofs.is_open())
+                return std::format("Failed to open file for writing: {}", tmp);
+
+            for (auto part : parts) {
+                ofs.write(reinterpret_cast<const char*>(part.data()), part.size());
+            }
+            if (!ofs) {
+                ofs.close();
+                std::filesystem::remove(tmp, ec);
+                return std::format("Failed to write to file: {}", tmp);
+            }
+        }
+        std::filesystem::rename(tmp, m_Path, ec);
+        if (ec) {
+            std::filesystem::remove(tmp, ec);
+            return std::format("Failed to replace file: {}", m_Path);
+        }
+        return {};
+    }
+
     std::expected<MappedFile, FileError> File::map() {
         MappedFile file(m_Path);
         if (!file) return std::unexpected(file.error());
@@ -4,9 +4,6 @@
 #include "Platform/Platform.h"
 
 
-//#define ASYNC_RESOURCE_LOADING
-
-
 namespace aby::util {
 
     Thread::~Thread() {
@@ -31,84 +28,291 @@ namespace aby::util {
         m_Thread.detach();
     }
 
-    LoadThread::LoadThread(QueryResourceNextHandle query_next_handle) :
-        Thread([this]() { 
-            load();
-        }, "Load Thread"),
-        m_QueryNextHandle(std::move(query_next_handle)),
-        m_FinishState(EFinishState::CONTINUE) 
+    LoadNode::LoadNode(std::string name, ELoadAffinity affinity, std::function<void()> fn) :
+        m_Name(std::move(name)),
+        m_Affinity(affinity),
+        m_Fn(std::move(fn)),
+        m_Remaining(0),
+        m_Mutex(),
+        m_Done(false),
+        m_Dependents(),
+        m_Dependencies(),
+        m_Start(),
+        m_End()
     {
-    #ifndef ASYNC_RESOURCE_LOADING
-        m_FinishState.store(EFinishState::FINISH);
-        m_Thread.join();
-    #endif
     }
 
-    LoadThread::~LoadThread() {
-    #ifdef ASYNC_RESOURCE_LOADING
-        m_FinishState.store(EFinishState::FINISH, std::memory_order_release);
-        m_Thread.detach();
-    #endif
+    const std::string& LoadNode::name() const {
+        return m_Name;
     }
 
-    Resource LoadThread::add_task(EResource type, Task&& task) {
-        Resource::Handle next_handle   = m_QueryNextHandle(type);
-        std::size_t      next_position = m_Tasks.count(type);
-        Resource::Handle handle        = static_cast<Resource::Handle>(next_position + next_handle);
-    #ifdef ASYNC_RESOURCE_LOADING
-        std::lock_guard  lock_guard(m_Mutex);
-        m_Tasks.emplace(type, std::move(task));
-        ABY_DBG("LoadThread::add_task(...) Resource[ type: {}, handle: {} ]", static_cast<int>(type), handle);
-        return Resource{ type, handle };
-    #else     
-        task();
-        return Resource(type, handle);
-    #endif
+    ELoadAffinity LoadNode::affinity() const {
+        return m_Affinity;
     }
 
-    std::size_t LoadThread::tasks() const {
-        return m_Tasks.size();
+    bool LoadNode::done() const {
+        std::lock_guard lock(m_Mutex);
+        return m_Done;
     }
 
-    void LoadThread::sync() {
-    #ifdef ASYNC_RESOURCE_LOADING
-        if (m_Tasks.empty() || m_FinishState.load(std::memory_order_acquire) == EFinishState::FINISH) return; 
-        std::lock_guard lock(m_Mutex);
-        while (!m_Tasks.empty()) {
-            auto it = m_Tasks.begin();
-            Task task = it->second;
-            m_Tasks.erase(it);
-            task();
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
-        }
-        m_FinishState.store(EFinishState::FINISH, std::memory_order_release);
-        m_Tasks.clear();
-    #endif
-    }
-
-    void LoadThread::load() {
-    #ifdef ASYNC_RESOURCE_LOADING
-        while (m_FinishState.load(std::memory_order_acquire) != EFinishState::FINISH) {
-            std::lock_guard lock(m_Mutex);
-            if (!m_Tasks.empty()) {
-                auto it = m_Tasks.begin();
-                Task task = std::move(it->second);
-                m_Tasks.erase(it);
-                task();
+    float LoadNode::duration() const {
+        return std::chrono::duration<float, std::milli>(m_End - m_Start).count();
+    }
+
+    static constexpr std::size_t LOAD_POOL_QUEUE_CAPACITY = 1024;
+
+    LoadPool::LoadPool(std::size_t threads) :
+        m_Jobs(LOAD_POOL_QUEUE_CAPACITY),
+        m_Finished(),
+        m_Signal(0),
+        m_Running(true),
+        m_Submitted(0),
+        m_Completed(0),
+        m_Finalized(0),
+        m_Threads(),
+        m_LatestMutex(),
+        m_Latest(nullptr),
+        m_CriticalPath()
+    {
+        if (threads == 0) {
+            u32 cores = std::thread::hardware_concurrency();
+            threads   = cores > 1 ? cores - 1 : 1;
+        }
+        m_Threads.reserve(threads);
+        for (std::size_t i = 0; i < threads; i++) {
+            m_Threads.push_back(create_unique<Thread>([this]() {
+                worker();
+            }, std::format("Load Thread {}", i)));
+        }
+    }
+
+    LoadPool::~LoadPool() {
+        m_Running.store(false, std::memory_order_release);
+        m_Signal.release(static_cast<std::ptrdiff_t>(m_Threads.size()));
+        for (auto& thread : m_Threads) {
+            thread->join();
+        }
+    }
+
+    void LoadPool::add_task(Task&& finalize) {
+        m_Submitted.fetch_add(1, std::memory_order_relaxed);
+        finish(std::move(finalize));
+    }
+
+    LoadPool::Node LoadPool::add_node(std::string name, ELoadAffinity affinity, Task&& fn, const std::vector<Node>& deps) {
+        Node node(new LoadNode(std::move(name), affinity, std::move(fn)));
+        m_Submitted.fetch_add(1, std::memory_order_relaxed);
+
+        // One extra count guards against a dependency completing while edges are still being added.
+        u32 remaining = 1;
+        for (auto& dep : deps) {
+            if (!dep) continue;
+            node->m_Dependencies.push_back(dep);
+            std::lock_guard lock(dep->m_Mutex);
+            if (!dep->m_Done) {
+                dep->m_Dependents.push_back(node);
+                remaining++;
             }
-            switch (m_FinishState.load(std::memory_order_acquire)) {
-                using enum EFinishState;
-                case FINISH: 
-                    return;
-                case CONTINUE:
-                    continue;
-                default:
-                    ABY_WARN("Load Thread was left an invalid state.");
-                    m_FinishState.store(EFinishState::CONTINUE, std::memory_order_release);
-                    break;
+        }
+        node->m_Remaining.fetch_add(remaining, std::memory_order_relaxed);
+        if (node->m_Remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            schedule(node);
+        }
+        return node;
+    }
+
+    void LoadPool::schedule(const Node& node) {
+        switch (node->m_Affinity) {
+            case ELoadAffinity::WORKER:
+                enqueue([this, node]() -> Task {
+                    execute(node);
+                    return nullptr;
+                });
+                break;
+            case ELoadAffinity::MAIN:
+                finish([this, node]() {
+                    execute(node);
+                });
+                break;
+        }
+    }
+
+    void LoadPool::execute(const Node& node) {
+        node->m_Start = LoadNode::Clock::now();
+        if (node->m_Fn) {
+            node->m_Fn();
+        }
+        node->m_End = LoadNode::Clock::now();
+        complete(node);
+    }
+
+    void LoadPool::complete(const Node& node) {
+        std::vector<Node> dependents;
+        {
+            std::lock_guard lock(node->m_Mutex);
+            node->m_Done = true;
+            dependents   = std::move(node->m_Dependents);
+        }
+        {
+            std::lock_guard lock(m_LatestMutex);
+            if (!m_Latest || node->m_End >= m_Latest->m_End) {
+                m_Latest = node;
+            }
+        }
+        for (auto& dependent : dependents) {
+            if (dependent->m_Remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                schedule(dependent);
+            }
+        }
+    }
+
+    void LoadPool::add_work(Work&& work) {
+        m_Submitted.fetch_add(1, std::memory_order_relaxed);
+        enqueue(std::move(work));
+    }
+
+    void LoadPool::parallel_for(std::size_t count, const std::function<void(std::size_t)>& fn) {
+        if (count == 0) return;
+        struct Shared {
+            std::atomic<std::size_t>                next  = 0;
+            std::atomic<std::size_t>                done  = 0;
+            std::size_t                             count = 0;
+            const std::function<void(std::size_t)>* fn    = nullptr;
+        };
+        auto shared   = create_ref<Shared>();
+        shared->count = count;
+        shared->fn    = &fn;
+
+        // Helpers that start after every index was taken return straight away, fn is only
+        // touched for taken indices which all finish before this returns.
+        auto drain = [](Shared& s) {
+            for (std::size_t i = s.next.fetch_add(1, std::memory_order_relaxed); i < s.count; i = s.next.fetch_add(1, std::memory_order_relaxed)) {
+                (*s.fn)(i);
+                if (s.done.fetch_add(1, std::memory_order_acq_rel) + 1 == s.count) {
+                    s.done.notify_all();
+                }
             }
+        };
+        std::size_t helpers = std::min(count - 1, m_Threads.size());
+        for (std::size_t i = 0; i < helpers; i++) {
+            add_work([shared, drain]() -> Task {
+                drain(*shared);
+                return nullptr;
+            });
         }
-    #endif
+        drain(*shared);
+        for (std::size_t done = shared->done.load(std::memory_order_acquire); done != count; done = shared->done.load(std::memory_order_acquire)) {
+            shared->done.wait(done, std::memory_order_acquire);
+        }
+    }
+
+    void LoadPool::enqueue(Work&& work) {
+        if (m_Jobs.try_push(std::move(work))) {
+            m_Signal.release();
+        }
+        else {
+            ABY_WARN("LoadPool queue is full, running load inline");
+            run(work);
+        }
+    }
+
+    std::size_t LoadPool::tasks() const {
+        return static_cast<std::size_t>(m_Submitted.load(std::memory_order_acquire) - m_Finalized);
+    }
+
+    std::size_t LoadPool::threads() const {
+        return m_Threads.size();
+    }
+
+    void LoadPool::run(Work& work) {
+        finish(work());
+    }
+
+    void LoadPool::finish(Task&& finalize) {
+        m_Finished.push(std::move(finalize));
+        m_Completed.fetch_add(1, std::memory_order_release);
+        m_Completed.notify_all();
+    }
+
+    void LoadPool::worker() {
+        while (true) {
+            m_Signal.acquire();
+            if (!m_Running.load(std::memory_order_acquire)) {
+                return;
+            }
+            Work work;
+            while (m_Jobs.try_pop(work)) {
+                run(work);
+            }
+        }
+    }
+
+    std::size_t LoadPool::poll() {
+        return m_Finished.drain([this](Task&& finalize) {
+            if (finalize) {
+                finalize();
+            }
+            m_Finalized++;
+        });
+    }
+
+    void LoadPool::sync() {
+        while (m_Finalized != m_Submitted.load(std::memory_order_acquire)) {
+            u64 completed = m_Completed.load(std::memory_order_acquire);
+            if (poll() > 0) {
+                continue;
+            }
+            Work work;
+            if (m_Jobs.try_pop(work)) {
+                run(work);
+                continue;
+            }
+            m_Completed.wait(completed, std::memory_order_acquire);
+        }
+        report_critical_path();
+    }
+
+    void LoadPool::report_critical_path() {
+        Node node;
+        {
+            std::lock_guard lock(m_LatestMutex);
+            node = std::move(m_Latest);
+            m_Latest = nullptr;
+        }
+        if (!node) return;
+
+        m_CriticalPath.clear();
+        std::vector<Node> chain;
+        while (node) {
+            chain.push_back(node);
+            Node gate = nullptr;
+            for (auto& dep : node->m_Dependencies) {
+                if (!gate || dep->m_End > gate->m_End) {
+                    gate = dep;
+                }
+            }
+            node = gate;
+        }
+
+        auto origin = chain.back()->m_Start;
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+            m_CriticalPath.push_back(LoadStep{
+                .name     = (*it)->m_Name,
+                .affinity = (*it)->m_Affinity,
+                .start    = std::chrono::duration<float, std::milli>((*it)->m_Start - origin).count(),
+                .duration = (*it)->duration(),
+            });
+        }
+
+        auto total = std::chrono::duration<float, std::milli>(chain.front()->m_End - origin).count();
+        ABY_LOG("Load critical path: {}ms", total);
+        for (auto& step : m_CriticalPath) {
+            ABY_LOG("  [+{}ms] {} ({}): {}ms", step.start, step.name, step.affinity == ELoadAffinity::MAIN ? "Main" : "Worker", step.duration);
+        }
+    }
+
+    const std::vector<LoadStep>& LoadPool::critical_path() const {
+        return m_CriticalPath;
     }
 
 }
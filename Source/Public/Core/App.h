@@ -6,6 +6,7 @@
 #include "Rendering/Context.h"
 #include "Rendering/Renderer.h"
 #include "Rendering/Dockspace.h"
+#include "Utility/Archive.h"
 #include <filesystem>
 
 namespace aby {
@@ -45,6 +46,10 @@ namespace aby {
 		const AppInfo& info() const;
 		const std::string& name() const;
 		const AppVersion&  version() const;
+		/**
+		* Asset archive next to the executable (see aby_package), nullptr if none was packaged.
+		*/
+		const util::Archive* archive() const;
 
 		fs::path    	cache();
 		fs::path    	bin();
@@ -60,6 +65,7 @@ namespace aby {
 	private:
 		static fs::path m_ExePath;
 		AppInfo         m_Info;
+		Unique<util::Archive> m_Archive;
 		Unique<Window>  m_Window;
 		Ref<Context>    m_Ctx;
 		Ref<Renderer>   m_Renderer;
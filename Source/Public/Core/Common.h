@@ -224,6 +224,18 @@ namespace aby {
         bool        binherit = true; 
         // Rendering backend.
         EBackend    backend  = EBackend::DEFAULT; 
+        // Bytes of cpu side texture data kept before least recently used copies are dropped.
+        u64         texture_cpu_budget = 256ull << 20;
+        // Bytes of texture images kept before least recently used file textures are unloaded.
+        u64         texture_gpu_budget = 512ull << 20;
+        // Bytes of the staging ring texture uploads are copied through before being flushed with a frame.
+        u64         upload_ring_bytes  = 64ull << 20;
+        // Bytes of full resolution streamed textures (ETextureLoad::STREAM) uploaded per frame.
+        u64         texture_stream_budget = 16ull << 20;
+        // Store decoded image files under App::cache() and map them on later launches instead of decoding (ImageCache).
+        bool        cache_images = false;
+        // Draw 2D/3D vertices in the 24 byte packed layout (PackedVertex.glsl), texcoords must stay in [0, 1].
+        bool        packed_vertices = false;
     };
     
     enum class ECursor {
@@ -1,11 +1,11 @@
 #pragma once
 #include "Core/Common.h"
 #include "Core/Log.h"
-#include <unordered_map>
-#include <queue>
+#include "Core/ResourceStats.h"
 #include <vector>
 #include <any>
 #include <numeric>
+#include <utility>
 
 namespace aby {
 
@@ -40,10 +40,23 @@ namespace aby {
         }
     }
 
+    /**
+    * A typed handle into a ResourceClass.
+    * 
+    * The handle is split into a slot index (low bits) and a generation (high bits).
+    * The generation is bumped whenever a slot is erased so stale handles can be
+    * detected instead of silently aliasing whatever reuses the slot.
+    * A freshly used slot has generation zero, so the handle equals the slot index.
+    */
     class Resource {
     public:
         using Handle = u32;
-        static constexpr size_t null = std::numeric_limits<Handle>::max();
+        static constexpr size_t null            = std::numeric_limits<Handle>::max();
+        static constexpr Handle INDEX_BITS      = 20;
+        static constexpr Handle GENERATION_BITS = 32 - INDEX_BITS;
+        static constexpr Handle INDEX_MASK      = (1u << INDEX_BITS) - 1;
+        static constexpr Handle GENERATION_MASK = (1u << GENERATION_BITS) - 1;
+        static constexpr Handle MAX_INDEX       = INDEX_MASK - 1; /// INDEX_MASK is reserved so null never names a slot.
     public:
         Resource();
         Resource(EResource type, Handle handle);
@@ -52,12 +65,30 @@ namespace aby {
 
         EResource type() const;
         Handle    handle() const;
+        /**
+        * Slot index of the handle, used for array indexing (e.g. bindless texture slots).
+        */
+        Handle    index() const;
+        /**
+        * Generation of the slot at the time the handle was issued.
+        */
+        Handle    generation() const;
 
         explicit operator bool() const;
         Resource& operator=(const Resource&) = default;
         Resource& operator=(Resource&&) noexcept = default;
         bool operator==(const Resource& other) const;
         bool operator!=(const Resource& other) const;
+    public:
+        static constexpr Handle make_handle(Handle index, Handle generation) {
+            return ((generation & GENERATION_MASK) << INDEX_BITS) | (index & INDEX_MASK);
+        }
+        static constexpr Handle index_of(Handle handle) {
+            return handle & INDEX_MASK;
+        }
+        static constexpr Handle generation_of(Handle handle) {
+            return (handle >> INDEX_BITS) & GENERATION_MASK;
+        }
     private:
         EResource m_Type;
         Handle m_Handle;
@@ -72,48 +103,168 @@ namespace aby {
         virtual ~IResourceHandler() = default;
 
         virtual void on_add(Handle handle, Ref<T> resource) = 0;
+        /**
+        * A resource left its handle: erased, or swapped out by replace() or unload() (never the placeholder).
+        */
         virtual void on_erase(Handle handle, Ref<T> resource) = 0;
     protected:
         std::any m_UserData;
     };
 
+    /**
+    * Generational slot map of resources.
+    * 
+    * Lookups index straight into a slot array, resources are stored densely so
+    * iteration is contiguous, and erased slots are recycled with a bumped generation.
+    * 
+    * Asynchronous loads reserve a handle up front. Until the load is finalized the
+    * handle resolves to the class placeholder (e.g. the 1x1 white texture), afterwards
+    * replace() swaps the real resource in. A ResourceClass is only mutated on the
+    * main thread, so a swap never happens in the middle of a frame.
+    */
     template <typename T> requires (CIsResource<T>)
     class ResourceClass {
     public:
-        using Handle = Resource::Handle;
-        
+        using Handle  = Resource::Handle;
         using Handler = IResourceHandler<T>;
+        using Entry   = std::pair<Handle, Ref<T>>;
 
-        template <typename Value>
-        using Map = std::unordered_map<Handle, Value>;
+        static constexpr u32 npos = std::numeric_limits<u32>::max();
 
         void assert_contains(Resource resource) const {
             ABY_ASSERT(resource.type() == TypeToEResource<T>(), "Resource type mismatch");
-            ABY_ASSERT(m_Resources.contains(resource.handle()), "Resource(Type: {}, Handle: {}) not found!",
+            ABY_ASSERT(contains(resource), "Resource(Type: {}, Handle: {}, Index: {}, Generation: {}) not found or stale!",
                 static_cast<std::underlying_type_t<EResource>>(resource.type()),
-                resource.handle()
+                resource.handle(),
+                resource.index(),
+                resource.generation()
             );
         }
     public:
-        ResourceClass() : m_NextHandle(0) {}
+        ResourceClass() : m_FreeHead(npos), m_Placeholder(nullptr), m_LoadStats() {}
 
         Resource add(Ref<T> ptr) {
-            Handle handle = get_next_handle();
+            Handle handle = insert(ptr);
             for (auto& handler : m_Handlers) {
                 handler->on_add(handle, ptr);
             }
-            m_Resources.emplace(handle, std::move(ptr));
             return Resource(TypeToEResource<T>(), handle);
         }
 
+        /**
+        * Reserve a handle bound to the placeholder until replace() is called.
+        */
+        Resource reserve() {
+            Handle handle = insert(m_Placeholder);
+            m_Slots[Resource::index_of(handle)].ready = false;
+            if (m_Placeholder) {
+                for (auto& handler : m_Handlers) {
+                    handler->on_add(handle, m_Placeholder);
+                }
+            }
+            return Resource(TypeToEResource<T>(), handle);
+        }
+
+        /**
+        * Swap a resource into a handle, typically a reserved one once its load finished.
+        * @return False if the handle was erased in the meantime, the resource is dropped.
+        */
+        bool replace(Resource resource, Ref<T> ptr) {
+            if (!contains(resource)) {
+                return false;
+            }
+            Slot&  slot = m_Slots[resource.index()];
+            Ref<T> old  = std::exchange(m_Dense[slot.dense].second, ptr);
+            slot.ready  = true;
+            if (old && old != ptr && old != m_Placeholder) {
+                for (auto& handler : m_Handlers) {
+                    handler->on_erase(resource.handle(), old);
+                }
+            }
+            for (auto& handler : m_Handlers) {
+                handler->on_add(resource.handle(), ptr);
+            }
+            return true;
+        }
+
+        /**
+        * Bind a handle back to the placeholder, the inverse of replace().
+        * @return The resource the handle held, null if the handle is stale or already unloaded.
+        */
+        Ref<T> unload(Resource resource) {
+            if (!ready(resource)) {
+                return nullptr;
+            }
+            Slot&  slot = m_Slots[resource.index()];
+            Ref<T> old  = std::exchange(m_Dense[slot.dense].second, m_Placeholder);
+            slot.ready  = false;
+            if (old && old != m_Placeholder) {
+                for (auto& handler : m_Handlers) {
+                    handler->on_erase(resource.handle(), old);
+                }
+            }
+            if (m_Placeholder) {
+                for (auto& handler : m_Handlers) {
+                    handler->on_add(resource.handle(), m_Placeholder);
+                }
+            }
+            return old;
+        }
+
+        /**
+        * Check if a handle holds its real resource rather than the placeholder.
+        */
+        bool ready(Resource resource) const {
+            return contains(resource) && m_Slots[resource.index()].ready;
+        }
+
+        /**
+        * Set the resource reserved handles resolve to while loading.
+        */
+        void set_placeholder(Ref<T> placeholder) {
+            m_Placeholder = std::move(placeholder);
+        }
+
+        const Ref<T>& placeholder() const {
+            return m_Placeholder;
+        }
+
+        /**
+        * Load times recorded by the loaders of T.
+        */
+        LoadStats& load_stats() {
+            return m_LoadStats;
+        }
+
+        const LoadStats& load_stats() const {
+            return m_LoadStats;
+        }
+
+        /**
+        * Snapshot of the class, handles bound to the placeholder are counted as pending and not sized.
+        */
+        ResourceStats stats(std::string name) const {
+            ResourceStats out{ .name = std::move(name), .count = m_Dense.size(), .loads = m_LoadStats };
+            for (const auto& [handle, ptr] : m_Dense) {
+                if (!m_Slots[Resource::index_of(handle)].ready) {
+                    out.pending++;
+                    continue;
+                }
+                if (ptr) {
+                    out.cpu_bytes    += ptr->bytes();
+                    out.device_bytes += ptr->device_bytes();
+                }
+            }
+            return out;
+        }
+
         void add_handler(Unique<Handler>&& handler) {
             m_Handlers.push_back(std::move(handler));
         }
 
         template <typename... Args> requires (std::is_constructible_v<T, Args...>)
         Resource emplace(Args&&... args) {
-            Handle handle = get_next_handle();
-            m_Resources.emplace(handle, std::make_shared<T>(std::forward<Args>(args)...));
+            Handle handle = insert(std::make_shared<T>(std::forward<Args>(args)...));
             return Resource(TypeToEResource<T>(), handle);
         }
 
@@ -121,58 +272,105 @@ namespace aby {
             assert_contains(resource);
             auto handle = resource.handle();
             for (auto& handler : m_Handlers) {
-                handler->on_erase(handle, m_Resources.at(handle));
+                handler->on_erase(handle, m_Dense[m_Slots[resource.index()].dense].second);
+            }
+            release(resource.index());
+        }
+
+        bool contains(Resource resource) const {
+            if (resource.type() != TypeToEResource<T>()) {
+                return false;
+            }
+            const Handle index = resource.index();
+            if (index >= m_Slots.size()) {
+                return false;
             }
-            m_Resources.erase(handle);
-            m_RecycledHandles.push(handle);
+            const Slot& slot = m_Slots[index];
+            return slot.dense != npos && slot.generation == resource.generation();
         }
 
         Ref<T> at(Resource resource) {
             assert_contains(resource);
-            return m_Resources.at(resource.handle());
+            return m_Dense[m_Slots[resource.index()].dense].second;
         }
 
         Ref<T> at(Resource resource) const {
             assert_contains(resource);
-            return m_Resources.at(resource.handle());
+            return m_Dense[m_Slots[resource.index()].dense].second;
         }
 
         std::size_t size() const {
-            return m_Resources.size();
+            return m_Dense.size();
         }
 
         void clear() {
-            m_Resources.clear();
+            while (!m_Dense.empty()) {
+                release(Resource::index_of(m_Dense.back().first));
+            }
         }
 
         auto begin() {
-            return m_Resources.begin();
+            return m_Dense.begin();
         }
         auto end() {
-            return m_Resources.end();
+            return m_Dense.end();
         }
         auto begin() const {
-            return m_Resources.begin();
+            return m_Dense.begin();
         }
         auto end() const {
-            return m_Resources.end();
+            return m_Dense.end();
         }
     private:
-        Handle get_next_handle() {
-            if (!m_RecycledHandles.empty()) {
-                Handle handle = m_RecycledHandles.front();
-                m_RecycledHandles.pop();
-                return handle;
+        struct Slot {
+            Handle generation = 0;
+            u32    dense      = npos; /// Index into m_Dense, npos while the slot is free.
+            u32    next_free  = npos; /// Next slot in the free list while the slot is free.
+            bool   ready      = true; /// False while a reserved slot still holds the placeholder.
+        };
+
+        Handle insert(Ref<T> ptr) {
+            Handle index;
+            if (m_FreeHead != npos) {
+                index      = m_FreeHead;
+                m_FreeHead = m_Slots[index].next_free;
+            }
+            else {
+                ABY_ASSERT(m_Slots.size() <= Resource::MAX_INDEX, "ResourceClass exceeded {} slots", Resource::MAX_INDEX + 1);
+                index = static_cast<Handle>(m_Slots.size());
+                m_Slots.emplace_back();
             }
-            return m_NextHandle++;
+            Slot& slot     = m_Slots[index];
+            slot.dense     = static_cast<u32>(m_Dense.size());
+            slot.next_free = npos;
+            slot.ready     = true;
+            Handle handle  = Resource::make_handle(index, slot.generation);
+            m_Dense.emplace_back(handle, std::move(ptr));
+            return handle;
+        }
+
+        void release(Handle index) {
+            Slot& slot = m_Slots[index];
+            const u32 dense = slot.dense;
+            const u32 last  = static_cast<u32>(m_Dense.size() - 1);
+            if (dense != last) {
+                m_Dense[dense] = std::move(m_Dense[last]);
+                m_Slots[Resource::index_of(m_Dense[dense].first)].dense = dense;
+            }
+            m_Dense.pop_back();
+
+            slot.generation = (slot.generation + 1) & Resource::GENERATION_MASK;
+            slot.dense      = npos;
+            slot.next_free  = m_FreeHead;
+            m_FreeHead      = index;
         }
     private:
-        Handle m_NextHandle;
-        Map<Ref<T>> m_Resources;
-        std::queue<Handle> m_RecycledHandles;
+        std::vector<Slot>            m_Slots;
+        std::vector<Entry>           m_Dense;
+        u32                          m_FreeHead;
         std::vector<Unique<Handler>> m_Handlers;
+        Ref<T>                       m_Placeholder;
+        LoadStats                    m_LoadStats;
     };
-    
-
 
 }
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+#include "Core/Common.h"
+#include <array>
+#include <span>
+#include <string>
+
+namespace aby {
+
+    /**
+    * Load time telemetry of a ResourceClass.
+    * Every load is split into a decode part (cpu work such as image decoding, glyph rasterization
+    * or shader compilation) and an upload part (backend object creation and gpu transfers).
+    */
+    class LoadStats {
+    public:
+        static constexpr std::size_t BUCKETS = 8;
+
+        LoadStats();
+
+        /**
+        * Record a finished load. Main thread only.
+        */
+        void record(float decode_ms, float upload_ms);
+        void reset();
+
+        u64   count() const;
+        float decode_ms() const;
+        float upload_ms() const;
+        float total_ms() const;
+        float max_ms() const;
+        /**
+        * Number of loads per duration bucket, see bucket_limit.
+        */
+        const std::array<u64, BUCKETS>& histogram() const;
+        /**
+        * Upper bound of a histogram bucket in milliseconds (1, 2, 4, ...), the last bucket is unbounded.
+        */
+        static float bucket_limit(std::size_t bucket);
+    private:
+        u64                      m_Count;
+        float                    m_DecodeMs;
+        float                    m_UploadMs;
+        float                    m_MaxMs;
+        std::array<u64, BUCKETS> m_Histogram;
+    };
+
+    /**
+    * Snapshot of a ResourceClass, see ResourceClass::stats.
+    */
+    struct ResourceStats {
+        std::string name;
+        std::size_t count        = 0; /// Live handles, including pending ones.
+        std::size_t pending      = 0; /// Handles still bound to the placeholder.
+        u64         cpu_bytes    = 0;
+        u64         device_bytes = 0;
+        LoadStats   loads        = {};
+
+        std::string to_json() const;
+    };
+
+    /**
+    * Serialize snapshots as a json array.
+    */
+    std::string to_json(std::span<const ResourceStats> stats);
+
+}
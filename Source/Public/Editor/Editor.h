@@ -5,6 +5,7 @@
 #include "Platform/Platform.h"
 #include "Platform/imgui/imtheme.h"
 #include "Platform/imgui/imconsole.h"
+#include "Platform/imgui/imresources.h"
 #include "Utility/Delegate.h"
 #include <filesystem>
 
@@ -40,6 +41,7 @@ namespace aby::editor {
     private:
         App*     m_App;
         imgui::Console m_Console;
+        imgui::ResourceMonitor m_Resources;
     };
 
 }
\ No newline at end of file
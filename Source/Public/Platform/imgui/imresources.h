@@ -0,0 +1,32 @@
+#pragma once
+#include "Core/Common.h"
+#include "Core/ResourceStats.h"
+#include <imgui/imgui.h>
+#include <vector>
+
+namespace aby {
+    class Context;
+}
+
+namespace aby::imgui {
+
+    /**
+    * Window showing the memory and load time telemetry of every resource class.
+    */
+    class ResourceMonitor {
+    public:
+        ResourceMonitor(const std::string& title = "Resources", bool is_child_window = false);
+
+        void draw(Context* ctx, bool* p_open);
+    private:
+        void draw_options(Context* ctx);
+        void draw_table();
+        void draw_loads();
+        void draw_residency(Context* ctx);
+    private:
+        std::string                m_Title;
+        std::vector<ResourceStats> m_Stats;
+        bool                       bChildWindow;
+    };
+
+}
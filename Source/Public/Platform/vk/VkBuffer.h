@@ -3,8 +3,14 @@
 #include "Platform/vk/VkDeviceManager.h"
 #include "Platform/vk/VkShader.h"
 #include "Platform/vk/VkShaderModule.h"
+#include "Rendering/Vertex.h"
 #include "Core/Log.h"
+#include <array>
+#include <cstddef>
 #include <cstring>
+#include <memory>
+#include <span>
+#include <type_traits>
 
 namespace aby::vk {
 	
@@ -20,6 +26,10 @@ namespace aby::vk {
         }
 
         virtual void set_data(const void* data, std::size_t bytes, DeviceManager& manager);
+        /**
+        * Copy bytes into a range of the buffer, the buffer is not resized.
+        */
+        void write(const void* data, std::size_t bytes, std::size_t offset);
 
         virtual void bind(VkCommandBuffer cmd) {}
         
@@ -67,11 +77,40 @@ namespace aby::vk {
         std::size_t   m_Count;
     };
 
+    /**
+    * Vertex buffer that stays mapped for its whole lifetime, split into one region per frame slot.
+    * The CPU writes a frame's vertices straight into its slot while the GPU reads the others,
+    * the owner must only rewrite a slot once the frame that last read it has retired.
+    */
+    class DynamicVertexBuffer : public Buffer {
+    public:
+        DynamicVertexBuffer(const VertexClass& vertex_class, u32 slots, DeviceManager& manager);
+        ~DynamicVertexBuffer();
+        DynamicVertexBuffer(const DynamicVertexBuffer&) = delete;
+        DynamicVertexBuffer& operator=(const DynamicVertexBuffer&) = delete;
+
+        /**
+        * Select the region bound by bind().
+        */
+        void set_slot(u32 slot);
+        void bind(VkCommandBuffer cmd) override;
+
+        std::span<std::byte> region(u32 slot);
+        u32 slots() const;
+    private:
+        std::byte*   m_Mapped;
+        std::size_t  m_SlotBytes;
+        u32          m_Slots;
+        u32          m_Slot;
+    };
+
     class VertexAccumulator {
     public:
         VertexAccumulator();
         VertexAccumulator(const VertexClass& vertex_class);
         ~VertexAccumulator();
+        VertexAccumulator(const VertexAccumulator&) = delete;
+        VertexAccumulator& operator=(const VertexAccumulator&) = delete;
 
         void set_class(const VertexClass& vertex_class);
         void reset();
@@ -102,6 +141,108 @@ namespace aby::vk {
         std::byte* m_Base;
     };
 
+    /**
+    * Attributes of a vertex type as the shaders taking it declare them, one per input location.
+    */
+    template <typename T>
+    struct VertexLayout;
+
+    template <>
+    struct VertexLayout<Vertex> {
+        static constexpr std::array<VertexAttribute, 4> attributes = {{
+            { 0, offsetof(Vertex, pos),     VK_FORMAT_R32G32B32_SFLOAT    },
+            { 1, offsetof(Vertex, col),     VK_FORMAT_R32G32B32A32_SFLOAT },
+            { 2, offsetof(Vertex, texinfo), VK_FORMAT_R32G32B32_SFLOAT    },
+            { 3, offsetof(Vertex, uvs),     VK_FORMAT_R32G32_SFLOAT       },
+        }};
+    };
+
+    template <>
+    struct VertexLayout<PackedVertex> {
+        static constexpr std::array<VertexAttribute, 4> attributes = {{
+            { 0, offsetof(PackedVertex, pos),      VK_FORMAT_R32G32B32_SFLOAT },
+            { 1, offsetof(PackedVertex, col),      VK_FORMAT_R8G8B8A8_UNORM   },
+            { 2, offsetof(PackedVertex, texcoord), VK_FORMAT_R16G16_UNORM     },
+            { 3, offsetof(PackedVertex, texture),  VK_FORMAT_R16_UINT         },
+        }};
+    };
+
+    template <>
+    struct VertexLayout<QuadInstance> {
+        static constexpr std::array<VertexAttribute, 5> attributes = {{
+            { 0, offsetof(QuadInstance, pos),     VK_FORMAT_R32G32B32_SFLOAT    },
+            { 1, offsetof(QuadInstance, size),    VK_FORMAT_R32G32_SFLOAT       },
+            { 2, offsetof(QuadInstance, col),     VK_FORMAT_R32_UINT            },
+            { 3, offsetof(QuadInstance, texture), VK_FORMAT_R32_UINT            },
+            { 4, offsetof(QuadInstance, uvs),     VK_FORMAT_R32G32B32A32_SFLOAT },
+        }};
+    };
+
+    /**
+    * Accumulator whose vertex type is known at compile time: vertices are stored as T directly,
+    * without the size check and memcpy per vertex of VertexAccumulator. Writes into memory owned
+    * by the caller, such as a region of a DynamicVertexBuffer.
+    */
+    template <typename T>
+    class TypedVertexAccumulator {
+    public:
+        static_assert(std::is_trivially_copyable_v<T>, "Vertices are read by the device as raw bytes");
+
+        TypedVertexAccumulator() = default;
+        TypedVertexAccumulator(std::span<std::byte> memory) {
+            set_memory(memory);
+        }
+
+        /**
+        * Whether every input of binding reflected from the shader is a member of T at the same
+        * location, offset and format, and T is as large as the stride of the binding.
+        */
+        static bool matches(const ShaderDescriptor& descriptor, u32 binding = 0) {
+            return descriptor.matches(binding, VertexLayout<T>::attributes) &&
+                sizeof(T) == VertexClass(descriptor, 0, binding).vertex_size();
+        }
+
+        /**
+        * Continue in other memory, the accumulator is reset.
+        */
+        void set_memory(std::span<std::byte> memory) {
+            ABY_ASSERT(reinterpret_cast<std::uintptr_t>(memory.data()) % alignof(T) == 0, "Vertex memory is misaligned");
+            m_Base     = reinterpret_cast<T*>(memory.data());
+            m_Capacity = memory.size() / sizeof(T);
+            m_Count    = 0;
+        }
+
+        void reset() {
+            m_Count = 0;
+        }
+
+        template <typename... Args>
+        T& emplace(Args&&... args) {
+            ABY_ASSERT(m_Count < m_Capacity, "TypedVertexAccumulator requires flushing!");
+            return *std::construct_at(m_Base + m_Count++, std::forward<Args>(args)...);
+        }
+
+        /**
+        * The next count vertices, counted as written. The caller fills them.
+        */
+        std::span<T> emplace_n(std::size_t count) {
+            ABY_ASSERT(m_Count + count <= m_Capacity, "TypedVertexAccumulator requires flushing!");
+            std::span<T> vertices(m_Base + m_Count, count);
+            m_Count += count;
+            return vertices;
+        }
+
+        std::size_t count() const { return m_Count; }
+        std::size_t capacity() const { return m_Capacity; }
+        std::size_t remaining() const { return m_Capacity - m_Count; }
+        std::size_t bytes() const { return m_Count * sizeof(T); }
+        T* data() const { return m_Base; }
+    private:
+        T*          m_Base     = nullptr;
+        std::size_t m_Count    = 0;
+        std::size_t m_Capacity = 0;
+    };
+
     class IndexBuffer : public Buffer {
     public:
         IndexBuffer(const void* data, size_t size, DeviceManager& manager);
@@ -110,4 +251,22 @@ namespace aby::vk {
         void bind(VkCommandBuffer cmd) override;
     };
 
+    /**
+    * Host visible transfer source that stays mapped for its whole lifetime,
+    * so producers such as image decoders can write into it directly.
+    * Can be created on loading threads, the buffer is released on destruction.
+    */
+    class StagingBuffer : public Buffer {
+    public:
+        StagingBuffer(std::size_t bytes, DeviceManager& manager);
+        ~StagingBuffer();
+        StagingBuffer(const StagingBuffer&) = delete;
+        StagingBuffer& operator=(const StagingBuffer&) = delete;
+
+        std::span<std::byte>       span();
+        std::span<const std::byte> span() const;
+    private:
+        std::byte* m_Mapped;
+    };
+
 }
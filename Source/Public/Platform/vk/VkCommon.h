@@ -4,6 +4,7 @@
 #include <iostream>
 #include <cstdint>
 #include <vector>
+#include <span>
 
 #define VK_CHECK(x) do {                                                          \
     VkResult result = (x);                                                        \
@@ -68,9 +69,10 @@ namespace aby::vk {
         auto find_mem_type(u32 filter, VkMemoryPropertyFlags properties, VkPhysicalDevice physical) -> u32;
         auto transition_image_layout(VkCommandBuffer cmd, VkImage image, VkImageLayout* oldLayout, VkImageLayout newLayout, VkAccessFlags2 srcAccessMask, VkAccessFlags2 dstAccessMask, VkPipelineStageFlags2 srcStage, VkPipelineStageFlags2 dstStage) -> void;
         auto transition_image_layout(VkCommandBuffer cmd, VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout, VkAccessFlags2 srcAccessMask, VkAccessFlags2 dstAccessMask, VkPipelineStageFlags2 srcStage, VkPipelineStageFlags2 dstStage) -> void;
-        auto copy_buffer_to_img(VkCommandBuffer cmd, VkBuffer buffer, VkImage image, uint32_t width, uint32_t height) -> void;
-        auto create_img(uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory, VkDevice device, VkPhysicalDevice physicalDevice) -> void;
-        auto create_img_view(VkDevice device, VkImage image, VkFormat format, VkImageView& view) -> void;
+        auto copy_buffer_to_img(VkCommandBuffer cmd, VkBuffer buffer, VkImage image, uint32_t width, uint32_t height, VkDeviceSize offset = 0) -> void;
+        auto copy_buffer_to_img(VkCommandBuffer cmd, VkBuffer buffer, VkImage image, std::span<const VkBufferImageCopy> regions) -> void;
+        auto create_img(uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory, VkDevice device, VkPhysicalDevice physicalDevice, uint32_t mipLevels = 1) -> void;
+        auto create_img_view(VkDevice device, VkImage image, VkFormat format, VkImageView& view, uint32_t mipLevels = 1) -> void;
         auto begin_single_time_commands(VkDevice device, VkCommandPool commandPool) -> VkCommandBuffer;
         auto end_single_time_commands(VkCommandBuffer commandBuffer, VkDevice device, VkCommandPool commandPool, VkQueue queue) -> void;
         auto set_debug_name(VkDevice device, uint64_t handle, VkObjectType type, const char* name) -> void;
@@ -3,12 +3,25 @@
 #include "Platform/vk/VkInstance.h"
 #include "Platform/vk/VkDebugger.h"
 #include "Platform/vk/VkSurface.h"
+#include "Platform/vk/VkUploadRing.h"
 #include "Rendering/Window.h"
 #include "Rendering/Context.h"
 
 
 namespace aby::vk {
 
+    /**
+    * Objects of an image replaced while in flight submissions may still sample it.
+    */
+    struct RetiredImage {
+        VkImage          image   = VK_NULL_HANDLE;
+        VkImageView      view    = VK_NULL_HANDLE;
+        VkSampler        sampler = VK_NULL_HANDLE;
+        VkDeviceMemory   memory  = VK_NULL_HANDLE;
+        VkDescriptorSet  set     = VK_NULL_HANDLE; /// ImGui descriptor of the image, freed back to pool.
+        VkDescriptorPool pool    = VK_NULL_HANDLE;
+    };
+
     class Context : public aby::Context {
     public:
         Context(App* app, Window* window);
@@ -28,13 +41,34 @@ namespace aby::vk {
         Debugger&      debugger();
         DeviceManager& devices();
         Surface&       surface();
+        UploadRing&    uploads();
+
+        /**
+        * Destroy the objects once every submission made so far has completed.
+        */
+        void retire(const RetiredImage& image);
+        /**
+        * Called by the renderer after each submission.
+        * @param submitted The last submission.
+        * @param completed Every submission up to this one has completed.
+        */
+        void collect(u64 submitted, u64 completed);
     private:
         void imgui_setup_style();
+        void destroy(const RetiredImage& image);
     private:
+        struct Retired {
+            u64          serial; /// Last submission that may read the image.
+            RetiredImage image;
+        };
+
         Instance m_Instance;
         Debugger m_Debugger;
         DeviceManager m_Devices;
         Surface m_Surface;
+        UploadRing m_Uploads;
+        std::vector<Retired> m_Retired;
+        u64 m_Submitted = 0;
     };
 
 }
\ No newline at end of file
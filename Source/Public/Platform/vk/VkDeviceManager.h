@@ -30,6 +30,10 @@ namespace aby::vk {
         const DeviceQueue& graphics() const;
 
         u32 max_texture_slots() const;
+        /**
+        * Whether BC compressed images can be sampled, otherwise compressed textures are decoded on the cpu.
+        */
+        bool texture_compression_bc() const;
     protected:
         static VkPhysicalDevice choose_best_device(VkInstance inst);
     private:
@@ -37,6 +41,7 @@ namespace aby::vk {
         VkDevice m_Logical;
         DeviceQueue m_Graphics;
         u32 m_MaxTextureSlots;
+        bool m_TextureCompressionBC;
     };
 
 }
\ No newline at end of file
@@ -13,9 +13,12 @@ namespace aby::vk {
 	class Pipeline {
 	public:
 		Pipeline();
-		Pipeline(Window* window, DeviceManager& manager, Ref<ShaderModule> shaders, Swapchain& swapchain);
+		Pipeline(Window* window, DeviceManager& manager, Ref<ShaderModule> shaders, Swapchain& swapchain, VkVertexInputRate input_rate = VK_VERTEX_INPUT_RATE_VERTEX);
 		
-		void create(Window* window, DeviceManager& manager, Ref<ShaderModule> shaders, Swapchain& swapchain);
+		/**
+		* @param input_rate Rate of every vertex input binding, VK_VERTEX_INPUT_RATE_INSTANCE for instanced primitives.
+		*/
+		void create(Window* window, DeviceManager& manager, Ref<ShaderModule> shaders, Swapchain& swapchain, VkVertexInputRate input_rate = VK_VERTEX_INPUT_RATE_VERTEX);
 		void destroy();
 
 		void bind(VkCommandBuffer buffer);
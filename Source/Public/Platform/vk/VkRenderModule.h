@@ -7,6 +7,9 @@
 #include "Platform/vk/VkContext.h"
 #include "Rendering/Vertex.h"
 #include <array>
+#include <algorithm>
+#include <span>
+#include <variant>
 
 namespace aby::vk {
 
@@ -15,45 +18,115 @@ namespace aby::vk {
         u32 MaxIndices;
         u32 IndicesPer;
         u32 VerticesPer;
+        u32 VerticesPerInstance = 0; /// Non zero if every element written is an instance the vertex shader expands into this many vertices.
     };
 
-    class RenderPrimitive {
+    /**
+    * Batch and vertex (or instance) the next write of a RenderPrimitive goes to.
+    */
+    struct PrimitivePosition {
+        u32 batch;
+        u32 vertex;
+    };
+
+    /**
+    * Draws ranges of a RenderPrimitive's batches whatever its vertex type, used to replay a RenderQueue.
+    */
+    class IRenderPrimitive {
+    public:
+        virtual ~IRenderPrimitive() = default;
+
+        virtual PrimitivePosition position() const = 0;
+        /**
+        * Vertices (or instances) written to a batch this frame.
+        */
+        virtual u32  batch_size(u32 batch) const = 0;
+        /**
+        * Bind the buffers of a batch for draw().
+        */
+        virtual void bind(VkCommandBuffer cmd, u32 batch) = 0;
+        /**
+        * Draw count vertices (or instances) of whole primitives starting at first in the bound batch.
+        */
+        virtual void draw(VkCommandBuffer cmd, u32 first, u32 count) const = 0;
+    };
+
+    /**
+    * Vertices of one primitive type accumulated over a frame.
+    * A full batch (MaxVertices) continues in the next one, each with its own vertex buffer,
+    * and every batch is drawn in order within the frame's command buffer, so a frame is never split
+    * into several presents. Batches and their buffers are kept for the following frames.
+    * Vertices are written straight into the frame slot's region of a persistently mapped buffer,
+    * the renderer only hands out a slot once the frame that last read it has retired.
+    * Instantiated for aby::Vertex, aby::PackedVertex and aby::QuadInstance.
+    */
+    template <typename T>
+    class RenderPrimitive : public IRenderPrimitive {
     public:
+        /**
+        * @throws std::invalid_argument if T does not have the size of the reflected vertex layout.
+        */
         RenderPrimitive(Ref<vk::Context> ctx, const ShaderDescriptor& vertex_descriptor, const PrimitiveDescriptor& primitive_descriptor);
 
         void destroy();
-        void reset();
-        void bind(VkCommandBuffer cmd, DeviceManager& manager);
-        void draw(VkCommandBuffer cmd);
+        /**
+        * Start a frame writing into the regions of the given frame slot.
+        */
+        void reset(u32 slot);
+        /**
+        * Draw every batch written this frame in order.
+        */
+        void flush(VkCommandBuffer cmd);
+
+        PrimitivePosition position() const override;
+        u32  batch_size(u32 batch) const override;
+        void bind(VkCommandBuffer cmd, u32 batch) override;
+        void draw(VkCommandBuffer cmd, u32 first, u32 count) const override;
 
         void set_index_data(const u32* indices, DeviceManager& manager);
 
-        bool should_flush() const;
-        bool should_flush(std::size_t requested_primitives) const;
         bool empty() const;
         std::size_t index_count() const;
         std::size_t vertex_count() const;
+        /**
+        * Batches written this frame.
+        */
+        std::size_t batches() const;
         const vk::PrimitiveDescriptor& descriptor() const;
 
-        RenderPrimitive& operator++();
-
-        template <typename T>
-        RenderPrimitive& operator=(const T& data) {
-            m_VertexAccumulator = data;
-            return *this;
-        }
-    protected:
-        void draw_indexed(VkCommandBuffer cmd);
-        void draw_nonindexed(VkCommandBuffer cmd);
+        /**
+        * The VerticesPer vertices of one primitive, to be written by the caller.
+        */
+        std::span<T> primitive();
+        /**
+        * Up to count vertices (whole primitives) in the current batch, to be written by the caller.
+        * Less than count if the batch fills up first, the next call continues in the following batch.
+        */
+        std::span<T> emplace_n(std::size_t count);
+    private:
+        struct Batch {
+            Batch(const VertexClass& vertex_class, u32 slot, DeviceManager& manager);
+
+            vk::DynamicVertexBuffer      buffer;
+            TypedVertexAccumulator<T>    vertices;
+            std::size_t                  index_count = 0;
+        };
+        void next_batch();
+        void begin(Batch& batch);
     private:
-        vk::VertexClass       m_VertexClass;
-        vk::VertexAccumulator m_VertexAccumulator;
-        vk::VertexBuffer      m_VertexBuffer;
-        vk::IndexBuffer       m_IndexBuffer;
-        PrimitiveDescriptor   m_Descriptor;
-        std::size_t           m_IndexCount;
+        vk::Context*               m_Ctx;
+        vk::VertexClass            m_VertexClass;
+        std::vector<Unique<Batch>> m_Batches;
+        std::size_t                m_Batch; /// Batch currently written to.
+        u32                        m_Slot;  /// Frame slot the batches write to.
+        vk::IndexBuffer            m_IndexBuffer;
+        PrimitiveDescriptor        m_Descriptor;
     };
 
+    extern template class RenderPrimitive<Vertex>;
+    extern template class RenderPrimitive<PackedVertex>;
+    extern template class RenderPrimitive<QuadInstance>;
+
     enum class ERenderPrimitive {
         TRIANGLE = 0,
         QUAD     = 1,
@@ -61,34 +134,74 @@ namespace aby::vk {
         ALL,
     };
 
-    using RenderPrimitiveArray = std::array<RenderPrimitive, static_cast<std::size_t>(ERenderPrimitive::MAX_ENUM)>;
+    template <typename V>
+    using RenderPrimitiveArray = std::array<RenderPrimitive<V>, static_cast<std::size_t>(ERenderPrimitive::MAX_ENUM)>;
+    using RenderPrimitives     = std::variant<RenderPrimitiveArray<Vertex>, RenderPrimitiveArray<PackedVertex>>;
 
+    /**
+    * Draws aby::Vertex primitives, stored as aby::PackedVertex when the reflected vertex layout of the shader is the packed one.
+    */
     class RenderModule {
     public:
         RenderModule(Ref<vk::Context> ctx, vk::Swapchain& swapchain, const std::vector<fs::path>& shaders);
         RenderModule(Ref<vk::Context> ctx, vk::Swapchain& swapchain, Ref<ShaderModule> module);
 
         void destroy();
-        void reset();
-        void flush(VkCommandBuffer cmd, DeviceManager& manager, ERenderPrimitive primitive = ERenderPrimitive::ALL);
+        void reset(u32 slot);
+        void flush(VkCommandBuffer cmd, ERenderPrimitive primitive = ERenderPrimitive::ALL);
         void set_uniforms(const void* data, std::size_t bytes, u32 binding = 0);
         
+        IRenderPrimitive& primitive(ERenderPrimitive primitive);
+
         void draw_triangle(const Triangle& triangle);
+        void draw_triangles(std::span<const Triangle> triangles);
         void draw_quad(const Quad& quad);
         void draw_cube(const Quad& quad);
         void draw_text(const Text& text);
 
         Ref<ShaderModule> module() const;
         vk::Pipeline&     pipeline();
-        RenderPrimitive&  quads();
-        RenderPrimitive&  tris();
     private:
         void init();
+        /**
+        * Write the VerticesPer vertices of one primitive, vertex(i) returns the i-th as an aby::Vertex.
+        */
+        template <typename F>
+        void write(ERenderPrimitive primitive, F&& vertex);
+    private:
+        vk::Context*      m_Ctx;
+        Ref<ShaderModule> m_Module;
+        vk::Pipeline      m_Pipeline;
+        RenderPrimitives  m_Primitives;
+    };
+
+    /**
+    * Quads drawn as instances: each quad is a single QuadInstance the vertex shader expands into two triangles,
+    * so the CPU neither transforms nor writes the four corners.
+    */
+    class InstancedQuadModule {
+    public:
+        InstancedQuadModule(Ref<vk::Context> ctx, vk::Swapchain& swapchain, const std::vector<fs::path>& shaders);
+
+        void destroy();
+        void reset(u32 slot);
+        void flush(VkCommandBuffer cmd);
+        void set_uniforms(const void* data, std::size_t bytes, u32 binding = 0);
+
+        void draw_quad(const Quad& quad);
+        /**
+        * Pack the quads straight into the mapped instance batches, see pack_quads().
+        */
+        void draw_quads(std::span<const Quad> quads);
+
+        Ref<ShaderModule>              module() const;
+        vk::Pipeline&                  pipeline();
+        RenderPrimitive<QuadInstance>& instances();
     private:
-        vk::Context*          m_Ctx;
-        Ref<ShaderModule>     m_Module;
-        vk::Pipeline          m_Pipeline;
-        RenderPrimitiveArray  m_Primitives;
+        vk::Context*                  m_Ctx;
+        Ref<ShaderModule>             m_Module;
+        vk::Pipeline                  m_Pipeline;
+        RenderPrimitive<QuadInstance> m_Instances;
     };
 
 
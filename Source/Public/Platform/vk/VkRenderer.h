@@ -18,33 +18,72 @@ namespace aby::vk {
         void on_end() override;
         void on_event(Event& event) override;
 
+        void set_draw_order(const DrawOrder& order) override;
+        const RenderQueueStats& queue_stats() const override;
+
         void draw_text(const Text& text) override;
         void draw_triangle(const Triangle& triangle) override;
         void draw_quad(const Quad& quad) override;
+        void draw_triangles(std::span<const Triangle> triangles) override;
+        void draw_quads(std::span<const Quad> quads) override;
         void draw_cube(const Quad& quad) override;
 
         vk::RenderModule& rm2d();
         vk::RenderModule& rm3d();
+        vk::InstancedQuadModule& quads();
         vk::Swapchain& swapchain();
     protected: 
         void render(u32 img);
+        /**
+        * Move to the next frame slot, waiting for the frame that last read its vertices if it is still in flight.
+        */
+        void begin_slot();
         void start_batch(RenderModule& module);
-        void flush(RenderModule& module, ERenderPrimitive primitive);
-        void flush_if(RenderModule& module, bool flush, ERenderPrimitive primitive);
     private:
+        /**
+        * Primitive buffers a draw is written to. Draws of every stream are replayed in submission order
+        * within a layer and depth, the stream only decides the pipeline.
+        */
+        enum class EStream : u32 {
+            CUBES = 0,       /// m_3D quads.
+            INSTANCED_QUADS, /// m_Quads.
+            TRIANGLES,       /// m_2D triangles.
+            QUADS,           /// m_2D quads, text.
+            MAX_ENUM,
+        };
+        IRenderPrimitive& stream(EStream stream);
+        vk::Pipeline&     pipeline(u32 index);
+        /**
+        * Call write() and record what it wrote to the stream as draw packets of the current draw order.
+        */
+        template <typename F>
+        void record(EStream stream, F&& write);
+
         bool on_resize(WindowResizeEvent& event);
         bool on_resize(u32 w, u32 h);
         void recreate_swapchain();
         std::pair<VkResult, u32> acquire_next_img();
         VkResult present_img(u32 img);
     private:
+        struct FrameSlot {
+            u64 serial = 0; /// Submission that last read the slot.
+            u32 img    = 0; /// Swapchain image whose fence signals that submission.
+        };
         Ref<vk::Context> m_Ctx;
         std::vector<Frame> m_Frames;
         vk::Swapchain m_Swapchain;
         RenderModule m_2D;
         RenderModule m_3D;
+        InstancedQuadModule m_Quads;
         std::vector<VkSemaphore> m_RecycledSemaphores;
         u32 m_Img;
+        std::array<FrameSlot, MAX_FRAMES_IN_FLIGHT> m_Slots;
+        u32 m_Slot;
+        std::vector<u64> m_ImgSerials; /// Last submission per swapchain image.
+        u64 m_Submitted;
+        u64 m_Retired;                 /// Every submission up to this one has completed.
+        RenderQueue m_Queue;
+        DrawOrder   m_Order;
     };
 
 }
\ No newline at end of file
@@ -15,6 +15,7 @@ namespace aby::vk {
         static Ref<Shader> create(aby::App* app, DeviceManager& devices, const fs::path& path, EShader type);
 
         void destroy();
+        u64  device_bytes() const override;
 
         const ShaderDescriptor& descriptor() const;
         VkDescriptorSetLayout layout() const;
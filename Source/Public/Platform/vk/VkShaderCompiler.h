@@ -21,5 +21,10 @@ namespace aby::vk {
         static EShader get_type_from_ext(const fs::path& ext);
         static fs::path cache_dir(App* app, const fs::path& file = "");
         static ShaderDescriptor reflect(const std::vector<u32>& binary_data);
+        /**
+        * Reflection of a compiled shader, read from the asset archive or the shader cache when present.
+        * Otherwise reflects binary_data and caches the result next to the SPIR-V for aby_package.
+        */
+        static ShaderDescriptor reflect(App* app, const fs::path& path, const std::vector<u32>& binary_data);
     };
 }
\ No newline at end of file
@@ -6,6 +6,7 @@ namespace aby::vk {
 
     class TextureResourceHandler;
     class Context;
+    class Texture;
 
     class ShaderModule {
     public:
@@ -42,4 +43,25 @@ namespace aby::vk {
         friend class TextureResourceHandler;
     };
 
+    /**
+    * Writes the bindless slot and ImGui descriptor of every texture added to the context.
+    */
+    class TextureResourceHandler : public IResourceHandler<aby::Texture> {
+    public:
+        TextureResourceHandler(ShaderModule* shader_module);
+
+        void on_add(Handle handle, Ref<aby::Texture> texture) override;
+        void on_erase(Handle handle, Ref<aby::Texture> texture) override;
+        /**
+        * Point the descriptors of a slot at the current image of the texture, e.g. after it was recreated.
+        */
+        void update_descriptor_sets(Handle handle, vk::Texture* tex);
+        /**
+        * Pool the ImGui descriptors of the textures are allocated from.
+        */
+        VkDescriptorPool pool() const;
+    private:
+        VkDescriptorSetLayout m_ImGuiLayout;
+    };
+
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 #include "Platform/vk/VkCommon.h"
+#include <optional>
+#include <span>
 
 namespace aby::vk {
 
@@ -16,6 +18,14 @@ namespace aby::vk {
         uint32_t stride;
         VkFormat format;
     };
+    /**
+    * Where a member of a vertex type lives and the format its shader input is reflected with.
+    */
+    struct VertexAttribute {
+        uint32_t location;
+        uint32_t offset;
+        VkFormat format;
+    };
     struct ShaderStorage {
         std::string name;
         uint32_t set;
@@ -33,6 +43,20 @@ namespace aby::vk {
         std::map<std::size_t, std::size_t> input_binding_sizes() const;
         std::map<std::size_t, std::size_t> input_binding_stride() const;
         static std::size_t format_size(VkFormat format);
+        /**
+        * Whether the inputs of binding are exactly the attributes, each at the same location, offset and format.
+        */
+        bool matches(uint32_t binding, std::span<const VertexAttribute> attributes) const;
+
+        /**
+        * Flat binary form stored next to cached SPIR-V and packed into the asset archive,
+        * so shipping builds skip spirv-cross reflection.
+        */
+        std::vector<std::byte> serialize() const;
+        /**
+        * @return std::nullopt if the bytes are truncated.
+        */
+        static std::optional<ShaderDescriptor> deserialize(std::span<const std::byte> bytes);
 
         std::vector<ShaderUniform> uniforms;
         std::vector<ShaderStorage> storages;
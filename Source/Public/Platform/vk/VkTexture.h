@@ -2,6 +2,7 @@
 #include "Platform/vk/VkCommon.h"
 #include "Platform/vk/VkBuffer.h"
 #include "Platform/vk/VkCmdPool.h"
+#include "Utility/LockFree.h"
 #include "Rendering/Texture.h"
 
 namespace aby::vk {
@@ -15,12 +16,33 @@ namespace aby::vk {
         Texture(vk::Context* ctx, const glm::u32vec2& size, const glm::vec4& color);
         Texture(vk::Context* ctx, const glm::u32vec2& size, const std::vector<std::byte>& data, u32 channels, ETextureFormat format);
         Texture(vk::Context* ctx, const glm::u32vec2& size, const void* data, u32 channels, ETextureFormat format);
+        /**
+        * Take ownership of decoded data, with upload = false the image is created by upload_batch.
+        */
+        Texture(vk::Context* ctx, const glm::u32vec2& size, std::vector<std::byte>&& data, u32 channels, ETextureFormat format, bool upload = true);
+        /**
+        * Upload pixels already written to staging memory, e.g. decoded in place on a loading thread.
+        * The buffer holds levels mip levels laid out by MipChain and is held by the upload ring until the copy has executed.
+        * The cpu side copy of level 0 is only kept with keep_data, with upload = false the image is created by upload_batch.
+        */
+        Texture(vk::Context* ctx, const glm::u32vec2& size, Ref<StagingBuffer> staging, u32 channels, ETextureFormat format, u32 levels = 1, bool keep_data = false, bool upload = true);
         Texture(const Texture& other);
         Texture(Texture&& other) noexcept;
         ~Texture();
+
+        /**
+        * Create the images of textures constructed with upload = false and queue their copies on the
+        * upload ring. Whatever does not fit in the ring goes through one staging buffer and a single submission.
+        */
+        static void upload_batch(vk::Context* ctx, std::span<const Ref<vk::Texture>> textures);
+        /**
+        * Same as above with every texture copied from its own staging buffer, staging[i] belongs to textures[i].
+        */
+        static void upload_batch(vk::Context* ctx, std::span<const Ref<vk::Texture>> textures, std::span<const Ref<StagingBuffer>> staging);
         
         void sync() override;
         void set_dbg_name(const std::string& name) override;
+        u64  device_bytes() const override;
 
         VkImage img();
         VkImageView view();
@@ -31,8 +53,28 @@ namespace aby::vk {
         ImTextureID imgui_id() const override;
     protected:
         void init();
+        void init(Ref<StagingBuffer> staging);
+        void create_image();
+        /**
+        * Queue a copy into the image on the upload ring, flushed with the next frame.
+        * @return false if the ring is full.
+        */
+        bool queue_upload(std::span<const std::byte> pixels);
+        void queue_upload(Ref<StagingBuffer> staging);
+        void record_upload(VkCommandBuffer cmd, VkBuffer staging, VkDeviceSize offset);
+        void create_view_sampler();
         void upload();
+        /**
+        * Upload only the regions written since the last sync.
+        */
+        void upload_regions();
         void destroy();
+        /**
+        * Hand the image, its view, sampler and ImGui descriptor to the context to be destroyed
+        * once the frames in flight that may sample them have completed.
+        */
+        void retire();
+        static void submit_batch(vk::Context* ctx, std::span<const Ref<vk::Texture>> textures, std::span<const VkBuffer> buffers, std::span<const VkDeviceSize> offsets);
     private:
         VkDevice        m_Logical;
         VkFormat        m_Format;
@@ -72,6 +114,11 @@ namespace aby::vk {
         void write(const glm::u32vec2& size, const void* data) override;
         void set_dbg_name(const std::string& name) override;
         void set_max_buffers(std::size_t frames) override;
+        void stream() override;
+        std::span<std::byte> acquire() override;
+        void publish() override;
+        bool sync() override;
+        StreamStats stream_stats() const override;
 
         VkImage img();
         VkImageView view();
@@ -87,6 +134,7 @@ namespace aby::vk {
         void init(PerTex& buffer);
         void destroy(PerTex& buffer);
         void upload(PerTex& buffer, const void* src_data);
+        void write_descriptor(PerTex& buffer);
         void create_sampler();
         PerTex& curr();
         const PerTex& curr() const;
@@ -98,6 +146,14 @@ namespace aby::vk {
         VkSampler           m_Sampler = VK_NULL_HANDLE;
         std::size_t         m_Idx     = 0;
         std::vector<PerTex> m_Texs    = {};
+        // Streaming
+        Unique<util::SlotExchange>      m_Exchange  = nullptr;
+        std::vector<Ref<StagingBuffer>> m_Slots     = {};
+        u32                             m_Writing   = util::SlotExchange::NONE; /// Slot acquired by the producer.
+        std::vector<u32>                m_InFlight  = {};                       /// Slots taken by sync() the gpu may still copy from.
+        std::atomic<u64>                m_Starved   = 0;
+        u64                             m_Presented = 0;
+        u64                             m_Bytes     = 0;
 #ifndef NDEBUG
         std::string         m_DbgName = "";
 #endif
@@ -0,0 +1,111 @@
+#pragma once
+#include "Platform/vk/VkCommon.h"
+#include "Platform/vk/VkBuffer.h"
+#include "Rendering/Texture.h"
+#include <deque>
+#include <optional>
+
+namespace aby::vk {
+
+    /**
+    * Destination of a queued image upload.
+    */
+    struct ImageUpload {
+        VkImage            image  = VK_NULL_HANDLE;
+        glm::u32vec2       extent = { 0, 0 };
+        u32                texel  = 0;                            /// Bytes per texel.
+        VkImageLayout      layout = VK_IMAGE_LAYOUT_UNDEFINED;    /// Layout of the image before the copy.
+        u32                levels = 1;                            /// Mip levels to copy, laid out by MipChain in staged buffers.
+        util::EBlockFormat block  = util::EBlockFormat::NONE;     /// Block compression of the image, texel is then the bytes per block.
+    };
+
+    /**
+    * Engine owned staging ring for image uploads.
+    * One persistently mapped host visible buffer is carved into per-frame regions:
+    * uploads queued during a frame are copied into the ring, recorded at the start of that
+    * frame's command buffer and so flushed with its submit. A region is recycled once
+    * the fence of the frame that consumed it has signalled.
+    * Main thread only.
+    */
+    class UploadRing {
+    public:
+        UploadRing();
+
+        void create(DeviceManager& devices, VkDeviceSize bytes);
+        void destroy();
+
+        /**
+        * Copy data into the ring and queue a copy into the image.
+        * The image is in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL once the copy executed.
+        * @return false if the ring has no room left this frame, the caller uploads immediately instead.
+        */
+        bool write(const ImageUpload& upload, const void* data, VkDeviceSize bytes);
+        /**
+        * Copy the rows of each region out of the pixels of the whole image into the ring
+        * and queue a single copy command with one VkBufferImageCopy per region.
+        * @return false if the ring has no room left this frame.
+        */
+        bool write_regions(const ImageUpload& upload, std::span<const std::byte> pixels, std::span<const TextureRegion> regions);
+        /**
+        * Queue a copy from a staging buffer that already holds the pixels (e.g. decoded in place),
+        * the buffer is kept alive until the frame that copies from it has completed.
+        * Every mip level is copied with the same command.
+        */
+        void stage(const ImageUpload& upload, Ref<StagingBuffer> staging);
+        /**
+        * Drop queued copies into an image that is about to be destroyed.
+        */
+        void cancel(VkImage image);
+
+        /**
+        * Record every queued copy into the command buffer of frame.
+        */
+        void flush(VkCommandBuffer cmd, u32 frame);
+        /**
+        * Record the queued copies into one image ahead of an immediate upload to it, so they
+        * execute before it instead of overwriting it when the frame is flushed.
+        * The image is in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL after cmd if any were queued.
+        */
+        void flush(VkCommandBuffer cmd, VkImage image);
+        /**
+        * The fence of frame has signalled, recycle the region and buffers it consumed.
+        */
+        void retire(u32 frame);
+        /**
+        * The device is idle, recycle everything in flight.
+        */
+        void retire_all();
+
+        std::size_t  pending() const;
+        VkDeviceSize capacity() const;
+        /**
+        * Bytes of the ring held by queued and in flight uploads.
+        */
+        VkDeviceSize used() const;
+    private:
+        std::optional<VkDeviceSize> allocate(VkDeviceSize bytes, VkDeviceSize align);
+    private:
+        struct Pending {
+            ImageUpload                    upload;
+            VkBuffer                       buffer;
+            std::vector<VkBufferImageCopy> copies;
+            Ref<StagingBuffer>             staging; /// Set when copying from a caller provided staging buffer.
+        };
+        void record(VkCommandBuffer cmd, const Pending& pending);
+        struct InFlight {
+            u32                             frame;
+            u64                             end;
+            bool                            done;
+            std::vector<Ref<StagingBuffer>> staging;
+        };
+
+        VkDevice              m_Logical;
+        Unique<StagingBuffer> m_Buffer;
+        u64                   m_Head; /// Monotonic write position, the ring offset is m_Head % capacity.
+        u64                   m_Tail; /// Oldest position still owned by a queued or in flight upload.
+        std::vector<Pending>  m_Pending;
+        std::vector<Ref<StagingBuffer>> m_Detached; /// Staging buffers of copies flushed into an immediate upload, released with the next frame.
+        std::deque<InFlight>  m_InFlight;
+    };
+
+}
@@ -6,6 +6,10 @@
 #include "Rendering/Font.h"
 #include "Rendering/Texture.h"
 #include "Rendering/Shader.h"
+#include "Rendering/TextureResidency.h"
+#include "Rendering/TextureStreamer.h"
+#include "Rendering/TextureAtlas.h"
+#include "Utility/File.h"
 
 namespace aby {
     
@@ -32,18 +36,49 @@ namespace aby {
         const ResourceClass<Texture>& textures() const;
         ResourceClass<Font>&          fonts();
         const ResourceClass<Font>&    fonts() const;
-        util::LoadThread&             load_thread();
-        const util::LoadThread&       load_thread() const;
+        util::LoadPool&               load_pool();
+        const util::LoadPool&         load_pool() const;
+        TextureResidency&             residency();
+        const TextureResidency&       residency() const;
+        /**
+        * Full resolution uploads of streamed textures, within AppInfo::texture_stream_budget per frame.
+        */
+        TextureStreamer&              streamer();
+        const TextureStreamer&        streamer() const;
+        /**
+        * Shared pages small images (icons, sprites) are packed into.
+        */
+        TextureAtlas&                 atlas();
+        const TextureAtlas&           atlas() const;
+        /**
+        * Sync every texture written since the last call, main thread only.
+        * Textures queue themselves when written so the cost is proportional to the number of written textures.
+        * @return Number of queued textures.
+        */
+        std::size_t                   sync_textures();
+        /**
+        * Snapshot of every resource class (textures, fonts, shaders).
+        */
+        std::vector<ResourceStats>    resource_stats() const;
+        /**
+        * Write resource_stats() as json.
+        * @return Empty on success
+        */
+        util::FileError               export_resource_stats(const fs::path& file) const;
     protected:
         Context(App* app, Window* window);
     protected:
-        App*                   m_App;
-        EBackend               m_Backend;
-        Window*                m_Window;
-        ResourceClass<Shader>  m_Shaders;
-        ResourceClass<Texture> m_Textures;
-        ResourceClass<Font>    m_Fonts;
-        util::LoadThread       m_LoadThread;
+        App*                              m_App;
+        EBackend                          m_Backend;
+        Window*                           m_Window;
+        ResourceClass<Shader>             m_Shaders;
+        util::MPSCStack<Resource::Handle> m_DirtyTextures; /// Handles of written textures, outlives m_Textures.
+        ResourceClass<Texture>            m_Textures;
+        ResourceClass<Font>               m_Fonts;
+        util::LoadPool                    m_LoadPool;
+        TextureResidency                  m_Residency;
+        TextureStreamer                   m_Streamer;
+        TextureAtlas                      m_Atlas;
     };
 
 }
\ No newline at end of file
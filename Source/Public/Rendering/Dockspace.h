@@ -2,6 +2,7 @@
 #include "Core/Common.h"
 #include "Core/Object.h"
 #include "Core/Resource.h"
+#include "Rendering/TextureAtlas.h"
 
 namespace aby {
 
@@ -33,9 +34,9 @@ namespace aby {
         void draw_menubar(App* app);
     private:
         struct Icons {
-            Resource minimize;
-            Resource maximize;
-            Resource exit;
+            std::optional<TextureAtlas::Sprite> minimize;
+            std::optional<TextureAtlas::Sprite> maximize;
+            std::optional<TextureAtlas::Sprite> exit;
         } m_Icons;
         std::vector<Menu> m_Menus;
     };
@@ -27,8 +27,13 @@ namespace aby {
         float             text_height() const;
         float             char_width() const;
         glm::vec2         measure(const std::string& text) const;
+        /**
+        * Bytes of glyph metrics kept on the cpu, the atlas is accounted for by its texture.
+        */
+        u64               bytes() const;
+        u64               device_bytes() const;
     protected:
-        Font(Context* ctx, const fs::path& path, const glm::vec2& dpi, u32 pt = 14);
+        Font(ft::FontData&& data, Resource texture, u32 pt = 14);
     private:
         u32 m_SizePt;
         ft::FontData  m_Data;
@@ -0,0 +1,54 @@
+#pragma once
+#include "Core/Common.h"
+#include "Utility/File.h"
+#include <optional>
+#include <span>
+#include <string_view>
+#include <glm/glm.hpp>
+
+namespace aby {
+
+    /**
+    * Decoded pixels of image files, stored under App::cache()/"Images" when AppInfo::cache_images is set.
+    *
+    * Entries are keyed by a hash of the encoded file content and the decoder version, so an edited file
+    * or an updated decoder never hits a stale entry. A hit is mapped through util::MappedFile and its
+    * pixels are used as is, without any decompression. Safe to use from the loading threads.
+    */
+    class ImageCache {
+    public:
+        /**
+        * A mapped cache entry, its pixels are valid while the entry is alive.
+        */
+        struct Entry {
+            util::MappedFile           file;
+            glm::u32vec2               size     = { 0, 0 };
+            u32                        channels = 0;
+            std::span<const std::byte> pixels   = {}; /// Tightly packed, size.x * size.y * channels bytes.
+        };
+
+        explicit ImageCache(const fs::path& dir);
+
+        /**
+        * Key of an image file, FNV-1a of its content combined with the decoder version.
+        */
+        static u64 key(std::string_view encoded);
+
+        /**
+        * Map the entry of a key.
+        * @return std::nullopt if there is none or it was written by another version.
+        */
+        std::optional<Entry> find(u64 key) const;
+        /**
+        * Write the decoded pixels of a key, replacing its entry atomically.
+        */
+        bool store(u64 key, const glm::u32vec2& size, u32 channels, std::span<const std::byte> pixels) const;
+
+        const fs::path& dir() const;
+    private:
+        fs::path path(u64 key) const;
+    private:
+        fs::path m_Dir;
+    };
+
+}
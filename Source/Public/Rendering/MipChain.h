@@ -0,0 +1,96 @@
+#pragma once
+#include "Core/Common.h"
+#include "Rendering/Texture.h"
+#include <span>
+#include <glm/glm.hpp>
+
+namespace aby::util {
+    class LoadPool;
+}
+
+namespace aby {
+
+    /**
+    * One level of a mip chain inside a contiguous buffer.
+    */
+    struct MipLevel {
+        glm::u32vec2 size   = { 0, 0 };
+        std::size_t  offset = 0; /// Byte offset of the level in the chain.
+        std::size_t  bytes  = 0; /// Tightly packed size of the level, or of its blocks.
+    };
+
+    /**
+    * Layout of a mip chain stored level after level in one buffer, e.g. staging memory.
+    * Every level starts at a multiple of lcm(texel, 16) so it can be copied to its
+    * image subresource straight from the buffer. Block compressed levels start at a multiple of 16,
+    * the layout of compressed images in the asset archive.
+    */
+    class MipChain {
+    public:
+        /**
+        * @param size     Size of level 0
+        * @param channels Bytes per texel
+        * @param levels   Number of levels, zero for the full chain down to 1x1
+        */
+        MipChain(const glm::u32vec2& size, u32 channels, u32 levels = 0);
+        /**
+        * @param size   Size of level 0
+        * @param format Block compression of every level
+        * @param levels Number of levels, zero for the full chain down to 1x1
+        */
+        MipChain(const glm::u32vec2& size, util::EBlockFormat format, u32 levels = 0);
+
+        /**
+        * Number of levels of a full chain, floor(log2(max(w, h))) + 1.
+        */
+        static u32 full_levels(const glm::u32vec2& size);
+
+        /**
+        * Downsample level 0 of pixels into every following level, each level is filtered from the previous one.
+        * Filtering is done by stb_image_resize2 (SIMD) in linear space for SRGB color channels.
+        * The rows of a level are split across the loading threads of pool and the calling thread,
+        * without a pool everything runs on the calling thread.
+        *
+        * @param pixels Buffer of at least bytes(), level 0 already written
+        * @param format Color format of the texels, block compressed chains can not be generated
+        * @param pool   Loading threads to split levels over
+        */
+        void generate(std::span<std::byte> pixels, ETextureFormat format, util::LoadPool* pool = nullptr) const;
+        /**
+        * Read the levels after level 0 from a file written by save.
+        * @return false if the file is missing or was written for a different chain.
+        */
+        bool load(const fs::path& file, std::span<std::byte> pixels) const;
+        /**
+        * Write the levels after level 0 of pixels to a file, replacing it atomically.
+        */
+        bool save(const fs::path& file, std::span<const std::byte> pixels) const;
+
+        u32                       levels() const;
+        u32                       channels() const;
+        util::EBlockFormat        block() const;
+        const MipLevel&           level(u32 index) const;
+        std::span<const MipLevel> all() const;
+        /**
+        * Bytes of the whole chain including alignment padding.
+        */
+        std::size_t               bytes() const;
+    private:
+        MipChain(const glm::u32vec2& size, u32 channels, util::EBlockFormat format, u32 levels);
+    private:
+        u32                   m_Channels;
+        util::EBlockFormat    m_Block;
+        std::vector<MipLevel> m_Levels;
+        std::size_t           m_Bytes;
+    };
+
+    /**
+    * Box filter an image to another size in a single pass, e.g. the preview of a streamed texture.
+    * Filtering is done in linear space for SRGB color channels.
+    * @param src    Tightly packed pixels of src_size
+    * @param dst    Buffer of at least dst_size texels
+    * @param format Color format of both images
+    */
+    void downsample(std::span<const std::byte> src, const glm::u32vec2& src_size, std::span<std::byte> dst, const glm::u32vec2& dst_size, ETextureFormat format);
+
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include "Core/Common.h"
+#include <span>
+#include <vector>
+
+namespace aby {
+
+    enum class EBlend : u8 {
+        NONE  = 0, /// Opaque, drawn before the blended draws of its layer.
+        ALPHA = 1, /// Blended over what is behind it.
+    };
+
+    /**
+    * Sort state of the draw calls that follow it, see Renderer::set_draw_order().
+    */
+    struct DrawOrder {
+        u8     layer = 0;             /// Higher layers are drawn over lower ones.
+        EBlend blend = EBlend::ALPHA; /// Opaque draws of a layer are drawn before its blended ones.
+        float  depth = 0.f;           /// Larger is further away.
+    };
+
+    /**
+    * A range of primitives (vertices or instances) in one batch of a stream, drawn with a single call.
+    */
+    struct DrawPacket {
+        u64 key;
+        u32 stream; /// Backend defined, the buffers and pipeline the range is drawn with.
+        u32 batch;
+        u32 first;
+        u32 count;
+    };
+
+    /**
+    * Counters of the last RenderQueue::sort(), the savings are packets - draws and unsorted_binds - pipeline_binds.
+    */
+    struct RenderQueueStats {
+        u64 packets        = 0; /// Packets recorded, the draws of submitting them as they came.
+        u64 draws          = 0; /// Draws left after merging packets that continue each other.
+        u64 pipeline_binds = 0; /// Pipeline changes in sorted order.
+        u64 unsorted_binds = 0; /// Pipeline changes in submission order.
+    };
+
+    /**
+    * Draw packets of a frame ordered by 64-bit sort keys, from most to least significant:
+    *   layer (8) | blend (1) | depth, back to front (32) | submission sequence (23)
+    * The pipelines have no depth attachment, so opaque draws are layered back to front like blended
+    * ones, and draws of a layer at the same depth keep the order they were recorded in whatever stream
+    * they went to. Neither stream nor texture is part of the key, grouping by them would reorder
+    * overlapping draws. The sequence saturates, the stable sort keeps the order of later packets.
+    */
+    class RenderQueue {
+    public:
+        /**
+        * @param pipelines The pipeline each stream is drawn with, indexed by stream, used to count binds.
+        */
+        explicit RenderQueue(std::vector<u32> pipelines);
+
+        static u64 make_key(const DrawOrder& order, u32 sequence);
+
+        /**
+        * Record count primitives starting at first in a batch of a stream.
+        * Consecutive pushes that continue each other in one batch become a single draw.
+        */
+        void push(const DrawOrder& order, u32 stream, u32 batch, u32 first, u32 count);
+        void clear();
+        /**
+        * Radix sort the packets by key and merge the ones that continue the previous packet
+        * in the same batch, the result stays valid until the next push() or clear().
+        */
+        std::span<const DrawPacket> sort();
+
+        std::span<const DrawPacket> packets() const;
+        const RenderQueueStats&     stats() const;
+        std::size_t                 size() const;
+        bool                        empty() const;
+    private:
+        std::vector<u32>        m_Pipelines;
+        std::vector<DrawPacket> m_Packets;
+        std::vector<DrawPacket> m_Scratch;
+        RenderQueueStats        m_Stats;         /// Of the last sort(), kept until the next one.
+        u64                     m_UnsortedBinds;
+        u32                     m_Sequence;      /// Packets pushed since the last clear().
+        u32                     m_LastPipeline;  /// Pipeline of the last packet pushed.
+    };
+
+}
@@ -3,6 +3,7 @@
 #include "Core/Common.h"
 #include "Core/Event.h"
 #include "Rendering/Context.h"
+#include "Rendering/RenderQueue.h"
 #include "Rendering/Vertex.h"
 
 namespace aby {
@@ -18,9 +19,26 @@ namespace aby {
 		virtual void on_begin(const glm::mat4& view_projection) = 0;
 		virtual void on_begin() = 0;
 		virtual void on_end() = 0;
+
+		/**
+		* Layer, blend mode and depth the following draws are sorted by, reset to DrawOrder{} by on_begin().
+		* Draws are recorded into a RenderQueue and submitted sorted in on_end().
+		*/
+		virtual void set_draw_order(const DrawOrder& order) = 0;
+		virtual const RenderQueueStats& queue_stats() const = 0;
 		
 		virtual void draw_triangle(const Triangle& triangle) = 0;
+		/**
+		* Drawn as an instance with its own pipeline, yet in submission order with text and triangles
+		* of the same layer and depth: a quad drawn after text covers it.
+		*/
 		virtual void draw_quad(const Quad& quad) = 0;
+		/**
+		* Submit many primitives at once, written in bulk instead of one call per primitive.
+		* Unlike draw_quad, fully transparent quads are not skipped.
+		*/
+		virtual void draw_triangles(std::span<const Triangle> triangles) = 0;
+		virtual void draw_quads(std::span<const Quad> quads) = 0;
 		virtual void draw_cube(const Quad& quad) = 0;
 		virtual void draw_text(const Text& text) = 0;
 	};
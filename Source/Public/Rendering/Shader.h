@@ -18,9 +18,18 @@ namespace aby {
 	class Shader {
 	public:
 		static Resource create(Context* ctx, const fs::path& path, EShader type = EShader::FROM_EXT);
+		virtual ~Shader() = default;
 
 		EShader type() const;
 		std::span<const u32> data() const;
+		/**
+		* Get the number of bytes of spirv kept on the cpu
+		*/
+		u64 bytes() const;
+		/**
+		* Get the number of bytes the backend shader object is estimated to occupy
+		*/
+		virtual u64 device_bytes() const;
 	protected:
 		Shader(const std::vector<u32>& data, EShader type);
 	protected:
@@ -1,16 +1,23 @@
 #pragma once
 #include "Core/Common.h"
 #include "Core/Resource.h"
+#include "Utility/BlockCompression.h"
+#include "Utility/Thread.h"
 #include <span>
+#include <atomic>
+#include <mutex>
 #include <glm/glm.hpp>
 #include <imgui/imgui.h>
 
 namespace aby {
 
     class Context;
+    class TextureResidency;
 
     /**
     * The byte color format of the texture.
+    * Block compressed formats hold 4x4 texel blocks (see Utility/BlockCompression.h),
+    * decode to RGBA and can not be written to.
     */
     enum class ETextureFormat {
         NONE,
@@ -18,9 +25,21 @@ namespace aby {
         RG,
         RGB,
         RGBA,
-        BGRA
+        BGRA,
+        BC1,
+        BC3,
+        BC7,
     };
 
+    /**
+    * Block compression of a texture format, EBlockFormat::NONE for uncompressed formats.
+    */
+    util::EBlockFormat block_format(ETextureFormat format);
+    /**
+    * Bytes of one image level, the blocks covering it for block compressed formats.
+    */
+    u64 texture_bytes(const glm::u32vec2& size, u32 channels, ETextureFormat format);
+
     /**
     * Represents the textures state.
     */
@@ -28,6 +47,36 @@ namespace aby {
         GOOD     = 0, /// Nothing needs to be done texture is valid.
         RECREATE = 1, /// Texture has been written to and resized needs recreation.
         UPLOAD   = 2, /// Texture has been written to and requires gpu upload.
+        REGION   = 3, /// Parts of the texture have been written to, only those require gpu upload.
+    };
+
+    /**
+    * Options of textures loaded from files.
+    */
+    enum class ETextureLoad {
+        NONE       = 0,
+        KEEP_DATA  = BIT(0), /// Keep a cpu side copy of the pixels (Texture::data).
+        MIPS       = BIT(1), /// Generate the full mip chain on the loading threads and upload it with level 0.
+        CACHE_MIPS = BIT(2), /// Store generated mips under App::cache() and reuse them while the file is unchanged, implies MIPS.
+        STREAM     = BIT(3), /// Bind a small preview first, the full image is uploaded later within the streaming budget (TextureStreamer).
+    };
+    DECLARE_ENUM_OPS(ETextureLoad);
+
+    /**
+    * Rectangle of texels, offset is the top left corner.
+    */
+    struct TextureRegion {
+        glm::u32vec2 offset = { 0, 0 };
+        glm::u32vec2 extent = { 0, 0 };
+
+        bool          overlaps(const TextureRegion& other) const;
+        TextureRegion merged(const TextureRegion& other) const;
+        u64           area() const;
+        /**
+        * Add a region to a list of non overlapping regions,
+        * every region it overlaps is merged into its bounding rectangle.
+        */
+        static void insert(std::vector<TextureRegion>& regions, TextureRegion region);
     };
 
     class Texture {
@@ -41,10 +90,11 @@ namespace aby {
         /**
         * Create a texture from a path.
         * 
-        * @param ctx App context
-        * @param path Filepath to texture
+        * @param ctx     App context
+        * @param path    Filepath to texture
+        * @param options Load options
         */
-        static Resource create(Context* ctx, const fs::path& path);
+        static Resource create(Context* ctx, const fs::path& path, ETextureLoad options = ETextureLoad::NONE);
         /**
         * Create a texture filled with a certain color.
         * 
@@ -73,11 +123,38 @@ namespace aby {
         * @param format Texture color format
         */
         static Resource create(Context* ctx, const glm::u32vec2& size, const void* data, u32 channels, ETextureFormat format = ETextureFormat::RGBA);
+        /**
+        * Create textures from a set of files in one go.
+        * Files are decoded in parallel on the loading threads straight into staging memory,
+        * then every image is uploaded with a single command buffer submission.
+        * 
+        * @param ctx     App context
+        * @param paths   Filepaths to textures
+        * @param options Load options of every texture
+        * @return One reserved handle per path, in order
+        */
+        static std::vector<Resource> create_batch(Context* ctx, std::span<const fs::path> paths, ETextureLoad options = ETextureLoad::NONE);
+        /**
+        * Queue the load graph of a file texture into a reserved handle:
+        * decode (worker) -> upload (main) -> bind (main, swaps the texture in and writes its descriptors).
+        * 
+        * @param ctx       App context
+        * @param texture   Reserved texture handle
+        * @param name      Label for the load graph nodes
+        * @param path      Resolves the file path when decoding starts, so a dependency may produce it
+        * @param deps      Nodes that must complete before decoding
+        * @param options   Load options, without KEEP_DATA the pixels only live in staging memory until uploaded
+        * @return The bind node, with STREAM the node binding the preview
+        */
+        static util::LoadPool::Node load(Context* ctx, Resource texture, const std::string& name, std::function<fs::path()> path, const std::vector<util::LoadPool::Node>& deps = {}, ETextureLoad options = ETextureLoad::NONE);
 
         virtual ~Texture() = default;
         
         /**
         * Upload data to cpu side marking texture as dirty.
+        * Writes may come from any thread, the texture is queued and synced by the main thread at the end of the frame.
+        * A mip chain generated at load time is dropped, the image is recreated with a single level.
+        * Block compressed textures can not be written to.
         * 
         * @param size Texture size
         * @param data vector of bytes
@@ -91,6 +168,16 @@ namespace aby {
         */
         void write(const glm::u32vec2& size, const void* data);
         /**
+        * Write part of the texture on the cpu side, only the written regions are uploaded on sync.
+        * Requires the cpu side copy of the pixels (KEEP_DATA when loaded from a file) and an uncompressed format.
+        * On a texture with a mip chain the whole image is recreated with a single level instead.
+        * 
+        * @param offset Top left texel of the region
+        * @param extent Size of the region
+        * @param data   Tightly packed pixels of the region
+        */
+        void write_region(const glm::u32vec2& offset, const glm::u32vec2& extent, const void* data);
+        /**
         * @brief Set debug name to be used by validation errors and render tools.
         */
         virtual void set_dbg_name(const std::string& name) = 0;
@@ -111,6 +198,27 @@ namespace aby {
         */    
         u64 bytes() const;
         /**
+        * Get the number of mip levels of the image
+        */
+        u32 levels() const;
+        /**
+        * Get the options the texture was loaded from a file with
+        */
+        ETextureLoad load_options() const;
+        /**
+        * Get the number of bytes the texture image occupies on the device, every mip level included
+        */
+        virtual u64 device_bytes() const;
+        /**
+        * Get the file the texture was loaded from, empty if it was not loaded from a file
+        */
+        const fs::path& source() const;
+        /**
+        * Drop the cpu side copy of the texture data, the device image is kept.
+        * Ignored while the texture is dirty.
+        */
+        void release_data();
+        /**
         * Get the texture format
         */
         ETextureFormat format() const;
@@ -133,18 +241,61 @@ namespace aby {
         Texture(const fs::path& path);
         Texture(const glm::u32vec2& size, const glm::vec4& color = glm::vec4(1.0f));
         Texture(const glm::u32vec2& size, const std::vector<std::byte>& data, u32 channels, ETextureFormat format = ETextureFormat::RGBA);
+        Texture(const glm::u32vec2& size, std::vector<std::byte>&& data, u32 channels, ETextureFormat format = ETextureFormat::RGBA);
         Texture(const glm::u32vec2& size, const void* data, u32 channels, ETextureFormat format = ETextureFormat::RGBA);
+        /**
+        * Texture whose pixels are uploaded by the backend, data is an optional cpu side copy of level 0.
+        */
+        Texture(const glm::u32vec2& size, u32 channels, ETextureFormat format, std::span<const std::byte> data, u32 levels = 1);
         Texture(const Texture& other);
         Texture(Texture&& other) noexcept;
+        /**
+        * Report a change of bytes() or device_bytes() to the residency manager, m_Mutex must be held.
+        */
+        void account();
+    private:
+        friend class Context;
+        friend class TextureQueueHandler;
+        friend class TextureResidency;
+        /**
+        * Load graph of ETextureLoad::STREAM: decode, preview, mips and a stream node queueing the full image.
+        */
+        static util::LoadPool::Node stream(Context* ctx, Resource texture, const std::string& name, std::function<fs::path()> path, const std::vector<util::LoadPool::Node>& deps, ETextureLoad options);
+        /**
+        * Push the handle onto the dirty queue of the context, once until the texture is synced.
+        */
+        void queue_sync();
     private:
         glm::u32vec2    m_Size;
         u32             m_Channels;
+        u32             m_Levels;
     protected:
         ETextureFormat  m_AbyFormat;
         ETextureState   m_State;
+        std::vector<TextureRegion> m_Dirty; /// Regions written since the last sync while m_State is REGION.
+        std::mutex      m_Mutex;            /// Guards the cpu side data, writes may come from any thread.
 
     private:
         std::vector<std::byte> m_Data;
+        fs::path               m_Source;
+        ETextureLoad           m_Options = ETextureLoad::NONE;
+        util::MPSCStack<Resource::Handle>* m_Queue       = nullptr; /// Dirty queue of the context, set once added to it.
+        Resource::Handle                   m_QueueHandle = Resource::null;
+        std::atomic<bool>                  m_Queued      = false;
+        TextureResidency*                  m_Residency   = nullptr; /// Counts the bytes while the texture is bound to a handle.
+        u64                                m_CpuCounted  = 0;       /// bytes() as last reported to m_Residency.
+        u64                                m_GpuCounted  = 0;       /// device_bytes() as last reported to m_Residency.
+    };
+
+    /**
+    * Counters of a streaming BufferedTexture.
+    */
+    struct StreamStats {
+        u64 published = 0; /// Frames published by the producer.
+        u64 presented = 0; /// Frames uploaded by sync().
+        u64 dropped   = 0; /// Frames replaced by a newer one before sync() picked them up.
+        u64 starved   = 0; /// acquire() calls that found no free slot.
+        u64 bytes     = 0; /// Bytes uploaded by sync().
     };
 
     class BufferedTexture {
@@ -161,6 +312,30 @@ namespace aby {
         virtual void set_dbg_name(const std::string& name) = 0;
         virtual void set_max_buffers(std::size_t frames) = 0;
 
+        /**
+        * Switch to streaming, for frames produced on another thread (video decoding, procedural generation).
+        * Every frame in flight plus two get a persistently mapped staging slot of size() * channels() bytes,
+        * the size is fixed from then on and write() may no longer be used. Main thread only.
+        */
+        virtual void stream() = 0;
+        /**
+        * Producer thread, one at a time. Free slot to write the next frame into, lock-free.
+        * @return Mapped memory of size() * channels() bytes, empty if every slot is held (the frame is skipped).
+        */
+        virtual std::span<std::byte> acquire() = 0;
+        /**
+        * Producer thread. Publish the acquired slot as the newest frame,
+        * replacing the previous frame if sync() has not picked it up yet.
+        */
+        virtual void publish() = 0;
+        /**
+        * Render thread, once per frame. Queue the upload of the newest published frame into the next image
+        * from its slot, without copying or waiting. Slots the gpu has finished copying from are handed back.
+        * @return false if nothing was published since the last call.
+        */
+        virtual bool sync() = 0;
+        virtual StreamStats stream_stats() const = 0;
+
         virtual glm::u32vec2 size() const = 0;
         virtual u32 channels() const = 0;
         virtual ETextureFormat format() const = 0; 
@@ -0,0 +1,120 @@
+#pragma once
+#include "Core/Common.h"
+#include "Core/Resource.h"
+#include "Rendering/Vertex.h"
+#include <optional>
+#include <span>
+#include <glm/glm.hpp>
+#include <imgui/imgui.h>
+
+namespace aby {
+
+    class Context;
+
+    /**
+    * Skyline bottom-left rectangle packer.
+    * The skyline is the top edge of everything placed so far, a rectangle is put where it ends up lowest.
+    */
+    class SkylinePacker {
+    public:
+        explicit SkylinePacker(const glm::u32vec2& size);
+
+        /**
+        * @return Top left corner of the rectangle, nullopt if it does not fit.
+        */
+        std::optional<glm::u32vec2> insert(const glm::u32vec2& size);
+        /**
+        * Enlarge the area, rectangles placed so far keep their position.
+        */
+        void grow(const glm::u32vec2& size);
+
+        const glm::u32vec2& size() const;
+        /**
+        * Area of the placed rectangles.
+        */
+        u64 used() const;
+    private:
+        struct Node {
+            u32 x;
+            u32 y;
+            u32 width;
+        };
+        std::optional<u32> fit(std::size_t index, const glm::u32vec2& size) const;
+    private:
+        glm::u32vec2      m_Size;
+        std::vector<Node> m_Skyline; /// Sorted by x and covering the whole width.
+        u64               m_Used;
+    };
+
+    /**
+    * Where a sprite currently lives in the atlas.
+    */
+    struct AtlasRegion {
+        Resource  texture   = {};       /// Page texture.
+        glm::vec2 uv_offset = { 0, 0 }; /// Top left uv.
+        glm::vec2 uv_scale  = { 1, 1 }; /// Size in uv.
+
+        /**
+        * Sample this region on a quad, Quad::texinfo.xy holds the uv offset and Quad::uvs the uv scale.
+        */
+        void   apply(Quad& quad) const;
+        ImVec2 uv0() const;
+        ImVec2 uv1() const;
+    };
+
+    /**
+    * Packs small RGBA images into shared page textures, so sprites share one image, sampler,
+    * bindless slot and ImGui descriptor. A page starts small and doubles until it reaches the
+    * maximum size, then a new page is started.
+    * Pages keep their cpu side pixels (they are pinned in the residency manager) and sprites are
+    * written with Texture::write_region. Main thread only.
+    */
+    class TextureAtlas {
+    public:
+        using Sprite = u32;
+
+        TextureAtlas(Context* ctx, const glm::u32vec2& page_size = { 256, 256 }, const glm::u32vec2& max_page_size = { 2048, 2048 }, u32 padding = 1);
+
+        /**
+        * Add an image to the atlas.
+        *
+        * @param size     Image size
+        * @param data     Tightly packed pixels
+        * @param channels Number of channels, expanded to RGBA
+        * @return nullopt if the image is larger than a page
+        */
+        std::optional<Sprite> add(const glm::u32vec2& size, const void* data, u32 channels);
+        /**
+        * Decode an image file (or its pre-decoded archive entry) into the atlas.
+        */
+        std::optional<Sprite> add(const fs::path& path);
+
+        /**
+        * Current page and uvs of a sprite, the uvs change when its page grows so query them when drawing.
+        */
+        AtlasRegion region(Sprite sprite) const;
+        std::size_t pages() const;
+        Resource    page(std::size_t index) const;
+        std::size_t sprites() const;
+    private:
+        struct Page {
+            Resource      texture;
+            SkylinePacker packer;
+        };
+        struct Entry {
+            u32          page;
+            glm::u32vec2 pos;
+            glm::u32vec2 size;
+        };
+        std::optional<glm::u32vec2> place(Page& page, const glm::u32vec2& size);
+        Page& add_page();
+    private:
+        Context*           m_Ctx;
+        glm::u32vec2       m_PageSize;
+        glm::u32vec2       m_MaxPageSize;
+        u32                m_Padding;
+        std::vector<Page>  m_Pages;
+        std::vector<Entry> m_Sprites;
+    };
+
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include "Core/Common.h"
+#include "Core/Resource.h"
+#include "Rendering/Texture.h"
+#include <atomic>
+#include <vector>
+
+namespace aby {
+
+    class Context;
+    class Texture;
+
+    /**
+    * Keeps the memory held by ResourceClass<Texture> within a cpu and a gpu byte budget.
+    *
+    * Textures bound to a handle report their byte counts as they change, so the totals are always current.
+    * Draws touch the textures they sample, once per frame update() checks the totals and only when a
+    * budget is exceeded evicts the least recently used textures until both budgets are met:
+    *   - Over the cpu budget the cpu side copy of a texture is dropped, its image stays resident.
+    *   - Over the gpu budget a texture loaded from a file is unloaded, its handle resolves to the
+    *     placeholder and the file is loaded again the next time the handle is touched.
+    * Textures sampled by frames still in flight are never evicted. A pass that finds nothing to evict is
+    * not repeated until the totals change or one of those textures leaves the frames in flight.
+    * Main thread only.
+    */
+    class TextureResidency {
+    public:
+        TextureResidency(Context* ctx, u64 cpu_budget, u64 gpu_budget);
+
+        /**
+        * Mark a texture as used this frame, reloading it if it was unloaded.
+        */
+        void touch(Resource texture);
+        /**
+        * Mark a texture as used this frame by its slot index (e.g. Vertex::texinfo.z).
+        */
+        void touch(u32 index);
+        /**
+        * Never evict a texture, neither its image nor its cpu side copy (e.g. atlas pages that are written to).
+        */
+        void pin(Resource texture);
+        void unpin(Resource texture);
+        /**
+        * Advance the frame, free unloaded textures no frame in flight can sample anymore and enforce the budgets.
+        */
+        void update();
+        /**
+        * Forget every texture and free the unloaded ones, before the backend is destroyed.
+        */
+        void clear();
+        /**
+        * Count the bytes of a texture bound to a handle until detach(), its changes come in through count().
+        * A handle new to its slot starts the slot over, nothing of a recycled slot's previous texture is kept.
+        */
+        void attach(Resource::Handle handle, Texture& texture);
+        void detach(Texture& texture);
+        /**
+        * Add to the byte totals, called by textures when their data or image changes size, from any thread.
+        */
+        void count(i64 cpu_bytes, i64 gpu_bytes);
+
+        void set_budgets(u64 cpu_budget, u64 gpu_budget);
+        u64  cpu_budget() const;
+        u64  gpu_budget() const;
+        /**
+        * Bytes of cpu side texture data.
+        */
+        u64  cpu_bytes() const;
+        /**
+        * Bytes of texture images.
+        */
+        u64  gpu_bytes() const;
+        u64  frame() const;
+        /**
+        * Frame a texture was last drawn on, zero if it never was.
+        */
+        u64  last_used(Resource texture) const;
+    private:
+        struct Entry {
+            Resource::Handle handle = static_cast<Resource::Handle>(Resource::null); /// Handle the state below belongs to.
+            u64          last_used = 0;
+            Resource     unloaded  = {};    /// Handle currently bound to the placeholder by the residency manager.
+            fs::path     source    = {};    /// File the unloaded texture is reloaded from.
+            ETextureLoad options   = ETextureLoad::NONE; /// Options it is reloaded with.
+            bool         reloading = false;
+            Resource     pinned    = {};    /// Handle of the texture in this slot that must not be evicted.
+        };
+        struct Retired {
+            u64          frame;
+            Ref<Texture> texture;
+        };
+
+        Entry& entry(u32 index);
+        void   reload(Entry& entry);
+        void   enforce_budgets();
+    private:
+        Context*             m_Ctx;
+        bool                 m_Stalled;      /// The last pass over budget evicted nothing.
+        u64                  m_StalledCpu;   /// Totals when it did.
+        u64                  m_StalledGpu;
+        u64                  m_NextScan;     /// Frame the first texture skipped for being in flight becomes evictable.
+        u64                  m_CpuBudget;
+        u64                  m_GpuBudget;
+        std::atomic<u64>     m_CpuBytes;
+        std::atomic<u64>     m_GpuBytes;
+        u64                  m_Frame;
+        u64                  m_FramesInFlight;
+        std::vector<Entry>   m_Entries;     /// Indexed by texture slot index.
+        std::vector<Retired> m_Retired;
+    };
+
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include "Core/Common.h"
+#include "Core/Resource.h"
+#include <functional>
+#include <vector>
+
+namespace aby {
+
+    class Context;
+
+    /**
+    * Uploads the full resolution images of streamed textures (ETextureLoad::STREAM) within a per frame byte budget.
+    *
+    * A streamed texture is bound to a small preview as soon as it is decoded, its full image waits
+    * here until update() picks it. Textures drawn most recently go first (TextureResidency::last_used),
+    * then the order they were queued in. Main thread only.
+    */
+    class TextureStreamer {
+    public:
+        using Upload = std::function<void()>;
+
+        TextureStreamer(Context* ctx, u64 budget);
+
+        /**
+        * Queue the full resolution image of a texture.
+        * @param texture Handle currently bound to the preview
+        * @param bytes   Bytes the upload copies, counted against the budget
+        * @param upload  Creates the full resolution texture and binds it to the handle
+        */
+        void enqueue(Resource texture, u64 bytes, Upload&& upload);
+        /**
+        * Upload pending images in priority order until the budget of this frame is used up.
+        * The first image of a frame is always uploaded, so images larger than the budget still arrive.
+        * Images of erased textures are dropped.
+        * @return Bytes uploaded.
+        */
+        u64 update();
+        /**
+        * Drop every pending image, before the backend is destroyed.
+        */
+        void clear();
+
+        void        set_budget(u64 budget);
+        u64         budget() const;
+        std::size_t pending() const;
+        u64         pending_bytes() const;
+    private:
+        struct Pending {
+            Resource texture;
+            u64      bytes;
+            u64      order;
+            Upload   upload;
+        };
+    private:
+        Context*             m_Ctx;
+        u64                  m_Budget;
+        u64                  m_Order;
+        u64                  m_PendingBytes;
+        std::vector<Pending> m_Pending;
+    };
+
+}
@@ -1,7 +1,9 @@
 #pragma once
 #include "Core/Common.h"
 #include <glm/glm.hpp>
+#include <glm/gtc/type_precision.hpp>
 #include <string>
+#include <span>
 
 namespace aby {
     
@@ -19,6 +21,21 @@ namespace aby {
         glm::vec2    uvs;
     };
 
+    /**
+    * Compact vertex for shaders taking the packed layout (PackedVertex.glsl), 24 bytes instead of 48.
+    * The texcoord is stored as 16-bit unorm, so it must lie in [0, 1] once the uvs are applied.
+    */
+    struct PackedVertex {
+        PackedVertex(const glm::vec3& pos, u32 col, const glm::u16vec2& texcoord, u16 texture);
+        PackedVertex(const Vertex& vertex);
+
+        glm::vec3    pos;
+        u32          col;      // RGBA8 unorm
+        glm::u16vec2 texcoord; // 16-bit unorm, texinfo.xy * uvs
+        u16          texture;
+    };
+    static_assert(sizeof(PackedVertex) == 24, "PackedVertex must match the inputs of PackedVertex.glsl");
+
     struct Triangle {
         Triangle(const Vertex& v1, const Vertex& v2, const Vertex& v3);
         Triangle(const Triangle& other);
@@ -38,6 +55,28 @@ namespace aby {
         glm::vec3 size;
     };
 
+    /**
+    * Per-instance record of an instanced quad, the quad vertex shader expands it into its corners.
+    * 44 bytes instead of the four 48 byte vertices of an indexed quad.
+    */
+    struct QuadInstance {
+        QuadInstance(const Quad& quad);
+
+        glm::vec3 pos;     // center
+        glm::vec2 size;
+        u32       col;     // RGBA8 unorm
+        u32       texture;
+        glm::vec4 uvs;     // xy = texcoord, zw = extent
+    };
+    static_assert(sizeof(QuadInstance) == 44, "QuadInstance must match the inputs of Quad.glsl");
+
+    /**
+    * Write the instance of every quad to out, which must have room for quads.size() instances.
+    * Colors and texture indices of four quads are converted at once with SSE2 where available,
+    * the result matches QuadInstance(quad) up to the rounding of color halves.
+    */
+    void pack_quads(std::span<const Quad> quads, QuadInstance* out);
+
     struct Text {
         Text(const std::string& text, const glm::vec2& pos, const glm::vec4& color = { 1, 1, 1, 1 }, float scale = 1.f, u32 font = 0);
 
@@ -0,0 +1,61 @@
+#pragma once
+#include "Core/Common.h"
+#include "Utility/ArchiveFormat.h"
+#include "Utility/File.h"
+#include <optional>
+#include <span>
+
+namespace aby::util {
+
+    /**
+    * Pixels of a pre-decoded image, pointing into the mapped archive.
+    * Block compressed images hold their whole mip chain (see ArchiveImage).
+    */
+    struct ArchiveImageView {
+        glm::u32vec2               size     = { 0, 0 };
+        u32                        channels = 0;
+        u32                        levels   = 1;
+        EBlockFormat               format   = EBlockFormat::NONE;
+        std::span<const std::byte> pixels   = {};
+    };
+
+    /**
+    * Read only view over an asset archive produced by aby_package.
+    * The file is mapped once and every lookup returns views into the mapping,
+    * nothing is parsed or copied beyond validating the header and index on open.
+    */
+    class Archive {
+    public:
+        explicit Archive(const fs::path& path);
+        Archive(const Archive&) = delete;
+        Archive(Archive&&) = delete;
+
+        /**
+        * Binary search of the index by name hash.
+        * @return nullptr if the archive has no entry with this name and kind.
+        */
+        const ArchiveEntry* find(std::string_view name, EArchiveEntry kind) const;
+        std::span<const std::byte> data(const ArchiveEntry& entry) const;
+        std::string_view           name(const ArchiveEntry& entry) const;
+        std::optional<ArchiveImageView> image(std::string_view name) const;
+        std::span<const ArchiveEntry>   entries() const;
+        const fs::path& path() const;
+        FileError error() const;
+
+        /**
+        * Name of a file inside the archive, its path relative to root using '/'.
+        */
+        static std::string key(const fs::path& root, const fs::path& path);
+
+        explicit operator bool() const;
+        Archive& operator=(const Archive&) = delete;
+        Archive& operator=(Archive&&) = delete;
+    private:
+        MappedFile                    m_File;
+        fs::path                      m_Path;
+        std::span<const ArchiveEntry> m_Entries;
+        std::string_view              m_Names;
+        FileError                     m_Error;
+    };
+
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include "Utility/BlockCompression.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+/**
+* On disk layout of the asset archive written by tools/aby_package and mapped by util::Archive.
+* Only depends on the standard library so tools can share it without linking the engine.
+*
+*   [ArchiveHeader][blob]...[blob][ArchiveEntry * entry_count][names]
+*
+* Blobs and the index are aligned to ARCHIVE_ALIGNMENT so they can be used in place from the mapping.
+* The index is sorted by name hash, names are paths relative to the bin directory using '/'.
+*/
+namespace aby::util {
+
+    constexpr std::array<char, 8> ARCHIVE_MAGIC     = { 'A', 'B', 'Y', 'P', 'A', 'C', 'K', '\0' };
+    constexpr std::uint32_t       ARCHIVE_VERSION   = 2;
+    constexpr std::uint64_t       ARCHIVE_ALIGNMENT = 16;
+    constexpr std::string_view    ARCHIVE_NAME      = "Assets.abypack";
+    /**
+    * Suffix of the serialized ShaderDescriptor stored next to a compiled shader.
+    */
+    constexpr std::string_view    REFLECTION_EXT    = ".refl";
+
+    enum class EArchiveEntry : std::uint32_t {
+        RAW        = 0, /// File contents as is.
+        IMAGE      = 1, /// ArchiveImage followed by tightly packed pixels or a block compressed mip chain.
+        SPIRV      = 2, /// SPIR-V words.
+        REFLECTION = 3, /// Serialized vk::ShaderDescriptor.
+    };
+
+    struct ArchiveHeader {
+        std::array<char, 8> magic;
+        std::uint32_t       version;
+        std::uint32_t       entry_count;
+        std::uint64_t       index_offset;
+        std::uint64_t       names_offset;
+    };
+
+    struct ArchiveEntry {
+        std::uint64_t hash;
+        std::uint64_t offset;
+        std::uint64_t size;
+        std::uint32_t name_offset; /// Relative to ArchiveHeader::names_offset.
+        std::uint32_t name_size;
+        EArchiveEntry kind;
+        std::uint32_t reserved;
+    };
+
+    /**
+    * Uncompressed images store level 0 only, the engine generates the rest of the chain when asked to.
+    * Block compressed images store levels 0 to levels - 1, every level starting at a multiple of ARCHIVE_ALIGNMENT
+    * relative to the first, and channels is 4.
+    */
+    struct ArchiveImage {
+        std::uint32_t width;
+        std::uint32_t height;
+        std::uint16_t channels;
+        std::uint16_t levels;
+        EBlockFormat  format;
+    };
+
+    static_assert(sizeof(ArchiveHeader) == 32);
+    static_assert(sizeof(ArchiveEntry)  == 40);
+    static_assert(sizeof(ArchiveImage)  == ARCHIVE_ALIGNMENT, "Pixels following an ArchiveImage must stay aligned");
+
+    constexpr std::uint64_t fnv1a_64(std::string_view str) {
+        std::uint64_t hash = 14695981039346656037ull;
+        for (char c : str) {
+            hash ^= static_cast<std::uint8_t>(c);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    constexpr std::uint64_t archive_align(std::uint64_t offset) {
+        return (offset + ARCHIVE_ALIGNMENT - 1) & ~(ARCHIVE_ALIGNMENT - 1);
+    }
+
+    /**
+    * Bytes following an ArchiveImage.
+    */
+    constexpr std::uint64_t archive_image_bytes(const ArchiveImage& image) {
+        if (image.format == EBlockFormat::NONE) {
+            return static_cast<std::uint64_t>(image.width) * image.height * image.channels;
+        }
+        std::uint64_t bytes  = 0;
+        std::uint32_t width  = image.width;
+        std::uint32_t height = image.height;
+        for (std::uint32_t i = 0; i < image.levels; i++) {
+            bytes  = archive_align(bytes) + block_image_bytes(image.format, width, height);
+            width  = std::max(width / 2, 1u);
+            height = std::max(height / 2, 1u);
+        }
+        return bytes;
+    }
+
+}
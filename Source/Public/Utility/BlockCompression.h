@@ -0,0 +1,68 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+/**
+* Self contained BC1/BC3/BC7 block compression on the cpu.
+* Only depends on the standard library so tools/aby_package can bake compressed images without
+* linking the engine, and so it can be tested on machines without a gpu.
+*
+* Images are split into 4x4 texel blocks stored row by row, edge blocks of images whose size is
+* not a multiple of 4 repeat the last row and column. Texels are 8 bit RGBA and are encoded as is,
+* so sRGB images stay sRGB and are sampled through the _SRGB_BLOCK formats.
+*/
+namespace aby::util {
+
+    enum class EBlockFormat : std::uint32_t {
+        NONE = 0, /// Uncompressed texels.
+        BC1  = 1, /// 8 bytes per block, RGB with 1 bit alpha.
+        BC3  = 2, /// 16 bytes per block, BC1 color with 8 bit interpolated alpha.
+        BC7  = 3, /// 16 bytes per block, RGBA. The encoder only writes mode 6 blocks.
+    };
+
+    constexpr std::uint32_t BLOCK_DIM = 4;
+
+    constexpr std::uint32_t block_bytes(EBlockFormat format) {
+        switch (format) {
+            case EBlockFormat::BC1: return 8;
+            case EBlockFormat::BC3: return 16;
+            case EBlockFormat::BC7: return 16;
+            default:                return 0;
+        }
+    }
+
+    /**
+    * Bytes of a compressed image of width x height texels.
+    */
+    constexpr std::uint64_t block_image_bytes(EBlockFormat format, std::uint32_t width, std::uint32_t height) {
+        std::uint64_t blocks_x = (width + BLOCK_DIM - 1) / BLOCK_DIM;
+        std::uint64_t blocks_y = (height + BLOCK_DIM - 1) / BLOCK_DIM;
+        return blocks_x * blocks_y * block_bytes(format);
+    }
+
+    /**
+    * Encode one block.
+    * @param texels 16 RGBA texels, row by row
+    * @param block  block_bytes(format) bytes
+    */
+    void encode_block(EBlockFormat format, const std::uint8_t* texels, std::uint8_t* block);
+    /**
+    * Decode one block.
+    * @return false for BC7 blocks of a mode other than 6.
+    */
+    bool decode_block(EBlockFormat format, const std::uint8_t* block, std::uint8_t* texels);
+
+    /**
+    * Encode an RGBA image.
+    * @param rgba   width * height * 4 bytes
+    * @param blocks block_image_bytes(format, width, height) bytes
+    */
+    void encode_image(EBlockFormat format, std::span<const std::uint8_t> rgba, std::uint32_t width, std::uint32_t height, std::span<std::uint8_t> blocks);
+    /**
+    * Decode an image to RGBA, e.g. on devices without BC support.
+    * @return false if a block could not be decoded.
+    */
+    bool decode_image(EBlockFormat format, std::span<const std::uint8_t> blocks, std::uint32_t width, std::uint32_t height, std::span<std::uint8_t> rgba);
+
+}
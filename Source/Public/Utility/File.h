@@ -1,6 +1,9 @@
+#pragma once
 #include "Core/Common.h"
 #include "Core/Log.h"
 #include <expected>
+#include <initializer_list>
+#include <span>
 
 namespace aby::util {
 
@@ -52,6 +55,11 @@ namespace aby::util {
         std::expected<MappedFile, FileError>  map();
 
         FileError write(const std::string& data, EFileMode mode = EFileMode::NONE);
+        /**
+        * Write the parts one after another to a temporary file next to the path and rename it over the path,
+        * creating the parent directories. Writers may race, readers only ever see a complete file.
+        */
+        FileError write_atomic(std::initializer_list<std::span<const std::byte>> parts);
 
         bool exists() const;
         
@@ -0,0 +1,252 @@
+#pragma once
+#include "Core/Common.h"
+#include <atomic>
+#include <bit>
+
+namespace aby::util {
+
+    /**
+    * Bounded multi-producer multi-consumer queue.
+    * Array based design by Dmitry Vyukov, every cell carries a sequence number
+    * that tells producers and consumers whether the cell is free or published.
+    *
+    * @tparam T Default constructible, move assignable value type.
+    */
+    template <typename T>
+    class MPMCQueue {
+    public:
+        /**
+        * @param capacity Maximum number of queued values, rounded up to a power of two.
+        */
+        explicit MPMCQueue(std::size_t capacity) :
+            m_Mask(std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1),
+            m_Cells(std::make_unique<Cell[]>(m_Mask + 1)),
+            m_Enqueue(0),
+            m_Dequeue(0)
+        {
+            for (std::size_t i = 0; i <= m_Mask; i++) {
+                m_Cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        MPMCQueue(const MPMCQueue&) = delete;
+        MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+        /**
+        * Push a value.
+        * @return False if the queue is full, value is left untouched.
+        */
+        bool try_push(T&& value) {
+            std::size_t pos = m_Enqueue.load(std::memory_order_relaxed);
+            Cell* cell;
+            while (true) {
+                cell = &m_Cells[pos & m_Mask];
+                std::size_t seq  = cell->sequence.load(std::memory_order_acquire);
+                auto        diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+                if (diff == 0) {
+                    if (m_Enqueue.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                }
+                else if (diff < 0) {
+                    return false;
+                }
+                else {
+                    pos = m_Enqueue.load(std::memory_order_relaxed);
+                }
+            }
+            cell->value = std::move(value);
+            cell->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+        * Pop the oldest value.
+        * @return False if the queue is empty (or the oldest value is still being published).
+        */
+        bool try_pop(T& out) {
+            std::size_t pos = m_Dequeue.load(std::memory_order_relaxed);
+            Cell* cell;
+            while (true) {
+                cell = &m_Cells[pos & m_Mask];
+                std::size_t seq  = cell->sequence.load(std::memory_order_acquire);
+                auto        diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+                if (diff == 0) {
+                    if (m_Dequeue.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                }
+                else if (diff < 0) {
+                    return false;
+                }
+                else {
+                    pos = m_Dequeue.load(std::memory_order_relaxed);
+                }
+            }
+            out = std::move(cell->value);
+            cell->value = T{};
+            cell->sequence.store(pos + m_Mask + 1, std::memory_order_release);
+            return true;
+        }
+
+        std::size_t capacity() const {
+            return m_Mask + 1;
+        }
+    private:
+        struct Cell {
+            std::atomic<std::size_t> sequence;
+            T                        value;
+        };
+        const std::size_t                     m_Mask;
+        std::unique_ptr<Cell[]>               m_Cells;
+        alignas(64) std::atomic<std::size_t>  m_Enqueue;
+        alignas(64) std::atomic<std::size_t>  m_Dequeue;
+    };
+
+    /**
+    * Unbounded multi-producer single-consumer list.
+    * Producers push with a single CAS, the consumer takes the whole list at once
+    * and visits it in push order.
+    */
+    template <typename T>
+    class MPSCStack {
+    public:
+        MPSCStack() : m_Head(nullptr) {}
+        MPSCStack(const MPSCStack&) = delete;
+        MPSCStack& operator=(const MPSCStack&) = delete;
+        ~MPSCStack() {
+            drain([](T&&) {});
+        }
+
+        void push(T value) {
+            Node* node = new Node{ std::move(value), m_Head.load(std::memory_order_relaxed) };
+            while (!m_Head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        /**
+        * Take every pushed value, oldest first. Consumer thread only.
+        * @return Number of values visited.
+        */
+        template <typename Fn>
+        std::size_t drain(Fn&& fn) {
+            Node* node = m_Head.exchange(nullptr, std::memory_order_acquire);
+            Node* prev = nullptr;
+            while (node) {
+                Node* next = node->next;
+                node->next = prev;
+                prev       = node;
+                node       = next;
+            }
+            std::size_t count = 0;
+            while (prev) {
+                Node* next = prev->next;
+                fn(std::move(prev->value));
+                delete prev;
+                prev = next;
+                count++;
+            }
+            return count;
+        }
+
+        bool empty() const {
+            return m_Head.load(std::memory_order_acquire) == nullptr;
+        }
+    private:
+        struct Node {
+            T     value;
+            Node* next;
+        };
+        std::atomic<Node*> m_Head;
+    };
+
+    /**
+    * Hands the newest value of a stream from one producer thread to one consumer thread over a fixed
+    * set of slots (e.g. staging memory a video decoder writes frames into), without locks or waiting.
+    *
+    * The producer acquires a free slot, fills it and publishes it. Publishing replaces a slot the
+    * consumer has not taken yet, which is then free again (a dropped frame). The consumer takes the
+    * newest published slot and releases it once it is done reading (e.g. once the gpu copied from it).
+    * With as many slots as the consumer holds at once plus two, acquire always finds a free slot.
+    */
+    class SlotExchange {
+    public:
+        static constexpr u32 NONE      = ~0u;
+        static constexpr u32 MAX_SLOTS = 64;
+
+        explicit SlotExchange(u32 slots) :
+            m_Slots(slots),
+            m_Free(slots == MAX_SLOTS ? ~u64(0) : (u64(1) << slots) - 1),
+            m_Latest(NONE),
+            m_Published(0),
+            m_Dropped(0)
+        {
+            ABY_ASSERT(slots >= 2 && slots <= MAX_SLOTS, "SlotExchange needs 2 to {} slots", MAX_SLOTS);
+        }
+
+        SlotExchange(const SlotExchange&) = delete;
+        SlotExchange& operator=(const SlotExchange&) = delete;
+
+        /**
+        * Producer. Take a free slot to write into.
+        * @return NONE if every slot is held.
+        */
+        u32 acquire() {
+            u64 free = m_Free.load(std::memory_order_acquire);
+            while (free) {
+                if (m_Free.compare_exchange_weak(free, free & (free - 1), std::memory_order_acquire, std::memory_order_acquire)) {
+                    return static_cast<u32>(std::countr_zero(free));
+                }
+            }
+            return NONE;
+        }
+
+        /**
+        * Producer. Make a written slot the newest one, freeing the previous one if it was never taken.
+        */
+        void publish(u32 slot) {
+            m_Published.fetch_add(1, std::memory_order_relaxed);
+            u32 replaced = m_Latest.exchange(slot, std::memory_order_acq_rel);
+            if (replaced != NONE) {
+                m_Dropped.fetch_add(1, std::memory_order_relaxed);
+                m_Free.fetch_or(u64(1) << replaced, std::memory_order_release);
+            }
+        }
+
+        /**
+        * Consumer. Take the newest published slot.
+        * @return NONE if nothing was published since the last take.
+        */
+        u32 take() {
+            return m_Latest.exchange(NONE, std::memory_order_acq_rel);
+        }
+
+        /**
+        * Consumer. Hand a taken slot back to the producer.
+        */
+        void release(u32 slot) {
+            m_Free.fetch_or(u64(1) << slot, std::memory_order_release);
+        }
+
+        u32 slots() const {
+            return m_Slots;
+        }
+
+        u64 published() const {
+            return m_Published.load(std::memory_order_relaxed);
+        }
+
+        /**
+        * Published slots replaced before the consumer took them.
+        */
+        u64 dropped() const {
+            return m_Dropped.load(std::memory_order_relaxed);
+        }
+    private:
+        const u32                    m_Slots;
+        alignas(64) std::atomic<u64> m_Free;   /// Bit per slot neither held by the producer, published nor taken.
+        alignas(64) std::atomic<u32> m_Latest; /// Newest published slot, NONE once taken.
+        std::atomic<u64>             m_Published;
+        std::atomic<u64>             m_Dropped;
+    };
+
+}
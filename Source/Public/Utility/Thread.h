@@ -2,9 +2,13 @@
 
 #include "Core/Resource.h"
 #include "Core/Log.h"
+#include "Utility/LockFree.h"
 #include <mutex>
 #include <thread>
-#include <condition_variable>
+#include <semaphore>
+#include <functional>
+#include <chrono>
+#include <vector>
 
 namespace aby::util {
 
@@ -26,37 +30,143 @@ namespace aby::util {
         std::thread m_Thread;
     };
 
-    class LoadThread final : public Thread {
+    /**
+    * Where a load graph node runs.
+    */
+    enum class ELoadAffinity {
+        WORKER = 0, /// Any loading thread, cpu only work.
+        MAIN   = 1, /// Main thread, backend work (uploads, descriptor writes, ResourceClass mutation).
+    };
+
+    /**
+    * A node of the load graph. Created through LoadPool::add_node.
+    */
+    class LoadNode {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        const std::string& name() const;
+        ELoadAffinity      affinity() const;
+        bool               done() const;
+        /**
+        * Time spent running the node in milliseconds, valid once done.
+        */
+        float              duration() const;
+    private:
+        LoadNode(std::string name, ELoadAffinity affinity, std::function<void()> fn);
     private:
-        enum class EFinishState {
-            FINISH           = 0,
-            LOAD_THEN_FINISH = 1,
-            CONTINUE         = 2,
-        };
+        friend class LoadPool;
+        std::string                  m_Name;
+        ELoadAffinity                m_Affinity;
+        std::function<void()>        m_Fn;
+        std::atomic<u32>             m_Remaining;
+        mutable std::mutex           m_Mutex;
+        bool                         m_Done;
+        std::vector<Ref<LoadNode>>   m_Dependents;   /// Guarded by m_Mutex, released on completion.
+        std::vector<Ref<LoadNode>>   m_Dependencies;
+        Clock::time_point            m_Start;
+        Clock::time_point            m_End;
+    };
+
+    /**
+    * One step of the critical path reported by LoadPool::sync.
+    */
+    struct LoadStep {
+        std::string   name;
+        ELoadAffinity affinity;
+        float         start;    /// Milliseconds since the first step started.
+        float         duration; /// Milliseconds spent running the step.
+    };
+
+    /**
+    * Pool of loading threads sized to the core count.
+    * 
+    * Loads are expressed as a small graph of nodes with explicit dependencies.
+    * Worker nodes do the cpu heavy part (image decoding, glyph rasterization) on any
+    * loading thread, main nodes do the backend side (gpu uploads, descriptor writes,
+    * swapping the loaded resource into its reserved handle) when the main thread polls.
+    * A node is scheduled as soon as its last dependency completes, so independent
+    * loads overlap freely.
+    * 
+    * add_node/add_task/add_work may be called from any thread, sync and poll only from the main thread.
+    */
+    class LoadPool {
     public:
-        using QueryResourceNextHandle = std::function<Resource::Handle(EResource)>;
         using Task = std::function<void()>;
+        using Work = std::function<Task()>;
+        using Node = Ref<LoadNode>;
 
-        explicit LoadThread(QueryResourceNextHandle query_next_handle);
-        ~LoadThread();
+        /**
+        * @param threads Number of loading threads, zero picks the core count minus the main thread.
+        */
+        explicit LoadPool(std::size_t threads = 0);
+        ~LoadPool();
 
-        Resource add_task(EResource type, Task&& task);
+        /**
+        * Add a node to the load graph.
+        * 
+        * @param name     Label used by the critical path report.
+        * @param affinity Thread the node runs on.
+        * @param fn       Node body.
+        * @param deps     Nodes that must complete first, null entries are ignored.
+        * @return The node, to be used as a dependency of later nodes.
+        */
+        Node add_node(std::string name, ELoadAffinity affinity, Task&& fn, const std::vector<Node>& deps = {});
+        /**
+        * Queue a task that only has a main thread finalize stage.
+        */
+        void add_task(Task&& finalize);
+        /**
+        * Queue work for the loading threads. The returned task is the finalize stage.
+        */
+        void add_work(Work&& work);
+        /**
+        * Run fn(i) for every i in [0, count) on the loading threads and the calling thread,
+        * returns once every call has finished. Safe to call from a loading thread, the caller
+        * keeps taking indices itself so it never waits on work nobody picked up.
+        */
+        void parallel_for(std::size_t count, const std::function<void(std::size_t)>& fn);
+        /**
+        * Number of tasks and nodes that have not completed yet.
+        */
         std::size_t tasks() const;
+        std::size_t threads() const;
+        /**
+        * Block until every queued task and node (including ones they queue) has completed,
+        * then log the critical path of the nodes that ran since the last sync.
+        * The calling thread helps run queued work while it waits.
+        */
         void sync();
+        /**
+        * Run main thread tasks and nodes that are ready without blocking.
+        * @return Number of tasks and nodes completed.
+        */
+        std::size_t poll();
+        /**
+        * Longest dependency chain of the nodes completed before the last sync.
+        * Each step is the dependency that finished last before the next one could start.
+        */
+        const std::vector<LoadStep>& critical_path() const;
     private:
-        void load();
-    public:
-        QueryResourceNextHandle        m_QueryNextHandle;
-        std::multimap<EResource, Task> m_Tasks;
-        // Recursive mutex is necessary due
-        // to fonts and how they are loaded.
-        // The font needs to be loaded, then 
-        // a texture associated with a font needs
-        // to be loaded within the same scope as the font
-        // creation.
-        std::recursive_mutex           m_Mutex;
-        std::atomic<EFinishState>      m_FinishState;
-        std::condition_variable m_CondVar;
-        std::mutex m_CondMutex;
+        void worker();
+        void run(Work& work);
+        void enqueue(Work&& work);
+        void finish(Task&& finalize);
+        void schedule(const Node& node);
+        void execute(const Node& node);
+        void complete(const Node& node);
+        void report_critical_path();
+    private:
+        MPMCQueue<Work>             m_Jobs;
+        MPSCStack<Task>             m_Finished;
+        std::counting_semaphore<>   m_Signal;
+        std::atomic<bool>           m_Running;
+        std::atomic<u64>            m_Submitted;
+        std::atomic<u64>            m_Completed;
+        u64                         m_Finalized;
+        std::vector<Unique<Thread>> m_Threads;
+        std::mutex                  m_LatestMutex;
+        Node                        m_Latest;
+        std::vector<LoadStep>       m_CriticalPath;
     };
 }
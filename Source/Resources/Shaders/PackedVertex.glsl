@@ -0,0 +1,22 @@
+#version 450 core
+
+// Narrow formats are selected by the input name suffix, see ShaderCompiler::reflect.
+layout(location = 0) in vec3  a_position;
+layout(location = 1) in vec4  a_color_unorm8;
+layout(location = 2) in vec2  a_texcoord_unorm16;
+layout(location = 3) in uint  a_texture_u16;
+
+layout(std140, binding = 0) uniform Camera {
+    mat4 view_proj;
+};
+
+layout(location = 0) out vec4 v_color;
+layout(location = 1) out vec3 v_texinfo;
+layout(location = 2) out vec2 v_uvs;
+
+void main() {
+    gl_Position = view_proj * vec4(a_position, 1.0);
+    v_color     = a_color_unorm8;
+    v_texinfo   = vec3(a_texcoord_unorm16, float(a_texture_u16));
+    v_uvs       = vec2(1.0); // Already applied to the texcoord.
+}
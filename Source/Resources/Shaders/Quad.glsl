@@ -0,0 +1,30 @@
+#version 450 core
+
+// One instance per quad, see aby::QuadInstance.
+layout(location = 0) in vec3  a_position; // center
+layout(location = 1) in vec2  a_size;
+layout(location = 2) in uint  a_color;    // RGBA8 unorm
+layout(location = 3) in uint  a_texture;
+layout(location = 4) in vec4  a_uvs;      // xy = texcoord, zw = extent
+
+layout(std140, binding = 0) uniform Camera {
+    mat4 view_proj;
+};
+
+layout(location = 0) out vec4 v_color;
+layout(location = 1) out vec3 v_texinfo;
+layout(location = 2) out vec2 v_uvs;
+
+// Two triangles in the order of the indexed quads (0, 1, 2, 2, 3, 0).
+const vec2 CORNERS[6] = vec2[](
+    vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(1.0, 1.0),
+    vec2(1.0, 1.0), vec2(0.0, 1.0), vec2(0.0, 0.0)
+);
+
+void main() {
+    vec2 corner = CORNERS[gl_VertexIndex];
+    gl_Position = view_proj * vec4(a_position + vec3((corner - 0.5) * a_size, 0.0), 1.0);
+    v_color     = unpackUnorm4x8(a_color);
+    v_texinfo   = vec3(a_uvs.xy + corner * a_uvs.zw, float(a_texture));
+    v_uvs       = vec2(1.0);
+}
@@ -1,3 +1,54 @@
+#include "stb_target.h"
+#include <cstdlib>
+#include <cstring>
+
+namespace stb {
+
+    struct DecodeTarget {
+        void*       ptr     = nullptr;
+        std::size_t size    = 0;
+        bool        claimed = false;
+    };
+    static thread_local DecodeTarget t_Target;
+
+    void set_decode_target(void* target, std::size_t size) {
+        t_Target = { target, size, false };
+    }
+
+    void clear_decode_target() {
+        t_Target = {};
+    }
+
+    static void* target_malloc(std::size_t size) {
+        if (t_Target.ptr && !t_Target.claimed && size == t_Target.size) {
+            t_Target.claimed = true;
+            return t_Target.ptr;
+        }
+        return std::malloc(size);
+    }
+
+    static void* target_realloc(void* ptr, std::size_t size) {
+        if (ptr && ptr == t_Target.ptr && t_Target.claimed) {
+            // The target can't grow, move the data to the heap and treat the target as freed.
+            void* moved = std::malloc(size);
+            if (moved) std::memcpy(moved, ptr, size < t_Target.size ? size : t_Target.size);
+            t_Target.ptr = nullptr;
+            return moved;
+        }
+        return std::realloc(ptr, size);
+    }
+
+    static void target_free(void* ptr) {
+        if (ptr && ptr == t_Target.ptr && t_Target.claimed) return;
+        std::free(ptr);
+    }
+
+}
+
+#define STBI_MALLOC(sz)        stb::target_malloc(sz)
+#define STBI_REALLOC(p, newsz) stb::target_realloc(p, newsz)
+#define STBI_FREE(p)           stb::target_free(p)
+
 #define STB_IMAGE_RESIZE_IMPLEMENTATION
 #include "stb_image/stb_image_resize2.h"
 #define STB_IMAGE_WRITE_IMPLEMENTATION
@@ -5,4 +56,4 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image/stb_image.h"
 // #define STB_TRUETYPE_IMPLEMENTATION
-// #include "stb_truetype/stb_truetype.h"
\ No newline at end of file
+// #include "stb_truetype/stb_truetype.h"
@@ -0,0 +1,18 @@
+#pragma once
+#include <cstddef>
+
+/**
+* Lets stb_image decode straight into caller owned memory, such as mapped staging memory.
+* While a target is set on the calling thread, the first stb_image allocation of exactly
+* target size bytes returns the target instead of heap memory. stbi_image_free and
+* reallocation never release the target, so the caller keeps ownership either way.
+*
+* If stbi_load returns the target pointer the pixels were written in place and the result
+* must not be freed, any other result has to be copied into the target and freed as usual.
+*/
+namespace stb {
+
+    void set_decode_target(void* target, std::size_t size);
+    void clear_decode_target();
+
+}
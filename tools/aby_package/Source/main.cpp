@@ -1,5 +1,16 @@
 #include <CmdLine/CmdLine.h>
+#include <Utility/ArchiveFormat.h>
+#include <stb_image/stb_image.h>
+#include <stb_image/stb_image_resize2.h>
+#include <algorithm>
+#include <bit>
+#include <cstring>
 #include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <span>
+#include <vector>
 
 #ifndef EXECUTABLE_FOLDER
 #define EXECUTABLE_FOLDER "CMAKE_ERROR at tools/package/CMakeLists.txt"
@@ -30,6 +41,230 @@ namespace aby {
             entry.path().extension() == ".pdb" ||
             entry.path().filename().replace_extension("") == "aby_package";
     }
+
+    /**
+    * Block compression of packed images (see Utility/BlockCompression.h).
+    */
+    enum class ECompression {
+        OFF,
+        BC1,
+        BC3,
+        BC7,
+        AUTO, /// BC1 for opaque images, BC7 for images with alpha.
+    };
+
+    std::optional<ECompression> parse_compression(const std::string& str) {
+        if (str == "off")  return ECompression::OFF;
+        if (str == "bc1")  return ECompression::BC1;
+        if (str == "bc3")  return ECompression::BC3;
+        if (str == "bc7")  return ECompression::BC7;
+        if (str == "auto") return ECompression::AUTO;
+        return std::nullopt;
+    }
+
+    /**
+    * Builds an asset archive (see Utility/ArchiveFormat.h) from files of the build directory.
+    */
+    class ArchiveWriter {
+    public:
+        /**
+        * Images with fewer texels stay uncompressed, small icons lose too much detail to 4x4 blocks
+        * and usually end up in a texture atlas which is uncompressed anyway.
+        */
+        static constexpr std::uint64_t MIN_COMPRESSED_TEXELS = 128 * 128;
+
+        explicit ArchiveWriter(ECompression compression) : m_Compression(compression) {}
+
+        /**
+        * @return false if the file is not an archived asset and should be copied as is.
+        */
+        bool add(const std::filesystem::path& file, const std::filesystem::path& relative) {
+            auto name = relative.generic_string();
+            auto ext  = file.extension();
+            if (ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".bmp" || ext == ".tga") {
+                return add_image(file, name);
+            }
+            // Shaders compiled and reflected by a previous run of the engine.
+            if (name.starts_with("Cache/Shaders/")) {
+                auto kind = ext.string() == util::REFLECTION_EXT ? util::EArchiveEntry::REFLECTION : util::EArchiveEntry::SPIRV;
+                return add_file(file, name, kind);
+            }
+            return false;
+        }
+
+        bool write(const std::filesystem::path& path) {
+            std::sort(m_Entries.begin(), m_Entries.end(), [](const Pending& a, const Pending& b) {
+                return a.entry.hash < b.entry.hash;
+            });
+
+            util::ArchiveHeader header{
+                .magic        = util::ARCHIVE_MAGIC,
+                .version      = util::ARCHIVE_VERSION,
+                .entry_count  = static_cast<std::uint32_t>(m_Entries.size()),
+                .index_offset = 0,
+                .names_offset = 0,
+            };
+            std::vector<char>         blobs(sizeof(header));
+            std::string               names;
+            std::vector<util::ArchiveEntry> index;
+            index.reserve(m_Entries.size());
+            for (auto& pending : m_Entries) {
+                auto& entry       = pending.entry;
+                entry.offset      = util::archive_align(blobs.size());
+                entry.size        = pending.data.size();
+                entry.name_offset = static_cast<std::uint32_t>(names.size());
+                entry.name_size   = static_cast<std::uint32_t>(pending.name.size());
+                names += pending.name;
+                blobs.resize(entry.offset);
+                blobs.insert(blobs.end(), pending.data.begin(), pending.data.end());
+                index.push_back(entry);
+            }
+            header.index_offset = util::archive_align(blobs.size());
+            header.names_offset = header.index_offset + index.size() * sizeof(util::ArchiveEntry);
+            blobs.resize(header.index_offset);
+            std::memcpy(blobs.data(), &header, sizeof(header));
+
+            std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+            ofs.write(blobs.data(), blobs.size());
+            ofs.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(util::ArchiveEntry));
+            ofs.write(names.data(), names.size());
+            if (!ofs) {
+                std::cerr << "Failed to write archive: " << path << "\n";
+                return false;
+            }
+            std::cout << "Packed " << m_Entries.size() << " assets into " << path << " (" << header.names_offset + names.size() << " bytes, " << m_Compressed << " block compressed images)\n";
+            return true;
+        }
+    private:
+        struct Pending {
+            std::string        name;
+            util::ArchiveEntry entry;
+            std::vector<char>  data;
+        };
+
+        bool add_image(const std::filesystem::path& file, const std::string& name) {
+            int w, h, c;
+            unsigned char* pixels = stbi_load(file.string().c_str(), &w, &h, &c, 0);
+            if (!pixels) {
+                std::cerr << "Failed to decode image, copying it instead: " << file << " (" << stbi_failure_reason() << ")\n";
+                return false;
+            }
+            if (m_Compression != ECompression::OFF && static_cast<std::uint64_t>(w) * h >= MIN_COMPRESSED_TEXELS) {
+                add_compressed_image(name, pixels, static_cast<std::uint32_t>(w), static_cast<std::uint32_t>(h), static_cast<std::uint32_t>(c));
+                stbi_image_free(pixels);
+                return true;
+            }
+            util::ArchiveImage image{
+                .width    = static_cast<std::uint32_t>(w),
+                .height   = static_cast<std::uint32_t>(h),
+                .channels = static_cast<std::uint16_t>(c),
+                .levels   = 1,
+                .format   = util::EBlockFormat::NONE,
+            };
+            std::size_t bytes = static_cast<std::size_t>(w) * h * c;
+            std::vector<char> data(sizeof(image) + bytes);
+            std::memcpy(data.data(), &image, sizeof(image));
+            std::memcpy(data.data() + sizeof(image), pixels, bytes);
+            stbi_image_free(pixels);
+            push(name, util::EArchiveEntry::IMAGE, std::move(data));
+            return true;
+        }
+
+        /**
+        * Bake the full mip chain of an image and block compress every level, so the engine can
+        * upload it without decoding or filtering anything.
+        */
+        void add_compressed_image(const std::string& name, const unsigned char* pixels, std::uint32_t w, std::uint32_t h, std::uint32_t c) {
+            std::vector<std::uint8_t> rgba(static_cast<std::size_t>(w) * h * 4);
+            bool opaque = true;
+            for (std::size_t i = 0, n = static_cast<std::size_t>(w) * h; i < n; i++) {
+                const unsigned char* in  = pixels + i * c;
+                std::uint8_t*        out = rgba.data() + i * 4;
+                switch (c) {
+                    case 1: out[0] = out[1] = out[2] = in[0]; out[3] = 0xFF;  break;
+                    case 2: out[0] = out[1] = out[2] = in[0]; out[3] = in[1]; break;
+                    case 3: std::memcpy(out, in, 3);          out[3] = 0xFF;  break;
+                    case 4: std::memcpy(out, in, 4);                          break;
+                }
+                opaque &= out[3] == 0xFF;
+            }
+
+            util::EBlockFormat format = util::EBlockFormat::BC7;
+            switch (m_Compression) {
+                case ECompression::BC1:  format = util::EBlockFormat::BC1; break;
+                case ECompression::BC3:  format = util::EBlockFormat::BC3; break;
+                case ECompression::BC7:  format = util::EBlockFormat::BC7; break;
+                case ECompression::AUTO: format = opaque ? util::EBlockFormat::BC1 : util::EBlockFormat::BC7; break;
+                default: break;
+            }
+
+            util::ArchiveImage image{
+                .width    = w,
+                .height   = h,
+                .channels = 4,
+                .levels   = static_cast<std::uint16_t>(std::bit_width(std::max(w, h))),
+                .format   = format,
+            };
+            std::vector<char> data(sizeof(image) + util::archive_image_bytes(image));
+            std::memcpy(data.data(), &image, sizeof(image));
+
+            std::vector<std::uint8_t> next;
+            std::uint64_t             offset = 0;
+            for (std::uint32_t i = 0; i < image.levels; i++) {
+                offset           = util::archive_align(offset);
+                std::size_t size = util::block_image_bytes(format, w, h);
+                auto*       out  = reinterpret_cast<std::uint8_t*>(data.data() + sizeof(image) + offset);
+                util::encode_image(format, rgba, w, h, std::span<std::uint8_t>(out, size));
+                offset += size;
+                if (i + 1 == image.levels) break;
+
+                // Same 2x2 box filter in linear space as the engine's MipChain.
+                std::uint32_t nw = std::max(w / 2, 1u);
+                std::uint32_t nh = std::max(h / 2, 1u);
+                next.resize(static_cast<std::size_t>(nw) * nh * 4);
+                stbir_resize(
+                    rgba.data(), static_cast<int>(w), static_cast<int>(h), 0,
+                    next.data(), static_cast<int>(nw), static_cast<int>(nh), 0,
+                    STBIR_RGBA, STBIR_TYPE_UINT8_SRGB, STBIR_EDGE_CLAMP, STBIR_FILTER_BOX
+                );
+                rgba.swap(next);
+                w = nw;
+                h = nh;
+            }
+            m_Compressed++;
+            push(name, util::EArchiveEntry::IMAGE, std::move(data));
+        }
+
+        bool add_file(const std::filesystem::path& file, const std::string& name, util::EArchiveEntry kind) {
+            std::ifstream ifs(file, std::ios::binary | std::ios::ate);
+            if (!ifs.is_open()) return false;
+            std::vector<char> data(static_cast<std::size_t>(ifs.tellg()));
+            ifs.seekg(0);
+            ifs.read(data.data(), data.size());
+            push(name, kind, std::move(data));
+            return true;
+        }
+
+        void push(const std::string& name, util::EArchiveEntry kind, std::vector<char>&& data) {
+            m_Entries.push_back(Pending{
+                .name  = name,
+                .entry = util::ArchiveEntry{
+                    .hash        = util::fnv1a_64(name),
+                    .offset      = 0,
+                    .size        = 0,
+                    .name_offset = 0,
+                    .name_size   = 0,
+                    .kind        = kind,
+                    .reserved    = 0,
+                },
+                .data  = std::move(data),
+            });
+        }
+    private:
+        ECompression         m_Compression;
+        std::size_t          m_Compressed = 0;
+        std::vector<Pending> m_Entries;
+    };
 }
 
 int main(int argc, char** argv) {
@@ -45,14 +280,24 @@ int main(int argc, char** argv) {
 
     std::string output_dir = "./bin";
     std::string build_mode = EXECUTABLE_FOLDER;
+    std::string pack       = "on";
+    std::string compress   = "off";
 
     if (!cmd.opt("o", "Output directory (default: " + output_dir + ")",  &output_dir, false)
         .opt("b", "build mode (default: " + std::string(EXECUTABLE_FOLDER) + ")", &build_mode, false)
+        .opt("p", "Pack images and shaders into " + std::string(aby::util::ARCHIVE_NAME) + ", on|off (default: " + pack + ")", &pack, false)
+        .opt("c", "Block compress packed images, off|bc1|bc3|bc7|auto (default: " + compress + ")", &compress, false)
         .parse(argc, argv, opts))
     {
         return 1;
     }
 
+    auto compression = aby::parse_compression(compress);
+    if (!compression) {
+        std::cerr << "Unknown compression: " << compress << " (expected off|bc1|bc3|bc7|auto)\n";
+        return 1;
+    }
+
     if (!std::filesystem::exists(output_dir)) {
         std::filesystem::create_directory(output_dir);
     } else {
@@ -67,11 +312,13 @@ int main(int argc, char** argv) {
     std::filesystem::create_directories(std::filesystem::path(output_dir) / "Lib");
 #endif
 
+    aby::ArchiveWriter archive(*compression);
     for (const auto& entry : dir_iter) {
         if (aby::skip_file_or_dir(entry)) continue;
 
         auto relative_path = std::filesystem::relative(entry.path(), source_dir);
         auto target_path = std::filesystem::path(output_dir) / relative_path;
+        if (pack == "on" && entry.is_regular_file() && archive.add(entry.path(), relative_path)) continue;
 
         try {
             if (entry.is_directory()) {
@@ -85,5 +332,8 @@ int main(int argc, char** argv) {
         }
     }
 
+    if (pack == "on" && !archive.write(std::filesystem::path(output_dir) / aby::util::ARCHIVE_NAME)) {
+        return 1;
+    }
     return 0;
 }
\ No newline at end of file
@@ -1,8 +1,29 @@
 #include "Framework.h"
 #include <Utility/File.h>
 #include <Platform/Platform.h>
+#include <Core/Resource.h>
+#include <Rendering/Texture.h>
+#include <Rendering/TextureAtlas.h>
+#include <Rendering/MipChain.h>
+#include <Rendering/ImageCache.h>
+#include <Rendering/Vertex.h>
+#include <Rendering/RenderQueue.h>
+#include <Utility/BlockCompression.h>
+#include <Utility/Thread.h>
+#include <stb_target.h>
+#include <stb_image/stb_image.h>
+#include <stb_image/stb_image_write.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/packing.hpp>
 #include <filesystem>
 #include <fstream>
+#include <unordered_map>
+#include <queue>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <thread>
 
 TEST(File) {
     fs::path path = "./Temp.Text";
@@ -85,6 +106,927 @@ TEST(MappedFile) {
     return true;
 }
 
+TEST(ResourceSlotMap) {
+    aby::ResourceClass<aby::Texture> textures;
+    auto a = textures.add(nullptr);
+    auto b = textures.add(nullptr);
+    if (a.index() != 0 || b.index() != 1 || a.generation() != 0) {
+        ResourceSlotMap::err("Fresh handles should be sequential with generation 0");
+        return false;
+    }
+
+    textures.erase(a);
+    if (textures.contains(a) || !textures.contains(b) || textures.size() != 1) {
+        ResourceSlotMap::err("Erase did not release the slot");
+        return false;
+    }
+
+    auto c = textures.add(nullptr);
+    if (c.index() != a.index() || c.generation() != a.generation() + 1) {
+        ResourceSlotMap::err("Recycled slot did not bump generation");
+        return false;
+    }
+    if (textures.contains(a)) {
+        ResourceSlotMap::err("Stale handle aliases recycled slot");
+        return false;
+    }
+
+    std::size_t count = 0;
+    for (auto& [handle, tex] : textures) {
+        count += textures.contains({ aby::EResource::TEXTURE, handle });
+    }
+    if (count != 2) {
+        ResourceSlotMap::err("Iteration visited {} live entries, expected 2", count);
+        return false;
+    }
+    return true;
+}
+
+TEST(ResourceSlotMapBenchmark) {
+    // The storage ResourceClass used before the slot map, kept here as the baseline.
+    class LegacyResourceClass {
+    public:
+        aby::Resource::Handle add(aby::Ref<aby::Texture> ptr) {
+            aby::Resource::Handle handle = m_Next;
+            if (!m_Recycled.empty()) {
+                handle = m_Recycled.front();
+                m_Recycled.pop();
+            }
+            else {
+                m_Next++;
+            }
+            m_Resources.emplace(handle, std::move(ptr));
+            return handle;
+        }
+        void erase(aby::Resource::Handle handle) {
+            m_Resources.erase(handle);
+            m_Recycled.push(handle);
+        }
+        aby::Ref<aby::Texture> at(aby::Resource::Handle handle) const {
+            return m_Resources.at(handle);
+        }
+        auto begin() const { return m_Resources.begin(); }
+        auto end() const { return m_Resources.end(); }
+    private:
+        aby::Resource::Handle m_Next = 0;
+        std::unordered_map<aby::Resource::Handle, aby::Ref<aby::Texture>> m_Resources;
+        std::queue<aby::Resource::Handle> m_Recycled;
+    };
+
+    using Clock = std::chrono::steady_clock;
+    auto ms = [](auto begin, auto end) {
+        return std::chrono::duration<double, std::milli>(end - begin).count();
+    };
+
+    constexpr std::size_t count   = 4096;
+    constexpr std::size_t lookups = 1 << 21;
+    constexpr std::size_t churn   = 1 << 18;
+    constexpr std::size_t passes  = 256;
+
+    aby::ResourceClass<aby::Texture> slots;
+    LegacyResourceClass               legacy;
+    std::vector<aby::Resource>        slot_handles;
+    std::vector<aby::Resource::Handle> legacy_handles;
+    for (std::size_t i = 0; i < count; i++) {
+        slot_handles.push_back(slots.add(nullptr));
+        legacy_handles.push_back(legacy.add(nullptr));
+    }
+
+    std::mt19937 rng(1337);
+    std::vector<std::size_t> order(lookups);
+    for (auto& idx : order) idx = rng() % count;
+
+    std::size_t sink = 0;
+
+    auto t0 = Clock::now();
+    for (auto idx : order) sink += slots.at(slot_handles[idx]) == nullptr;
+    auto t1 = Clock::now();
+    for (auto idx : order) sink += legacy.at(legacy_handles[idx]) == nullptr;
+    auto t2 = Clock::now();
+    std::cout << std::format("  lookup x{}:  slot map {:.3f}ms, unordered_map {:.3f}ms\n", lookups, ms(t0, t1), ms(t1, t2));
+
+    t0 = Clock::now();
+    for (std::size_t i = 0; i < churn; i++) {
+        auto& h = slot_handles[order[i]];
+        slots.erase(h);
+        h = slots.add(nullptr);
+    }
+    t1 = Clock::now();
+    for (std::size_t i = 0; i < churn; i++) {
+        auto& h = legacy_handles[order[i]];
+        legacy.erase(h);
+        h = legacy.add(nullptr);
+    }
+    t2 = Clock::now();
+    std::cout << std::format("  churn  x{}:   slot map {:.3f}ms, unordered_map {:.3f}ms\n", churn, ms(t0, t1), ms(t1, t2));
+
+    t0 = Clock::now();
+    for (std::size_t p = 0; p < passes; p++)
+        for (auto& [handle, tex] : slots) sink += handle;
+    t1 = Clock::now();
+    for (std::size_t p = 0; p < passes; p++)
+        for (auto& [handle, tex] : legacy) sink += handle;
+    t2 = Clock::now();
+    std::cout << std::format("  iterate x{}:    slot map {:.3f}ms, unordered_map {:.3f}ms\n", passes, ms(t0, t1), ms(t1, t2));
+
+    if (slots.size() != count || sink == 0) {
+        ResourceSlotMapBenchmark::err("Slot map lost entries during churn");
+        return false;
+    }
+    return true;
+}
+
+// Texture without a backend, stands in for the renderer's textures.
+class NullTexture : public aby::Texture {
+public:
+    NullTexture() = default;
+    NullTexture(const glm::u32vec2& size) : aby::Texture(size) {}
+    void set_dbg_name(const std::string&) override {}
+    void sync() override {}
+    ImTextureID imgui_id() const override { return {}; }
+    aby::ETextureState state() const { return m_State; }
+    std::span<const aby::TextureRegion> regions() const { return m_Dirty; }
+};
+
+TEST(LoadPool) {
+    constexpr std::size_t count = 64;
+    auto busy_work = [](std::size_t seed) {
+        // Stand in for decoding an image.
+        aby::u64 acc = seed;
+        for (std::size_t i = 0; i < 200000; i++) {
+            acc = acc * 6364136223846793005ull + 1442695040888963407ull;
+        }
+        return acc;
+    };
+
+    aby::ResourceClass<aby::Texture> textures;
+    aby::Ref<aby::Texture> placeholder = std::make_shared<NullTexture>();
+    textures.set_placeholder(placeholder);
+
+    std::vector<aby::Resource> handles;
+    aby::util::LoadPool pool;
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < count; i++) {
+        aby::Resource handle = textures.reserve();
+        handles.push_back(handle);
+        pool.add_work([&, handle, i]() -> aby::util::LoadPool::Task {
+            aby::u64 result = busy_work(i);
+            return [&, handle, result]() {
+                textures.replace(handle, result ? nullptr : placeholder);
+            };
+        });
+    }
+    for (auto& handle : handles) {
+        if (textures.at(handle) != placeholder) {
+            LoadPool::err("Reserved handle does not resolve to the placeholder");
+            return false;
+        }
+    }
+    pool.sync();
+    auto pooled = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    aby::u64 sink = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        sink += busy_work(i);
+    }
+    auto serial = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::format("  {} loads: {} threads {:.3f}ms, serial {:.3f}ms ({})\n", count, pool.threads(), pooled, serial, sink & 1);
+
+    if (pool.tasks() != 0) {
+        LoadPool::err("{} tasks left unfinalized", pool.tasks());
+        return false;
+    }
+    for (auto& handle : handles) {
+        if (!textures.ready(handle) || textures.at(handle) != nullptr) {
+            LoadPool::err("Handle {} was not replaced", handle.handle());
+            return false;
+        }
+    }
+
+    // A load finishing after its handle was erased must not touch the recycled slot.
+    auto stale = textures.reserve();
+    textures.erase(stale);
+    auto reused = textures.add(placeholder);
+    if (textures.replace(stale, nullptr) || textures.at(reused) != placeholder) {
+        LoadPool::err("Stale reservation replaced a recycled slot");
+        return false;
+    }
+
+    // Unloading (residency eviction) hands back the resource and rebinds the placeholder.
+    auto loaded = std::make_shared<NullTexture>();
+    textures.replace(handles.front(), loaded);
+    if (textures.unload(handles.front()) != loaded || textures.ready(handles.front()) || textures.at(handles.front()) != placeholder) {
+        LoadPool::err("Unloaded handle does not resolve to the placeholder");
+        return false;
+    }
+    if (textures.unload(handles.front()) != nullptr) {
+        LoadPool::err("Handle was unloaded twice");
+        return false;
+    }
+    return true;
+}
+
+TEST(LoadGraph) {
+    using aby::util::ELoadAffinity;
+    aby::util::LoadPool pool;
+    std::atomic<int> order = 0;
+    int raster = -1, decode = -1, upload = -1, publish = -1;
+
+    // Mirrors Font::create: rasterize -> decode -> upload -> publish.
+    auto n_raster = pool.add_node("raster", ELoadAffinity::WORKER, [&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        raster = order++;
+    });
+    auto n_decode = pool.add_node("decode", ELoadAffinity::WORKER, [&]() { decode = order++; }, { n_raster });
+    auto n_upload = pool.add_node("upload", ELoadAffinity::MAIN, [&]() { upload = order++; }, { n_decode });
+    // Independent nodes overlap with the chain and must not end up on its critical path.
+    for (int i = 0; i < 16; i++) {
+        pool.add_node("other", ELoadAffinity::WORKER, []() {});
+    }
+    pool.add_node("publish", ELoadAffinity::MAIN, [&]() { publish = order++; }, { n_upload, n_raster });
+    pool.sync();
+
+    if (!(raster < decode && decode < upload && upload < publish) || raster < 0) {
+        LoadGraph::err("Nodes ran out of dependency order ({}, {}, {}, {})", raster, decode, upload, publish);
+        return false;
+    }
+    if (pool.tasks() != 0) {
+        LoadGraph::err("{} nodes left incomplete", pool.tasks());
+        return false;
+    }
+    const auto& path = pool.critical_path();
+    const char* expected[] = { "raster", "decode", "upload", "publish" };
+    if (path.size() != std::size(expected)) {
+        LoadGraph::err("Critical path has {} steps, expected {}", path.size(), std::size(expected));
+        return false;
+    }
+    for (std::size_t i = 0; i < path.size(); i++) {
+        if (path[i].name != expected[i]) {
+            LoadGraph::err("Critical path step {} is {}, expected {}", i, path[i].name, expected[i]);
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST(ResourceStats) {
+    aby::ResourceClass<aby::Texture> textures;
+    textures.set_placeholder(std::make_shared<NullTexture>());
+    textures.add(std::make_shared<NullTexture>(glm::u32vec2{ 4, 4 }));
+    textures.add(std::make_shared<NullTexture>(glm::u32vec2{ 2, 2 }));
+    textures.reserve();
+
+    auto& loads = textures.load_stats();
+    loads.record(0.25f, 0.25f); // < 1ms
+    loads.record(1.f, 0.5f);    // < 2ms
+    loads.record(2.f, 1.f);     // < 4ms
+    loads.record(500.f, 0.f);   // Unbounded bucket
+
+    auto stats = textures.stats("Textures");
+    if (stats.count != 3 || stats.pending != 1) {
+        ResourceStats::err("Expected 3 handles with 1 pending, got {} with {}", stats.count, stats.pending);
+        return false;
+    }
+    // 4x4 and 2x2 RGBA, the pending handle is not sized.
+    if (stats.cpu_bytes != 80 || stats.device_bytes != 80) {
+        ResourceStats::err("Unexpected sizes cpu: {} device: {}", stats.cpu_bytes, stats.device_bytes);
+        return false;
+    }
+    const auto& histogram = stats.loads.histogram();
+    if (histogram[0] != 1 || histogram[1] != 1 || histogram[2] != 1 || histogram[aby::LoadStats::BUCKETS - 1] != 1) {
+        ResourceStats::err("Load times landed in the wrong histogram buckets");
+        return false;
+    }
+    if (stats.loads.count() != 4 || stats.loads.max_ms() != 500.f || stats.loads.decode_ms() != 503.25f) {
+        ResourceStats::err("Unexpected load totals");
+        return false;
+    }
+
+    std::vector<aby::ResourceStats> all = { stats };
+    auto json = aby::to_json(all);
+    if (json.find("\"name\": \"Textures\"") == std::string::npos || json.find("\"histogram\": [1, 1, 1, 0, 0, 0, 0, 1]") == std::string::npos) {
+        ResourceStats::err("Unexpected json: {}", json);
+        return false;
+    }
+    return true;
+}
+
+TEST(ImageDecodeTarget) {
+    constexpr int W = 64, H = 32, C = 4;
+    std::vector<unsigned char> pixels(W * H * C);
+    for (std::size_t i = 0; i < pixels.size(); i++) {
+        pixels[i] = static_cast<unsigned char>(i * 31 + i / W);
+    }
+    std::vector<unsigned char> png;
+    stbi_write_png_to_func([](void* ctx, void* data, int size) {
+        auto bytes = static_cast<unsigned char*>(data);
+        static_cast<std::vector<unsigned char>*>(ctx)->insert(static_cast<std::vector<unsigned char>*>(ctx)->end(), bytes, bytes + size);
+    }, &png, W, H, C, pixels.data(), W * C);
+
+    // Stand-in for mapped staging memory.
+    std::vector<unsigned char> target(pixels.size());
+    int w, h, c;
+    stb::set_decode_target(target.data(), target.size());
+    unsigned char* decoded = stbi_load_from_memory(png.data(), static_cast<int>(png.size()), &w, &h, &c, 0);
+    stb::clear_decode_target();
+    if (decoded != target.data()) {
+        ImageDecodeTarget::err("Png was not decoded into the target");
+        if (decoded) stbi_image_free(decoded);
+        return false;
+    }
+    if (w != W || h != H || c != C || target != pixels) {
+        ImageDecodeTarget::err("Decoded pixels do not match");
+        return false;
+    }
+    return true;
+}
+
+TEST(ImageCache) {
+    using Clock = std::chrono::steady_clock;
+    constexpr int W = 1024, H = 1024, C = 4;
+    std::vector<unsigned char> pixels(W * H * C);
+    for (std::size_t i = 0; i < pixels.size(); i++) {
+        pixels[i] = static_cast<unsigned char>((i / C) % W + (i % C) * 40 + (i / (W * C)) / 3);
+    }
+    std::string png;
+    stbi_write_png_to_func([](void* ctx, void* data, int size) {
+        static_cast<std::string*>(ctx)->append(static_cast<const char*>(data), size);
+    }, &png, W, H, C, pixels.data(), W * C);
+
+    aby::ImageCache cache("./TempImageCache");
+    aby::u64 key = aby::ImageCache::key(png);
+    auto t0 = Clock::now();
+    int w, h, c;
+    unsigned char* decoded = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(png.data()), static_cast<int>(png.size()), &w, &h, &c, 0);
+    auto t1 = Clock::now();
+    bool stored = decoded && cache.store(key, { static_cast<aby::u32>(w), static_cast<aby::u32>(h) }, static_cast<aby::u32>(c), { reinterpret_cast<const std::byte*>(decoded), pixels.size() });
+    if (decoded) stbi_image_free(decoded);
+
+    auto t2    = Clock::now();
+    auto entry = cache.find(key);
+    auto t3    = Clock::now();
+    bool equal = entry && entry->size == glm::u32vec2(W, H) && entry->channels == C &&
+                 std::memcmp(entry->pixels.data(), pixels.data(), pixels.size()) == 0;
+    std::cout << std::format("  {}x{} png: decode {:.2f}ms, cached {:.2f}ms\n", W, H,
+        std::chrono::duration<double, std::milli>(t1 - t0).count(), std::chrono::duration<double, std::milli>(t3 - t2).count());
+    entry.reset();
+
+    png.back() ^= 1;
+    bool rekeyed = aby::ImageCache::key(png) != key && !cache.find(aby::ImageCache::key(png));
+    std::error_code ec;
+    fs::remove_all(cache.dir(), ec);
+    if (!stored || !equal) {
+        ImageCache::err("Cached pixels do not match the decoded image");
+        return false;
+    }
+    if (!rekeyed) {
+        ImageCache::err("Edited file hit the cache entry of the original");
+        return false;
+    }
+    return true;
+}
+
+TEST(TextureRegions) {
+    NullTexture tex(glm::u32vec2{ 8, 8 });
+    std::vector<std::byte> red(5 * 5 * 4);
+    for (std::size_t i = 0; i < red.size(); i += 4) {
+        red[i]     = std::byte{ 0xFF };
+        red[i + 3] = std::byte{ 0xFF };
+    }
+
+    tex.write_region({ 0, 0 }, { 2, 2 }, red.data());
+    tex.write_region({ 1, 1 }, { 2, 2 }, red.data());
+    tex.write_region({ 6, 6 }, { 1, 1 }, red.data());
+    auto regions = tex.regions();
+    if (tex.state() != aby::ETextureState::REGION || regions.size() != 2) {
+        TextureRegions::err("Expected 2 dirty regions, got {}", regions.size());
+        return false;
+    }
+    if (regions[0].offset != glm::u32vec2{ 0, 0 } || regions[0].extent != glm::u32vec2{ 3, 3 } || regions[1].offset != glm::u32vec2{ 6, 6 }) {
+        TextureRegions::err("Overlapping regions were not merged");
+        return false;
+    }
+    auto texel = tex.data().subspan((2 * 8 + 2) * 4, 4);
+    if (texel[0] != std::byte{ 0xFF } || texel[1] != std::byte{ 0 } || tex.data()[(3 * 8 + 3) * 4 + 1] != std::byte{ 0xFF }) {
+        TextureRegions::err("Region pixels were not written to the cpu side data");
+        return false;
+    }
+
+    // Bridges both regions, everything collapses into one.
+    tex.write_region({ 2, 2 }, { 5, 5 }, red.data());
+    regions = tex.regions();
+    if (regions.size() != 1 || regions[0].offset != glm::u32vec2{ 0, 0 } || regions[0].extent != glm::u32vec2{ 7, 7 }) {
+        TextureRegions::err("Expected a single 7x7 region");
+        return false;
+    }
+
+    std::vector<std::byte> full(tex.data().begin(), tex.data().end());
+    tex.write(tex.size(), full);
+    if (tex.state() != aby::ETextureState::UPLOAD || !tex.regions().empty()) {
+        TextureRegions::err("A full write should replace the dirty regions");
+        return false;
+    }
+
+    // Two writes before a sync: the second one has the new size, the image still has the old one.
+    NullTexture resized(glm::u32vec2{ 8, 8 });
+    std::vector<std::byte> larger(16 * 16 * 4);
+    resized.write({ 16, 16 }, larger);
+    resized.write({ 16, 16 }, larger.data());
+    if (resized.state() != aby::ETextureState::RECREATE) {
+        TextureRegions::err("A write after a pending resize should keep the recreate");
+        return false;
+    }
+    return true;
+}
+
+TEST(SkylinePacker) {
+    aby::SkylinePacker packer({ 256, 256 });
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<aby::u32> dim(4, 40);
+
+    struct Rect { glm::u32vec2 pos, size; };
+    std::vector<Rect> placed;
+    bool              valid = true;
+    auto overlaps = [](const Rect& a, const Rect& b) {
+        return a.pos.x < b.pos.x + b.size.x && b.pos.x < a.pos.x + a.size.x &&
+               a.pos.y < b.pos.y + b.size.y && b.pos.y < a.pos.y + a.size.y;
+    };
+    auto insert = [&](aby::SkylinePacker& p) {
+        glm::u32vec2 size{ dim(rng), dim(rng) };
+        auto pos = p.insert(size);
+        if (!pos) return false;
+        Rect rect{ *pos, size };
+        for (auto& other : placed) {
+            if (overlaps(rect, other)) {
+                SkylinePacker::err("Rect at ({}, {}) overlaps rect at ({}, {})", pos->x, pos->y, other.pos.x, other.pos.y);
+                return valid = false;
+            }
+        }
+        if (pos->x + size.x > p.size().x || pos->y + size.y > p.size().y) {
+            SkylinePacker::err("Rect at ({}, {}) is out of bounds", pos->x, pos->y);
+            return valid = false;
+        }
+        placed.push_back(rect);
+        return true;
+    };
+
+    while (insert(packer));
+    if (!valid) return false;
+    if (placed.size() < 40) {
+        SkylinePacker::err("Only {} rects fit in the page", placed.size());
+        return false;
+    }
+    auto occupancy = static_cast<double>(packer.used()) / (256.0 * 256.0);
+    std::cout << std::format("  {} rects, {:.1f}% occupancy\n", placed.size(), occupancy * 100.0);
+
+    // Growing keeps every placed rect valid and makes room for more.
+    std::size_t count = placed.size();
+    packer.grow({ 512, 256 });
+    for (int i = 0; i < 20; i++) {
+        if (!insert(packer)) {
+            SkylinePacker::err("Insert failed after growing");
+            return false;
+        }
+    }
+    return valid && placed.size() == count + 20;
+}
+
+TEST(MipChainBenchmark) {
+    using Clock = std::chrono::steady_clock;
+    auto ms = [](auto begin, auto end) {
+        return std::chrono::duration<double, std::milli>(end - begin).count();
+    };
+
+    // A flat image must stay flat on every level, whatever the split.
+    {
+        aby::MipChain chain({ 300, 17 }, 4);
+        std::vector<std::byte> pixels(chain.bytes());
+        for (std::size_t i = 0; i < chain.level(0).bytes; i++) {
+            pixels[i] = static_cast<std::byte>(i % 4 == 3 ? 255 : 128);
+        }
+        aby::util::LoadPool pool(3);
+        chain.generate(pixels, aby::ETextureFormat::RGBA, &pool);
+        pool.sync();
+
+        auto& last = chain.level(chain.levels() - 1);
+        if (chain.levels() != 9 || last.size != glm::u32vec2(1, 1)) {
+            MipChainBenchmark::err("Chain of 300x17 has {} levels, last ({}, {})", chain.levels(), last.size.x, last.size.y);
+            return false;
+        }
+        for (auto& level : chain.all()) {
+            if (level.offset % 16 != 0) {
+                MipChainBenchmark::err("Level offset {} is not aligned", level.offset);
+                return false;
+            }
+            for (std::size_t i = 0; i < level.bytes; i++) {
+                int expected = i % 4 == 3 ? 255 : 128;
+                int actual   = static_cast<int>(pixels[level.offset + i]);
+                if (std::abs(actual - expected) > 1) {
+                    MipChainBenchmark::err("Level ({}, {}) byte {} is {}, expected {}", level.size.x, level.size.y, i, actual, expected);
+                    return false;
+                }
+            }
+        }
+    }
+
+    std::mt19937 rng(42);
+    std::vector<std::size_t> thread_counts = { 1, 2, 4 };
+    if (std::size_t cores = std::thread::hardware_concurrency(); cores > 4) {
+        thread_counts.push_back(cores);
+    }
+    for (aby::u32 dim : { 512u, 1024u, 2048u, 4096u }) {
+        aby::MipChain          chain({ dim, dim }, 4);
+        std::vector<std::byte> pixels(chain.bytes());
+        for (std::size_t i = 0; i < chain.level(0).bytes; i++) {
+            pixels[i] = static_cast<std::byte>(rng());
+        }
+
+        std::string line = std::format("  {}x{} ({} levels):", dim, dim, chain.levels());
+        for (auto threads : thread_counts) {
+            // The calling thread takes part, so a pool of threads - 1 loading threads.
+            aby::Unique<aby::util::LoadPool> pool = threads > 1 ? aby::create_unique<aby::util::LoadPool>(threads - 1) : nullptr;
+            auto t0 = Clock::now();
+            chain.generate(pixels, aby::ETextureFormat::RGBA, pool.get());
+            auto t1 = Clock::now();
+            if (pool) pool->sync();
+            line += std::format(" {}T {:.2f}ms", threads, ms(t0, t1));
+        }
+        std::cout << line << "\n";
+    }
+    return true;
+}
+
+TEST(SlotExchangeBenchmark) {
+    using aby::util::SlotExchange;
+    using Clock = std::chrono::steady_clock;
+
+    {
+        SlotExchange exchange(3);
+        aby::u32 a = exchange.acquire(), b = exchange.acquire(), c = exchange.acquire();
+        exchange.publish(a);
+        exchange.publish(b);
+        if (exchange.acquire() != a || exchange.take() != b || exchange.take() != SlotExchange::NONE || exchange.dropped() != 1) {
+            SlotExchangeBenchmark::err("Publishing over an untaken slot must drop it and free it");
+            return false;
+        }
+        exchange.release(b);
+        exchange.release(c);
+    }
+
+    // A producer streams 1080p RGBA frames as fast as it can into the slots of a BufferedTexture with
+    // two frames in flight, a 60Hz render thread copies the newest one (the ring upload) and holds it
+    // for two frames (the gpu copy).
+    constexpr std::size_t FRAME_BYTES = 1920 * 1080 * 4;
+    constexpr std::size_t IN_FLIGHT   = 2;
+    SlotExchange                           exchange(IN_FLIGHT + 2);
+    std::vector<std::vector<std::uint64_t>> slots(exchange.slots(), std::vector<std::uint64_t>(FRAME_BYTES / 8));
+    std::vector<std::uint64_t>              upload(FRAME_BYTES / 8);
+    std::atomic<bool>                       running = true;
+    std::atomic<aby::u64>                   starved = 0;
+
+    auto t0 = Clock::now();
+    std::thread producer([&]() {
+        std::uint64_t sequence = 1;
+        while (running.load(std::memory_order_relaxed)) {
+            aby::u32 slot = exchange.acquire();
+            if (slot == SlotExchange::NONE) {
+                starved.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            std::fill(slots[slot].begin(), slots[slot].end(), sequence++);
+            exchange.publish(slot);
+        }
+    });
+
+    std::vector<aby::u32> in_flight;
+    aby::u64              presented = 0, torn = 0;
+    std::uint64_t         last      = 0;
+    for (int frame = 0; frame < 30; frame++) {
+        auto begin = Clock::now();
+        if (in_flight.size() == IN_FLIGHT) {
+            exchange.release(in_flight.front());
+            in_flight.erase(in_flight.begin());
+        }
+        if (aby::u32 slot = exchange.take(); slot != SlotExchange::NONE) {
+            std::memcpy(upload.data(), slots[slot].data(), FRAME_BYTES);
+            if (upload.front() != upload.back() || upload.front() <= last) torn++;
+            last = upload.front();
+            in_flight.push_back(slot);
+            presented++;
+        }
+        std::this_thread::sleep_until(begin + std::chrono::microseconds(16667));
+    }
+    running = false;
+    producer.join();
+    double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+
+    double produced_mb  = static_cast<double>(exchange.published()) * FRAME_BYTES / (1024.0 * 1024.0);
+    double presented_mb = static_cast<double>(presented) * FRAME_BYTES / (1024.0 * 1024.0);
+    std::cout << std::format("  1080p RGBA: produced {} frames ({:.0f} MB/s), presented {} ({:.0f} MB/s), dropped {}, starved {}\n",
+        exchange.published(), produced_mb / seconds, presented, presented_mb / seconds, exchange.dropped(), starved.load());
+    if (torn > 0) {
+        SlotExchangeBenchmark::err("{} presented frames were torn or out of order", torn);
+        return false;
+    }
+    if (starved.load() > 0) {
+        SlotExchangeBenchmark::err("The producer found no free slot {} times", starved.load());
+        return false;
+    }
+    return true;
+}
+
+TEST(BlockCompression) {
+    using aby::util::EBlockFormat;
+    using Clock = std::chrono::steady_clock;
+
+    // Smooth gradients with a little noise and soft alpha, the size is not a multiple of the block size.
+    constexpr std::uint32_t w = 257, h = 131;
+    std::mt19937 rng(7);
+    std::vector<std::uint8_t> opaque(w * h * 4), blended(w * h * 4);
+    for (std::uint32_t y = 0; y < h; y++) {
+        for (std::uint32_t x = 0; x < w; x++) {
+            std::uint8_t* p = &opaque[(y * w + x) * 4];
+            p[0] = static_cast<std::uint8_t>(std::min<std::uint32_t>(x * 255 / w + rng() % 8, 255));
+            p[1] = static_cast<std::uint8_t>(y * 255 / h);
+            p[2] = static_cast<std::uint8_t>((x + y) * 255 / (w + h));
+            p[3] = 255;
+            std::memcpy(&blended[(y * w + x) * 4], p, 4);
+            blended[(y * w + x) * 4 + 3] = static_cast<std::uint8_t>(x * 255 / w);
+        }
+    }
+
+    auto rmse = [](const std::vector<std::uint8_t>& a, const std::vector<std::uint8_t>& b) {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < a.size(); i++) {
+            double d = static_cast<double>(a[i]) - b[i];
+            sum += d * d;
+        }
+        return std::sqrt(sum / a.size());
+    };
+
+    struct Case {
+        EBlockFormat                     format;
+        const char*                      name;
+        const std::vector<std::uint8_t>& image;
+        double                           max_rmse;
+    };
+    const Case cases[] = {
+        { EBlockFormat::BC1, "BC1", opaque,  4.0 },
+        { EBlockFormat::BC3, "BC3", blended, 4.0 },
+        { EBlockFormat::BC7, "BC7", blended, 3.0 },
+    };
+    for (const Case& c : cases) {
+        std::vector<std::uint8_t> blocks(aby::util::block_image_bytes(c.format, w, h));
+        std::vector<std::uint8_t> decoded(w * h * 4);
+        auto t0 = Clock::now();
+        aby::util::encode_image(c.format, c.image, w, h, blocks);
+        auto t1 = Clock::now();
+        if (!aby::util::decode_image(c.format, blocks, w, h, decoded)) {
+            BlockCompression::err("{} blocks failed to decode", c.name);
+            return false;
+        }
+        double error = rmse(c.image, decoded);
+        std::cout << std::format("  {}: {} -> {} bytes, rmse {:.2f}, {:.2f}ms\n", c.name, c.image.size(), blocks.size(), error, std::chrono::duration<double, std::milli>(t1 - t0).count());
+        if (error > c.max_rmse) {
+            BlockCompression::err("{} rmse {:.2f} exceeds {:.2f}", c.name, error, c.max_rmse);
+            return false;
+        }
+    }
+
+    // BC1 keeps fully transparent texels transparent.
+    std::uint8_t texels[16 * 4], block[8], decoded[16 * 4];
+    for (int i = 0; i < 16; i++) {
+        std::uint8_t texel[4] = { 200, 100, 50, static_cast<std::uint8_t>(i % 2 ? 255 : 0) };
+        std::memcpy(texels + i * 4, texel, 4);
+    }
+    aby::util::encode_block(EBlockFormat::BC1, texels, block);
+    aby::util::decode_block(EBlockFormat::BC1, block, decoded);
+    for (int i = 0; i < 16; i++) {
+        if (decoded[i * 4 + 3] != texels[i * 4 + 3]) {
+            BlockCompression::err("BC1 texel {} has alpha {}, expected {}", i, decoded[i * 4 + 3], texels[i * 4 + 3]);
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST(QuadInstanceBenchmark) {
+    using Clock = std::chrono::steady_clock;
+    auto ms = [](auto begin, auto end) {
+        return std::chrono::duration<double, std::milli>(end - begin).count();
+    };
+    constexpr std::size_t QUADS = 100'000;
+    constexpr glm::vec2   COORDS[4] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    std::vector<aby::Quad> quads;
+    quads.reserve(QUADS);
+    for (std::size_t i = 0; i < QUADS; i++) {
+        quads.emplace_back(glm::vec2(8.f + unit(rng) * 64.f, 8.f + unit(rng) * 64.f), glm::vec2(unit(rng) * 1920.f, unit(rng) * 1080.f),
+            glm::vec4(unit(rng), unit(rng), unit(rng), 1.f), static_cast<float>(i % 16), glm::vec2(0.25f, 0.125f));
+        quads.back().texinfo = { 0.25f, 0.5f, static_cast<float>(i % 16) };
+    }
+
+    // What RenderModule::draw_quad does per quad: a transform and four transformed corners.
+    std::vector<aby::Vertex> vertices;
+    vertices.reserve(QUADS * 4);
+    auto t0 = Clock::now();
+    for (const auto& quad : quads) {
+        glm::mat4 transform = glm::translate(glm::mat4(1), quad.pos) * glm::scale(glm::mat4(1), quad.size);
+        for (std::size_t i = 0; i < 4; i++) {
+            glm::vec3 pos(transform * glm::vec4(COORDS[i] - 0.5f, 0.f, 1.f));
+            glm::vec3 texinfo(glm::vec2(quad.texinfo) + COORDS[i] * quad.uvs, quad.texinfo.z);
+            vertices.emplace_back(pos, quad.col, texinfo);
+        }
+    }
+    auto t1 = Clock::now();
+    std::vector<aby::QuadInstance> instances;
+    instances.reserve(QUADS);
+    for (const auto& quad : quads) {
+        instances.emplace_back(quad);
+    }
+    auto t2 = Clock::now();
+
+    // Expand the instances as Quad.glsl does, they must land on the corners of the cpu path.
+    for (std::size_t q = 0; q < QUADS; q++) {
+        const auto& instance = instances[q];
+        glm::vec4   color    = glm::unpackUnorm4x8(instance.col);
+        for (std::size_t i = 0; i < 4; i++) {
+            const auto& vertex   = vertices[q * 4 + i];
+            glm::vec3   pos      = instance.pos + glm::vec3((COORDS[i] - 0.5f) * instance.size, 0.f);
+            glm::vec2   texcoord = glm::vec2(instance.uvs) + COORDS[i] * glm::vec2(instance.uvs.z, instance.uvs.w);
+            if (glm::any(glm::greaterThan(glm::abs(pos - vertex.pos), glm::vec3(1e-3f))) ||
+                glm::any(glm::greaterThan(glm::abs(texcoord - glm::vec2(vertex.texinfo)), glm::vec2(1e-6f))) ||
+                glm::any(glm::greaterThan(glm::abs(color - vertex.col), glm::vec4(0.5f / 255.f))) ||
+                static_cast<float>(instance.texture) != vertex.texinfo.z)
+            {
+                QuadInstanceBenchmark::err("Corner {} of quad {} does not match the cpu path", i, q);
+                return false;
+            }
+        }
+    }
+
+    double vertex_mb   = static_cast<double>(vertices.size() * sizeof(aby::Vertex)) / (1024.0 * 1024.0);
+    double instance_mb = static_cast<double>(instances.size() * sizeof(aby::QuadInstance)) / (1024.0 * 1024.0);
+    std::cout << std::format("  {} quads: vertices {:.2f}ms {:.2f} MB, instances {:.2f}ms {:.2f} MB ({:.1f}x less cpu, {:.1f}x fewer bytes)\n",
+        QUADS, ms(t0, t1), vertex_mb, ms(t1, t2), instance_mb, ms(t0, t1) / ms(t1, t2), vertex_mb / instance_mb);
+    if (vertex_mb / instance_mb < 4.0) {
+        QuadInstanceBenchmark::err("Instances are only {:.1f}x smaller than vertices", vertex_mb / instance_mb);
+        return false;
+    }
+    return true;
+}
+
+TEST(PackQuadsBenchmark) {
+    using Clock = std::chrono::steady_clock;
+    constexpr std::size_t QUADS  = 100'003; // Not a multiple of four, the tail takes the scalar path.
+    constexpr int         ROUNDS = 20;
+
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> unit(-0.25f, 1.25f);
+    std::vector<aby::Quad> quads;
+    quads.reserve(QUADS);
+    for (std::size_t i = 0; i < QUADS; i++) {
+        quads.emplace_back(glm::vec2(unit(rng) * 64.f, unit(rng) * 64.f), glm::vec2(unit(rng) * 1920.f, unit(rng) * 1080.f),
+            glm::vec4(unit(rng), unit(rng), unit(rng), unit(rng)), static_cast<float>(i % 16), glm::vec2(0.25f, 0.125f));
+    }
+
+    // One quad at a time as draw_quad does, against the batch kernel.
+    std::vector<aby::QuadInstance> scalar(QUADS, aby::QuadInstance(quads[0]));
+    std::vector<aby::QuadInstance> packed(QUADS, aby::QuadInstance(quads[0]));
+    auto t0 = Clock::now();
+    for (int round = 0; round < ROUNDS; round++) {
+        for (std::size_t i = 0; i < QUADS; i++) {
+            scalar[i] = aby::QuadInstance(quads[i]);
+        }
+    }
+    auto t1 = Clock::now();
+    for (int round = 0; round < ROUNDS; round++) {
+        aby::pack_quads(quads, packed.data());
+    }
+    auto t2 = Clock::now();
+
+    for (std::size_t i = 0; i < QUADS; i++) {
+        const auto& a = scalar[i];
+        const auto& b = packed[i];
+        bool same = a.pos == b.pos && a.size == b.size && a.texture == b.texture && a.uvs == b.uvs;
+        for (int c = 0; c < 4; c++) {
+            // Halves may round either way.
+            same &= std::abs(static_cast<int>((a.col >> (c * 8)) & 0xff) - static_cast<int>((b.col >> (c * 8)) & 0xff)) <= 1;
+        }
+        if (!same) {
+            PackQuadsBenchmark::err("Quad {} packs to a different instance than QuadInstance(quad)", i);
+            return false;
+        }
+    }
+
+    double scalar_ms = std::chrono::duration<double, std::milli>(t1 - t0).count() / ROUNDS;
+    double packed_ms = std::chrono::duration<double, std::milli>(t2 - t1).count() / ROUNDS;
+    std::cout << std::format("  {} quads: per quad {:.3f}ms ({:.0f} Mquads/s), pack_quads {:.3f}ms ({:.0f} Mquads/s), {:.1f}x\n",
+        QUADS, scalar_ms, QUADS / scalar_ms / 1000.0, packed_ms, QUADS / packed_ms / 1000.0, scalar_ms / packed_ms);
+    return true;
+}
+
+TEST(RenderQueue) {
+    // Streams 0..3 drawn with pipelines 0, 1, 2, 2 as in vk::Renderer.
+    aby::RenderQueue queue({ 0, 1, 2, 2 });
+    aby::DrawOrder   order;
+
+    // Quads, text and a panel over the text on one layer keep their submission order across
+    // streams, ranges that continue the previous packet of their batch merge.
+    queue.push(order, 1, 0, 0, 4);
+    queue.push(order, 1, 0, 4, 8);
+    queue.push(order, 3, 0, 0, 6);
+    queue.push(order, 1, 0, 12, 1);
+    queue.push(order, 2, 0, 0, 3);
+    queue.push({ .layer = 1 }, 1, 0, 13, 1);                                // Over everything of layer 0.
+    queue.push({ .blend = aby::EBlend::NONE, .depth = -1.f }, 0, 0, 0, 24); // Opaque, before the blended draws.
+    queue.push({ .blend = aby::EBlend::NONE, .depth = 2.f }, 0, 0, 24, 24);
+    queue.push({ .depth = 3.f }, 2, 0, 3, 3);                               // Further away, drawn first of the blended.
+
+    auto packets = queue.sort();
+    struct Expected { aby::u32 stream, first, count; };
+    const Expected expected[] = {
+        { 0, 24, 24 }, { 0, 0, 24 }, // Back to front, no depth buffer to sort opaque draws against.
+        { 2, 3, 3 },
+        { 1, 0, 12 },
+        { 3, 0, 6 },
+        { 1, 12, 1 },
+        { 2, 0, 3 },
+        { 1, 13, 1 },
+    };
+    if (packets.size() != std::size(expected)) {
+        RenderQueue::err("{} draws after sorting, expected {}", packets.size(), std::size(expected));
+        return false;
+    }
+    for (std::size_t i = 0; i < packets.size(); i++) {
+        if (packets[i].stream != expected[i].stream || packets[i].first != expected[i].first || packets[i].count != expected[i].count) {
+            RenderQueue::err("Draw {} is stream {} [{}, +{}), expected stream {} [{}, +{})", i,
+                packets[i].stream, packets[i].first, packets[i].count, expected[i].stream, expected[i].first, expected[i].count);
+            return false;
+        }
+    }
+    const auto& stats = queue.stats();
+    if (stats.packets != 9 || stats.draws != 8 || stats.unsorted_binds != 7 || stats.pipeline_binds != 7) {
+        RenderQueue::err("Stats {} packets, {} draws, {} binds ({} unsorted)", stats.packets, stats.draws, stats.pipeline_binds, stats.unsorted_binds);
+        return false;
+    }
+
+    // A frame of interleaved ui draws: panels and text of many windows, against std::stable_sort.
+    using Clock = std::chrono::steady_clock;
+    constexpr aby::u32 PACKETS = 100'000;
+    constexpr int      ROUNDS  = 20;
+    std::mt19937 rng(5);
+    std::vector<aby::u32> first(4, 0);
+    queue.clear();
+    for (aby::u32 i = 0; i < PACKETS; i++) {
+        aby::u32 stream = rng() % 4;
+        aby::DrawOrder window{ .layer = static_cast<aby::u8>(rng() % 8) };
+        queue.push(window, stream, 0, first[stream], 4);
+        first[stream] += 4;
+    }
+    std::vector<aby::DrawPacket> recorded(queue.packets().begin(), queue.packets().end());
+    std::vector<aby::DrawPacket> reference;
+    double radix_ms = 0, std_ms = 0;
+    for (int round = 0; round < ROUNDS; round++) {
+        queue.clear();
+        for (const auto& packet : recorded) {
+            queue.push({ .layer = static_cast<aby::u8>(packet.key >> 56) }, packet.stream, packet.batch, packet.first, packet.count);
+        }
+        auto t0 = Clock::now();
+        queue.sort();
+        auto t1 = Clock::now();
+        reference = recorded;
+        std::stable_sort(reference.begin(), reference.end(), [](const auto& a, const auto& b) { return a.key < b.key; });
+        auto t2 = Clock::now();
+        radix_ms += std::chrono::duration<double, std::milli>(t1 - t0).count() / ROUNDS;
+        std_ms   += std::chrono::duration<double, std::milli>(t2 - t1).count() / ROUNDS;
+    }
+    // Merging aside, the radix sort has to match the stable comparison sort.
+    std::size_t r = 0;
+    for (const auto& packet : queue.packets()) {
+        aby::u32 covered = 0;
+        while (covered < packet.count && r < reference.size() && reference[r].stream == packet.stream && reference[r].first == packet.first + covered) {
+            covered += reference[r++].count;
+        }
+        if (covered != packet.count) {
+            RenderQueue::err("Sorted draws differ from std::stable_sort at packet {}", r);
+            return false;
+        }
+    }
+    if (r != reference.size()) {
+        RenderQueue::err("Sorted draws cover {} of {} packets", r, reference.size());
+        return false;
+    }
+    const auto& frame = queue.stats();
+    std::cout << std::format("  {} packets: radix {:.3f}ms, std::stable_sort {:.3f}ms ({:.1f}x), {} draws ({} saved), {} pipeline binds ({} saved)\n",
+        PACKETS, radix_ms, std_ms, std_ms / radix_ms, frame.draws, frame.packets - frame.draws, frame.pipeline_binds, frame.unsorted_binds - frame.pipeline_binds);
+    return true;
+}
+
 int main() {
     if (!aby::TestFramework::get().run()) {
         return 1;